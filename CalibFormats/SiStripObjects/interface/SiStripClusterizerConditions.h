@@ -0,0 +1,50 @@
+#ifndef SiStripObjects_SiStripClusterizerConditions_h
+#define SiStripObjects_SiStripClusterizerConditions_h
+
+/** \class SiStripClusterizerConditions
+ *
+ *  Noise, bad-strip flag and gain of every strip, decoded from SiStripNoises,
+ *  SiStripQuality and SiStripGain once per IOV and shared by all the
+ *  clusterizers. For each module with noise and gain, the noise (in units of
+ *  0.1 ADC, as stored in SiStripNoises) and the bad-strip flag are packed in
+ *  one uint16_t per strip, and the gain is stored per APV.
+ */
+
+#include <cstdint>
+#include <vector>
+
+class SiStripNoises;
+class SiStripGain;
+class SiStripQuality;
+
+class SiStripClusterizerConditions {
+ public:
+  static constexpr uint16_t noiseMask = 0x01FF;
+  static constexpr uint16_t badStripBit = 0x8000;
+
+  /// conditions of one module, no strips if the module is not known
+  struct Module {
+    const uint16_t * strips = nullptr;
+    const float * apvGains = nullptr;
+    uint16_t nStrips = 0;
+  };
+
+  SiStripClusterizerConditions(const SiStripNoises& noises, const SiStripGain& gain, const SiStripQuality& quality);
+
+  SiStripClusterizerConditions(const SiStripClusterizerConditions&) = delete;
+  const SiStripClusterizerConditions& operator=(const SiStripClusterizerConditions&) = delete;
+
+  Module module(uint32_t detId) const;
+
+  unsigned int nModules() const { return detIds_.size(); }
+  unsigned int nStrips() const { return strips_.size(); }
+
+ private:
+  std::vector<uint32_t> detIds_;           // sorted
+  std::vector<unsigned int> stripOffsets_; // first strip of each module, and end
+  std::vector<unsigned int> apvOffsets_;   // first APV of each module
+  std::vector<uint16_t> strips_;
+  std::vector<float> apvGains_;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "CalibFormats/SiStripObjects/interface/SiStripClusterizerConditions.h"
+#include "CalibFormats/SiStripObjects/interface/SiStripGain.h"
+#include "CalibFormats/SiStripObjects/interface/SiStripQuality.h"
+#include "CondFormats/SiStripObjects/interface/SiStripNoises.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+SiStripClusterizerConditions::SiStripClusterizerConditions(const SiStripNoises& noises, const SiStripGain& gain, const SiStripQuality& quality)
+{
+  std::vector<uint32_t> detIds;
+  noises.getDetIds(detIds);
+  std::sort(detIds.begin(), detIds.end());
+
+  detIds_.reserve(detIds.size());
+  stripOffsets_.reserve(detIds.size()+1);
+  apvOffsets_.reserve(detIds.size());
+  for (auto detId : detIds) {
+    auto noiseRange = noises.getRange(detId);
+    auto gainRange = gain.getRange(detId);
+    // 9 bits of noise per strip, one gain per APV of 128 strips
+    unsigned int nStrips = std::min<unsigned int>(8*(noiseRange.second-noiseRange.first)/9,
+                                                  128*(gainRange.second-gainRange.first));
+    if (nStrips==0 || nStrips>=std::numeric_limits<uint16_t>::max()) continue;
+
+    detIds_.push_back(detId);
+    stripOffsets_.push_back(strips_.size());
+    apvOffsets_.push_back(apvGains_.size());
+    const unsigned int first = strips_.size();
+    for (auto strip=0U; strip<nStrips; ++strip)
+      strips_.push_back(std::lround(10.f*SiStripNoises::getNoise(strip, noiseRange)) & noiseMask);
+    for (auto apv=0U; apv<(nStrips+127)/128; ++apv)
+      apvGains_.push_back(SiStripGain::getApvGain(apv, gainRange));
+
+    auto qualityRange = quality.getRange(detId);
+    for (auto bad = qualityRange.first; bad!=qualityRange.second; ++bad) {
+      auto badStrips = quality.decode(*bad);
+      unsigned int last = std::min<unsigned int>(badStrips.firstStrip+badStrips.range, nStrips);
+      for (unsigned int strip=badStrips.firstStrip; strip<last; ++strip)
+        strips_[first+strip] |= badStripBit;
+    }
+  }
+  stripOffsets_.push_back(strips_.size());
+}
+
+SiStripClusterizerConditions::Module
+SiStripClusterizerConditions::module(uint32_t detId) const
+{
+  Module module;
+  auto p = std::lower_bound(detIds_.begin(), detIds_.end(), detId);
+  if (p==detIds_.end() || *p!=detId) return module;
+  auto i = p - detIds_.begin();
+  module.strips = strips_.data() + stripOffsets_[i];
+  module.apvGains = apvGains_.data() + apvOffsets_[i];
+  module.nStrips = stripOffsets_[i+1] - stripOffsets_[i];
+  return module;
+}
@@ -36,6 +36,12 @@ siStripQualityESProducer.PrintDebugOutput = cms.bool(False)
 # Default is "False".
 siStripQualityESProducer.UseEmptyRunInfo = cms.bool(False)
 
+# per-strip noise, gain and bad-strip flag for the clusterizers with FlattenConditions
+from CalibTracker.SiStripESProducers.siStripClusterizerConditionsESProducer_cfi import *
+
+# decoded gains of the HLT payload for the pixel clusterizers with UseCalibrationTable
+from CalibTracker.SiPixelESProducers.siPixelGainCalibrationForHLTTableESProducer_cfi import *
+
 from CalibTracker.SiPixelESProducers.SiPixelQualityESProducer_cfi import *
 siPixelQualityESProducer.ListOfRecordToMerge = cms.VPSet(
         cms.PSet( record = cms.string("SiPixelQualityFromDbRcd"),
@@ -39,5 +39,7 @@ class SiStripBadModuleFedErrRcd : public edm::eventsetup::DependentRecordImpleme
 
 class SiStripQualityRcd : public edm::eventsetup::DependentRecordImplementation<SiStripQualityRcd, boost::mpl::vector<SiStripBadModuleRcd, SiStripBadFiberRcd, SiStripBadChannelRcd, SiStripBadStripRcd, SiStripDetCablingRcd, SiStripDCSStatusRcd, SiStripDetVOffRcd, RunInfoRcd,  SiStripBadModuleFedErrRcd > > {};
 
+class SiStripClusterizerConditionsRcd : public edm::eventsetup::DependentRecordImplementation<SiStripClusterizerConditionsRcd, boost::mpl::vector<SiStripGainRcd, SiStripNoisesRcd, SiStripQualityRcd> > {};
+
 #endif 
 
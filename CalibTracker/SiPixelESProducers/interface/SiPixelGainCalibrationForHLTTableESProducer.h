@@ -0,0 +1,29 @@
+#ifndef CalibTracker_SiPixelESProducers_SiPixelGainCalibrationForHLTTableESProducer_h
+#define CalibTracker_SiPixelESProducers_SiPixelGainCalibrationForHLTTableESProducer_h
+
+/**\class SiPixelGainCalibrationForHLTTableESProducer
+ *  Decodes the SiPixelGainCalibrationForHLT payload into a SiPixelGainCalibrationForHLTTable,
+ *  once per IOV and for all the streams.
+ */
+
+#include "FWCore/Framework/interface/ESProducer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "CondFormats/DataRecord/interface/SiPixelGainCalibrationForHLTRcd.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelGainCalibrationForHLTTable.h"
+
+#include <memory>
+
+namespace edm {
+  class ConfigurationDescriptions;
+}
+
+class SiPixelGainCalibrationForHLTTableESProducer : public edm::ESProducer {
+public:
+  explicit SiPixelGainCalibrationForHLTTableESProducer(const edm::ParameterSet& iConfig);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  std::unique_ptr<SiPixelGainCalibrationForHLTTable> produce(const SiPixelGainCalibrationForHLTRcd& iRecord);
+};
+
+#endif
@@ -14,6 +14,7 @@
 #include "CalibTracker/SiPixelESProducers/interface/SiPixelFakeTemplateDBObjectESSource.h"
 #include "CalibTracker/SiPixelESProducers/interface/SiPixelQualityESProducer.h"
 #include "CalibTracker/SiPixelESProducers/interface/SiPixelFakeQualityESSource.h"
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationForHLTTableESProducer.h"
 
 
 DEFINE_FWK_EVENTSETUP_SOURCE(SiPixelFakeGainESSource);
@@ -24,4 +25,5 @@ DEFINE_FWK_EVENTSETUP_SOURCE(SiPixelFakeQualityESSource);
 DEFINE_FWK_EVENTSETUP_SOURCE(SiPixelFakeCPEGenericErrorParmESSource);
 DEFINE_FWK_EVENTSETUP_SOURCE(SiPixelFakeTemplateDBObjectESSource);
 DEFINE_FWK_EVENTSETUP_MODULE(SiPixelQualityESProducer);
+DEFINE_FWK_EVENTSETUP_MODULE(SiPixelGainCalibrationForHLTTableESProducer);
 DEFINE_FWK_MODULE(SiPixelDetInfoFileWriter);
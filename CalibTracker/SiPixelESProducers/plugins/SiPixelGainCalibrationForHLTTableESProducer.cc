@@ -0,0 +1,22 @@
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationForHLTTableESProducer.h"
+
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelGainCalibrationForHLT.h"
+
+SiPixelGainCalibrationForHLTTableESProducer::SiPixelGainCalibrationForHLTTableESProducer(const edm::ParameterSet& iConfig)
+{
+  setWhatProduced(this);
+}
+
+void SiPixelGainCalibrationForHLTTableESProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  descriptions.add("siPixelGainCalibrationForHLTTableESProducer", desc);
+}
+
+std::unique_ptr<SiPixelGainCalibrationForHLTTable> SiPixelGainCalibrationForHLTTableESProducer::produce(const SiPixelGainCalibrationForHLTRcd& iRecord) {
+  edm::ESHandle<SiPixelGainCalibrationForHLT> payload;
+  iRecord.get(payload);
+  return std::make_unique<SiPixelGainCalibrationForHLTTable>(*payload);
+}
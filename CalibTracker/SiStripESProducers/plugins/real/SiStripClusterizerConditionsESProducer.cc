@@ -0,0 +1,33 @@
+#include "CalibTracker/SiStripESProducers/plugins/real/SiStripClusterizerConditionsESProducer.h"
+
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "CalibFormats/SiStripObjects/interface/SiStripGain.h"
+#include "CalibFormats/SiStripObjects/interface/SiStripQuality.h"
+#include "CondFormats/SiStripObjects/interface/SiStripNoises.h"
+
+SiStripClusterizerConditionsESProducer::SiStripClusterizerConditionsESProducer(const edm::ParameterSet& iConfig):
+  qualityLabel_(iConfig.getParameter<std::string>("QualityLabel"))
+{
+  setWhatProduced(this, qualityLabel_);
+}
+
+void SiStripClusterizerConditionsESProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions)
+{
+  edm::ParameterSetDescription desc;
+  desc.add<std::string>("QualityLabel", "");
+  descriptions.add("siStripClusterizerConditionsESProducer", desc);
+}
+
+std::unique_ptr<SiStripClusterizerConditions> SiStripClusterizerConditionsESProducer::produce(const SiStripClusterizerConditionsRcd& iRecord)
+{
+  edm::ESHandle<SiStripGain> gain;
+  iRecord.getRecord<SiStripGainRcd>().get(gain);
+  edm::ESHandle<SiStripNoises> noises;
+  iRecord.getRecord<SiStripNoisesRcd>().get(noises);
+  edm::ESHandle<SiStripQuality> quality;
+  iRecord.getRecord<SiStripQualityRcd>().get(qualityLabel_, quality);
+
+  return std::make_unique<SiStripClusterizerConditions>(*noises, *gain, *quality);
+}
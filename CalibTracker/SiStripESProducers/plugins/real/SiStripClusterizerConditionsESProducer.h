@@ -0,0 +1,35 @@
+#ifndef CalibTracker_SiStripESProducers_SiStripClusterizerConditionsESProducer
+#define CalibTracker_SiStripESProducers_SiStripClusterizerConditionsESProducer
+
+/**\class SiStripClusterizerConditionsESProducer
+ *  Decodes the noise, gain and quality of every strip into a SiStripClusterizerConditions,
+ *  once per IOV and for all the clusterizers. The product has the label of the quality
+ *  it is made with.
+ */
+
+#include <memory>
+#include <string>
+
+#include "FWCore/Framework/interface/ESProducer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "CalibFormats/SiStripObjects/interface/SiStripClusterizerConditions.h"
+#include "CalibTracker/Records/interface/SiStripDependentRecords.h"
+
+namespace edm {
+  class ConfigurationDescriptions;
+}
+
+class SiStripClusterizerConditionsESProducer : public edm::ESProducer {
+ public:
+  SiStripClusterizerConditionsESProducer(const edm::ParameterSet&);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  std::unique_ptr<SiStripClusterizerConditions> produce(const SiStripClusterizerConditionsRcd&);
+
+ private:
+  std::string qualityLabel_;
+};
+
+#endif
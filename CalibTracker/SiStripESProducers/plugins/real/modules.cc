@@ -23,3 +23,6 @@ DEFINE_FWK_EVENTSETUP_MODULE(SiStripLorentzAngleDepESProducer);
 
 #include "CalibTracker/SiStripESProducers/plugins/real/SiStripBackPlaneCorrectionDepESProducer.h"
 DEFINE_FWK_EVENTSETUP_MODULE(SiStripBackPlaneCorrectionDepESProducer);
+
+#include "CalibTracker/SiStripESProducers/plugins/real/SiStripClusterizerConditionsESProducer.h"
+DEFINE_FWK_EVENTSETUP_MODULE(SiStripClusterizerConditionsESProducer);
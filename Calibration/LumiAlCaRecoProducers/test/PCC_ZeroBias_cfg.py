@@ -58,6 +58,7 @@ process.siPixelClustersForLumi = cms.EDProducer("SiPixelClusterProducer",
     VCaltoElectronOffset = cms.int32(-414),
     maxNumberOfClusters = cms.int32(-1),
     payloadType = cms.string('Offline'),
+    UseCalibrationTable = cms.bool(False),
     src = cms.InputTag("siPixelDigisForLumi")
 )
 
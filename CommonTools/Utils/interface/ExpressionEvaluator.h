@@ -9,6 +9,10 @@ namespace reco {
 class ExpressionEvaluator {
 public:
   ExpressionEvaluator(const char * pkg,  const char * iname, const std::string & iexpr);
+  // the compiled library is kept in cacheDir, named after the expression and the release,
+  // and reused by later jobs instead of being compiled again; a failed compilation is kept
+  // there too, and later jobs throw the same error without running the compiler
+  ExpressionEvaluator(const char * pkg,  const char * iname, const std::string & iexpr, const std::string & cacheDir);
   ~ExpressionEvaluator();
   
   template<typename EXPR, typename... CArgs>
@@ -19,8 +23,11 @@ public:
 
 private:
 
+  void compile(const char * pkg,  const char * iname, const std::string & iexpr, const std::string & dir, const std::string & fileName);
+
   std::string m_name;
   void * m_expr;
+  bool m_cached;
 };
 
 
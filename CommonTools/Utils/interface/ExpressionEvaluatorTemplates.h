@@ -9,6 +9,17 @@
 
 namespace reco {
 
+  // member access of the translated string expressions (StringExpressionTranslator):
+  // through pointers, edm::Ref and edm::Ptr as for the objects themselves
+  namespace exprEvalDetails {
+    template<typename T> auto deref(T const & t, int) -> decltype(*t) { return *t; }
+    template<typename T> T const & deref(T const & t, long) { return t; }
+  }
+  template<typename T>
+  auto exprDeref(T const & t) -> decltype(exprEvalDetails::deref(t, 0)) { return exprEvalDetails::deref(t, 0); }
+
+  inline double exprTestBit(double mask, double iBit) { return (int(mask) >> int(iBit)) & 1; }
+
   template<typename Ret, typename... Args>
   struct genericExpression {
     virtual Ret operator()(Args ...) const =0;
@@ -28,6 +39,15 @@ namespace reco {
     virtual ~ValueOnObject(){};
   };
 
+  // several expressions evaluated on whole collections: out[k] = expression i on object k
+  template<typename Object>
+  struct ValuesOnCollection {
+    using Collection = std::vector<Object const *>;
+    virtual unsigned int size() const = 0;
+    virtual void eval(unsigned int i, Collection const&, double * out) const = 0;
+    virtual ~ValuesOnCollection(){};
+  };
+
   template<typename Object>
   struct MaskCollection {
     using Collection = std::vector<Object const *>;
@@ -0,0 +1,66 @@
+#ifndef CommonTools_Utils_StringExpressionTranslator_h
+#define CommonTools_Utils_StringExpressionTranslator_h
+/* \class reco::StringExpressionTranslator
+ *
+ * Translates the expressions of StringObjectFunction and the cuts of
+ * StringCutObjectSelector into C++ source, to be compiled with
+ * reco::ExpressionEvaluator.
+ *
+ * The syntax follows CommonTools/Utils/src/Grammar.h.  All arithmetic is done
+ * in double as in the parser.  Methods are looked up on the object first and
+ * then on what it points to (pointers, edm::Ref, edm::Ptr), as the parser does.
+ * Only the static type of the object is known to the compiler, so an expression
+ * relying on the run time lookup of lazy parsing, or on the conversion of
+ * strings to enum method arguments, translates but does not compile.
+ */
+#include <map>
+#include <string>
+
+namespace reco {
+
+  class StringExpressionTranslator {
+  public:
+    /// object is the C++ name of the object the methods are called on
+    explicit StringExpressionTranslator(const std::string & object);
+
+    /// C++ expression of type double; throws cms::Exception if the syntax is not supported
+    std::string expression(const std::string & expr);
+    /// C++ expression of type bool; throws cms::Exception if the syntax is not supported
+    std::string cut(const std::string & cut);
+
+    /// helper declarations used by the translated expressions, to be put in the same scope
+    const std::string & helpers() const { return helpers_; }
+
+  private:
+    struct SyntaxError {};
+
+    std::string logicalExpression();
+    std::string logicalTerm();
+    std::string logicalFactor();
+    std::string comparisonOp();
+    std::string expression();
+    std::string term();
+    std::string power();
+    std::string factor();
+    std::string method(const std::string & first);
+    std::string var(const std::string & name, const std::string & receiver);
+    std::string methodArguments(char close);
+    std::string methodArgument();
+    std::string identifier();
+    std::string number();
+    bool accept(const char * token);
+    void expect(const char * token);
+    void skipSpaces();
+    std::string methodHelper(const std::string & name, const std::string & args);
+
+    std::string translate(const std::string & input, bool isCut);
+
+    std::string object_;
+    std::string helpers_;
+    std::map<std::string, std::string> methods_;
+    const char * pos_;
+  };
+
+}
+
+#endif
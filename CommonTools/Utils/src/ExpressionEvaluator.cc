@@ -2,11 +2,14 @@
 #include "FWCore/Version/interface/GetReleaseVersion.h"
 #include "FWCore/Utilities/interface/GetEnvironmentVariable.h"
 #include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/Digest.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 #include "popenCPP.h"
 
+#include <cstdio>
 #include <fstream>
+#include <iterator>
 #include <regex>
 #include <dlfcn.h>
 
@@ -29,9 +32,9 @@ namespace {
     return n1;
   }
 
- void remove(std::string const & name) {
-  std::string sfile = "/tmp/"+name+".cc";
-  std::string ofile = "/tmp/"+name+".so";
+ void remove(std::string const & name, std::string const & dir = "/tmp/") {
+  std::string sfile = dir+name+".cc";
+  std::string ofile = dir+name+".so";
 
   std::string rm="rm -f "; rm+=sfile+' '+ofile;
 
@@ -52,16 +55,65 @@ namespace {
 namespace reco{
 
 ExpressionEvaluator::ExpressionEvaluator(const char * pkg, const char * iname, std::string const & iexpr) :
-  m_name("VI_"+generateName())
+  m_name("VI_"+generateName()), m_expr(nullptr), m_cached(false)
 {
+  compile(pkg, iname, iexpr, "/tmp/", m_name);
+}
+
+ExpressionEvaluator::ExpressionEvaluator(const char * pkg, const char * iname, std::string const & iexpr, std::string const & cacheDir) :
+  m_expr(nullptr), m_cached(true)
+{
+  cms::Digest digest(edm::getReleaseVersion());
+  for (auto const & s : {std::string(pkg), std::string(iname), iexpr}) { digest.append(s); digest.append("\n"); }
+  m_name = "VI_"+digest.digest().toString();
+  std::string dir = cacheDir.empty() ? std::string("./") : cacheDir.back() == '/' ? cacheDir : cacheDir+'/';
+  std::string ofile = dir+m_name+".so";
+
+  // compiled by an earlier job, or by another module of this one
+  void * dl = dlopen(ofile.c_str(),RTLD_LAZY);
+  if (dl) {
+    COUT << "reusing " << ofile << std::endl;
+    m_expr = dlsym(dl,("factory"+m_name).c_str());
+    return;
+  }
+
+  // failed in an earlier job
+  std::string failfile = dir+m_name+".failed";
+  {
+    std::ifstream failed(failfile.c_str());
+    if (failed) {
+      std::string error((std::istreambuf_iterator<char>(failed)), std::istreambuf_iterator<char>());
+      throw cms::Exception("ExpressionEvaluator", "compilation failed in an earlier job, see " + failfile + "\n" + error);
+    }
+  }
+
+  // compile under a unique name, then move into place so that concurrent jobs never see a partial library
+  std::string tmpName = m_name+"_"+generateName();
+  try {
+    compile(pkg, iname, iexpr, dir, tmpName);
+  } catch (cms::Exception const & e) {
+    std::string tmpfile = dir+tmpName+".failed";
+    {
+      std::ofstream failed(tmpfile.c_str());
+      failed << e.what();
+    }
+    std::rename(tmpfile.c_str(), failfile.c_str());
+    remove(tmpName, dir);
+    throw;
+  }
+  std::string tmpfile = dir+tmpName+".so";
+  std::rename(tmpfile.c_str(), ofile.c_str());
+  remove(tmpName, dir);
+}
 
+void ExpressionEvaluator::compile(const char * pkg, const char * iname, std::string const & iexpr, std::string const & dir, std::string const & fileName) {
 
   std::string pch = pkg; pch += "/src/precompile.h";
   std::string quote("\"");
 
   
-  std::string sfile = "/tmp/"+m_name+".cc";
-  std::string ofile = "/tmp/"+m_name+".so";
+  std::string sfile = dir+fileName+".cc";
+  std::string ofile = dir+fileName+".so";
 
   auto arch = edm::getEnvironmentVariable("SCRAM_ARCH");
   auto baseDir = edm::getEnvironmentVariable("CMSSW_BASE");
@@ -142,18 +194,18 @@ ExpressionEvaluator::ExpressionEvaluator(const char * pkg, const char * iname, s
 
   void * dl = dlopen(ofile.c_str(),RTLD_LAZY);
   if (!dl) {
-     remove(m_name);
+     remove(fileName, dir);
      throw  cms::Exception("ExpressionEvaluator", std::string("compilation/linking failed\n") +  cpp + ss + "dlerror " + dlerror());
     return;
   }
 
   m_expr = dlsym(dl,factory.c_str());
-  remove(m_name);
+  if (!m_cached) remove(fileName, dir);
 }
 
 
 ExpressionEvaluator::~ExpressionEvaluator(){
-  remove(m_name);
+  if (!m_cached) remove(m_name);
 }
 
 
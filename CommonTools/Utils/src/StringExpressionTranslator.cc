@@ -0,0 +1,266 @@
+#include "CommonTools/Utils/interface/StringExpressionTranslator.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cctype>
+#include <cstring>
+
+using namespace reco;
+
+namespace {
+  // functions of the grammar and their C++ counterparts, as in ExpressionFunctionSetter.cc;
+  // atan2 is left out as the parser maps it to the one argument atan
+  struct FunctionName { const char * name; unsigned int nArgs; const char * cpp; };
+  const FunctionName functions[] = {
+    {"abs", 1, "std::fabs"}, {"acos", 1, "std::acos"}, {"asin", 1, "std::asin"},
+    {"atan", 1, "std::atan"}, {"cosh", 1, "std::cosh"}, {"cos", 1, "std::cos"},
+    {"exp", 1, "std::exp"}, {"log", 1, "std::log"}, {"log10", 1, "std::log10"},
+    {"sinh", 1, "std::sinh"}, {"sin", 1, "std::sin"}, {"sqrt", 1, "std::sqrt"},
+    {"tanh", 1, "std::tanh"}, {"tan", 1, "std::tan"},
+    {"chi2prob", 2, "ROOT::Math::chisquared_cdf_c"}, {"pow", 2, "std::pow"},
+    {"min", 2, "std::min<double>"}, {"max", 2, "std::max<double>"},
+    {"deltaPhi", 2, "reco::deltaPhi"}, {"hypot", 2, "std::hypot"},
+    {"test_bit", 2, "reco::exprTestBit"},
+    {"deltaR", 4, "reco::deltaR"}
+  };
+}
+
+StringExpressionTranslator::StringExpressionTranslator(const std::string & object) :
+  object_(object), pos_(nullptr) {
+}
+
+std::string StringExpressionTranslator::expression(const std::string & expr) {
+  return translate(expr, false);
+}
+
+std::string StringExpressionTranslator::cut(const std::string & cut) {
+  return translate(cut, true);
+}
+
+std::string StringExpressionTranslator::translate(const std::string & input, bool isCut) {
+  pos_ = input.c_str();
+  skipSpaces();
+  // an empty cut selects everything, as in cutParser
+  if (isCut && *pos_ == '\0') return "true";
+  std::string result;
+  try {
+    result = isCut ? logicalExpression() : expression();
+    skipSpaces();
+    if (*pos_ != '\0') throw SyntaxError();
+  } catch (SyntaxError const &) {
+    throw cms::Exception("StringExpressionTranslator")
+      << "cannot translate \"" << input << "\" at position " << (pos_ - input.c_str()) << "\n";
+  }
+  return result;
+}
+
+void StringExpressionTranslator::skipSpaces() {
+  while (std::isspace(*pos_)) ++pos_;
+}
+
+bool StringExpressionTranslator::accept(const char * token) {
+  skipSpaces();
+  auto n = std::strlen(token);
+  if (std::strncmp(pos_, token, n) != 0) return false;
+  pos_ += n;
+  return true;
+}
+
+void StringExpressionTranslator::expect(const char * token) {
+  if (!accept(token)) throw SyntaxError();
+}
+
+std::string StringExpressionTranslator::logicalExpression() {
+  std::string result = logicalTerm();
+  while (accept("||") || accept("|")) result = "(" + result + " || " + logicalTerm() + ")";
+  return result;
+}
+
+std::string StringExpressionTranslator::logicalTerm() {
+  std::string result = logicalFactor();
+  while (accept("&&") || accept("&")) result = "(" + result + " && " + logicalFactor() + ")";
+  return result;
+}
+
+std::string StringExpressionTranslator::logicalFactor() {
+  const char * start = pos_;
+  // comparisons of two or three expressions, or an expression used as a selector
+  try {
+    std::string lhs = expression();
+    std::string op = comparisonOp();
+    if (op.empty()) return "(" + lhs + " != 0.)";
+    std::string mid = expression();
+    std::string op2 = comparisonOp();
+    if (op2.empty()) return "(" + lhs + " " + op + " " + mid + ")";
+    return "(" + lhs + " " + op + " " + mid + " && " + mid + " " + op2 + " " + expression() + ")";
+  } catch (SyntaxError const &) {
+    pos_ = start;
+  }
+  if (accept("(")) {
+    std::string result = logicalExpression();
+    expect(")");
+    return "(" + result + ")";
+  }
+  if (accept("!")) return "(!" + logicalFactor() + ")";
+  throw SyntaxError();
+}
+
+std::string StringExpressionTranslator::comparisonOp() {
+  if (accept("<=")) return "<=";
+  if (accept("<")) return "<";
+  if (accept("==") || accept("=")) return "==";
+  if (accept(">=")) return ">=";
+  if (accept(">")) return ">";
+  if (accept("!=")) return "!=";
+  return std::string();
+}
+
+std::string StringExpressionTranslator::expression() {
+  if (accept("?")) {
+    std::string condition = logicalExpression();
+    expect("?");
+    std::string ifTrue = expression();
+    expect(":");
+    return "(" + condition + " ? " + ifTrue + " : " + expression() + ")";
+  }
+  std::string result = term();
+  while (true) {
+    if (accept("+")) result = "(" + result + " + " + term() + ")";
+    else if (accept("-")) result = "(" + result + " - " + term() + ")";
+    else return result;
+  }
+}
+
+std::string StringExpressionTranslator::term() {
+  std::string result = power();
+  while (true) {
+    if (accept("*")) result = "(" + result + " * " + power() + ")";
+    else if (accept("/")) result = "(" + result + " / " + power() + ")";
+    else return result;
+  }
+}
+
+std::string StringExpressionTranslator::power() {
+  std::string result = factor();
+  while (accept("^")) result = "std::pow(" + result + ", " + factor() + ")";
+  return result;
+}
+
+std::string StringExpressionTranslator::factor() {
+  skipSpaces();
+  if (std::isdigit(*pos_) || (*pos_ == '.' && std::isdigit(pos_[1]))) {
+    std::string literal = number();
+    if (literal.find_first_of(".eE") == std::string::npos) literal += ".";
+    return literal;
+  }
+  if (std::isalpha(*pos_)) {
+    const char * start = pos_;
+    std::string name = identifier();
+    if (accept("(")) {
+      for (auto const & f : functions) {
+        if (name != f.name) continue;
+        std::string result = std::string(f.cpp) + "(";
+        for (unsigned int i = 0; i < f.nArgs; ++i) {
+          if (i > 0) { expect(","); result += ", "; }
+          result += expression();
+        }
+        expect(")");
+        return result + ")";
+      }
+      if (name == "atan2") throw SyntaxError();
+    }
+    pos_ = start;
+    return method(identifier());
+  }
+  if (accept("(")) {
+    std::string result = expression();
+    expect(")");
+    return "(" + result + ")";
+  }
+  if (accept("-")) return "(-" + factor() + ")";
+  if (accept("+")) return factor();
+  throw SyntaxError();
+}
+
+std::string StringExpressionTranslator::method(const std::string & first) {
+  std::string result = var(first, object_);
+  while (true) {
+    if (accept("[")) {
+      std::string args = methodArguments(']');
+      result = "reco::exprDeref(" + result + ")[" + args + "]";
+    } else if (accept(".")) {
+      skipSpaces();
+      if (!std::isalpha(*pos_)) throw SyntaxError();
+      result = var(identifier(), result);
+    } else {
+      return "double(" + result + ")";
+    }
+  }
+}
+
+std::string StringExpressionTranslator::var(const std::string & name, const std::string & receiver) {
+  std::string args;
+  if (accept("(") && !accept(")")) args = methodArguments(')');
+  return methodHelper(name, args) + "::call(" + receiver + ", 0)";
+}
+
+std::string StringExpressionTranslator::methodArguments(char close) {
+  std::string args = methodArgument();
+  while (accept(",")) args += ", " + methodArgument();
+  const char end[] = {close, '\0'};
+  expect(end);
+  return args;
+}
+
+std::string StringExpressionTranslator::methodArgument() {
+  skipSpaces();
+  if (*pos_ == '"' || *pos_ == '\'') {
+    // string arguments, always passed with double quotes
+    char quote = *pos_++;
+    std::string result = "\"";
+    for (; *pos_ != quote; ++pos_) {
+      if (*pos_ == '\0') throw SyntaxError();
+      if (*pos_ == '"' || *pos_ == '\\') result += '\\';
+      result += *pos_;
+    }
+    ++pos_;
+    return result + "\"";
+  }
+  std::string sign;
+  if (*pos_ == '-' || *pos_ == '+') sign = *pos_++;
+  if (!std::isdigit(*pos_) && !(*pos_ == '.' && std::isdigit(pos_[1]))) throw SyntaxError();
+  return sign + number();
+}
+
+std::string StringExpressionTranslator::identifier() {
+  const char * start = pos_;
+  while (std::isalnum(*pos_) || *pos_ == '_') ++pos_;
+  return std::string(start, pos_);
+}
+
+std::string StringExpressionTranslator::number() {
+  const char * start = pos_;
+  while (std::isdigit(*pos_)) ++pos_;
+  if (*pos_ == '.') {
+    ++pos_;
+    while (std::isdigit(*pos_)) ++pos_;
+  }
+  if ((*pos_ == 'e' || *pos_ == 'E') &&
+      (std::isdigit(pos_[1]) || ((pos_[1] == '-' || pos_[1] == '+') && std::isdigit(pos_[2])))) {
+    pos_ += 2;
+    while (std::isdigit(*pos_)) ++pos_;
+  }
+  return std::string(start, pos_);
+}
+
+std::string StringExpressionTranslator::methodHelper(const std::string & name, const std::string & args) {
+  auto & helper = methods_[name + "(" + args + ")"];
+  if (helper.empty()) {
+    helper = "method_" + std::to_string(methods_.size() - 1);
+    std::string call = name + "(" + args + ")";
+    helpers_ += "struct " + helper + " {\n"
+      "  template<typename X> static auto call(X const & x, int) -> decltype(x." + call + ") { return x." + call + "; }\n"
+      "  template<typename X> static auto call(X const & x, long) -> decltype(reco::exprDeref(x)." + call + ") { return reco::exprDeref(x)." + call + "; }\n"
+      "};\n";
+  }
+  return helper;
+}
@@ -0,0 +1,96 @@
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "CommonTools/Utils/interface/StringExpressionTranslator.h"
+#include "CommonTools/Utils/interface/ExpressionEvaluator.h"
+#include "CommonTools/Utils/interface/ExpressionEvaluatorTemplates.h"
+#include "CommonTools/Utils/interface/StringObjectFunction.h"
+#include "CommonTools/Utils/interface/StringCutObjectSelector.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/Candidate/interface/CompositeCandidate.h"
+#include "DataFormats/Candidate/interface/LeafCandidate.h"
+
+#include <algorithm>
+
+class testStringExpressionTranslator : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testStringExpressionTranslator);
+  CPPUNIT_TEST(checkSyntax);
+  CPPUNIT_TEST(checkValues);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void checkSyntax();
+  void checkValues();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( testStringExpressionTranslator );
+
+void testStringExpressionTranslator::checkSyntax() {
+  reco::StringExpressionTranslator translator("obj");
+  CPPUNIT_ASSERT(translator.expression("3") == "3.");
+  CPPUNIT_ASSERT(translator.expression("2^-1.5") == "std::pow(2., (-1.5))");
+  CPPUNIT_ASSERT(translator.cut("") == "true");
+  CPPUNIT_ASSERT(translator.cut(" 1 = 2 | 1 < 2 <= 3") == "((1. == 2.) || (1. < 2. && 2. <= 3.))");
+  CPPUNIT_ASSERT(translator.helpers().empty());
+  translator.expression("pt");
+  translator.expression("daughter(0).pt");
+  // one helper per method and arguments
+  CPPUNIT_ASSERT(std::count(translator.helpers().begin(), translator.helpers().end(), '\n') == 2*4);
+
+  for (auto const & bad : {"pt +", "(pt", "atan2(pt, eta)", "daughter('0'", "pt > 1"}) {
+    CPPUNIT_ASSERT_THROW(translator.expression(bad), cms::Exception);
+  }
+  CPPUNIT_ASSERT_THROW(translator.cut("pt > 1 &&"), cms::Exception);
+}
+
+void testStringExpressionTranslator::checkValues() {
+  reco::CompositeCandidate cand;
+  cand.addDaughter(reco::LeafCandidate(+1, reco::Candidate::LorentzVector(1, 2, 3, 4)));
+  cand.addDaughter(reco::LeafCandidate(-1, reco::Candidate::LorentzVector(1.1, -2.5, 4.3, 13.7)));
+  reco::CompositeCandidate other(cand);
+  other.setCharge(2);
+
+  const std::vector<std::pair<std::string,bool>> expressions = {
+    {"numberOfDaughters", false},
+    {"daughter(1).pt + 2*charge/4", false},
+    {"abs(daughter(0).eta) - sqrt(pt)^2", false},
+    {"deltaR(daughter(0).eta, daughter(0).phi, daughter(1).eta, daughter(1).phi)", false},
+    {"deltaPhi(daughter(1).phi, daughter(0).phi)", false},
+    {"? charge > 1 ? min(pt, 1.5) : max(pt, 1e1)", false},
+    {"test_bit(numberOfDaughters, 1)", false},
+    {"daughter(0).charge > 0 & 1 < numberOfDaughters <= 2", true},
+    {"!(charge = 2) | daughter(1).isMuon", true},
+    {"charge", true}
+  };
+
+  reco::StringExpressionTranslator translator("obj");
+  std::string sexpr = "unsigned int size() const override { return " + std::to_string(expressions.size()) + "; }\n";
+  sexpr += "void eval(unsigned int i, Collection const & c, double * out) const override {\n  switch (i) {\n";
+  for (unsigned int i = 0; i < expressions.size(); ++i) {
+    auto const & expr = expressions[i];
+    std::string code = expr.second ? "(" + translator.cut(expr.first) + ") ? 1. : 0." : translator.expression(expr.first);
+    sexpr += "  case " + std::to_string(i) + ": for (auto p : c) { auto const & obj = static_cast<reco::CompositeCandidate const &>(*p); *out++ = " + code + "; } break;\n";
+  }
+  sexpr = translator.helpers() + sexpr + "  }\n}\n";
+
+  try {
+    reco::ExpressionEvaluator eval("CommonTools/CandUtils", "reco::ValuesOnCollection<reco::Candidate>", sexpr);
+    auto const * compiled = eval.expr<reco::ValuesOnCollection<reco::Candidate>>();
+    CPPUNIT_ASSERT(compiled);
+
+    reco::ValuesOnCollection<reco::Candidate>::Collection objs = {&cand, &other};
+    for (unsigned int i = 0; i < expressions.size(); ++i) {
+      auto const & expr = expressions[i];
+      double values[2];
+      compiled->eval(i, objs, values);
+      for (unsigned int k = 0; k < objs.size(); ++k) {
+        double expected = expr.second ? StringCutObjectSelector<reco::Candidate>(expr.first, true)(*objs[k])
+                                      : StringObjectFunction<reco::Candidate>(expr.first, true)(*objs[k]);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(expr.first, expected, values[k]);
+      }
+    }
+  } catch(cms::Exception const & e) {
+    // if compilation fails, the compiler output is part of the exception message
+    CPPUNIT_FAIL(e.what());
+  }
+}
@@ -43,6 +43,7 @@
        double GetClassifier(const float* vector) const { return GetGradBoostClassifier(vector); }
        
        void SetInitialResponse(double response) { fInitialResponse = response; }
+       double InitialResponse() const { return fInitialResponse; }
        
        std::vector<GBRTree> &Trees() { return fTrees; }
        const std::vector<GBRTree> &Trees() const { return fTrees; }
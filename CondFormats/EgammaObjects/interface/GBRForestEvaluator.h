@@ -0,0 +1,67 @@
+
+#ifndef EGAMMAOBJECTS_GBRForestEvaluator
+#define EGAMMAOBJECTS_GBRForestEvaluator
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// GBRForestEvaluator                                                   //
+//                                                                      //
+// Transient, evaluation-only copy of a GBRForest scoring many          //
+// candidates per call.                                                 //
+//                                                                      //
+// Every tree up to a maximum depth is stored as a complete binary      //
+// tree of that depth (shallower branches padded with copies of their   //
+// leaf), all trees back to back in flat arrays.  A candidate then      //
+// goes down a tree in exactly depth steps of                           //
+//   node = 2*node + 1 + (x[var[node]] > cut[node])                     //
+// without data-dependent branches, and the candidates of a block       //
+// go down the same tree together.  Deeper trees are evaluated with     //
+// GBRTree::GetResponse.  Trees are summed in the original order, so    //
+// the responses are identical to those of GBRForest.                   //
+//                                                                      //
+// WriteCode() writes the forest as a self-contained C++ function, for  //
+// forests frozen enough to be compiled in.                             //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+  class GBRForestEvaluator {
+
+    public:
+
+       explicit GBRForestEvaluator(const GBRForest &forest, unsigned int maxDepth=10);
+
+       // responses of n candidates, the inputs of candidate i starting at inputs+i*stride
+       void GetResponse(const float* inputs, unsigned int stride, unsigned int n, double* responses) const;
+       void GetGradBoostClassifier(const float* inputs, unsigned int stride, unsigned int n, double* responses) const;
+
+       unsigned int NTrees() const { return fTrees.size(); }
+       unsigned int NPaddedTrees() const { return fNPadded; }
+
+       // write "double name(const float* vector)" returning forest.GetResponse(vector)
+       static void WriteCode(const GBRForest &forest, const std::string &name, std::ostream &out);
+
+    private:
+      struct Tree {
+        unsigned int depth;        // 0 if not padded
+        unsigned int offset;       // first node in fVars/fCuts
+        unsigned int leafOffset;   // first leaf in fLeaves
+        const GBRTree *tree;
+      };
+
+      void Pad(const GBRTree &tree, int index, bool terminal, unsigned int pos, unsigned int level, const Tree &t);
+
+      double                     fInitialResponse;
+      std::vector<Tree>          fTrees;
+      std::vector<unsigned char> fVars;
+      std::vector<float>         fCuts;
+      std::vector<float>         fLeaves;
+      unsigned int               fNPadded;
+  };
+
+#endif
@@ -0,0 +1,129 @@
+#include "CondFormats/EgammaObjects/interface/GBRForestEvaluator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ios>
+
+namespace {
+
+  // number of intermediate nodes on the longest path from node index down
+  unsigned int treeDepth(const GBRTree &tree, int index) {
+    unsigned int l = 0, r = 0;
+    int left = tree.LeftIndices()[index];
+    int right = tree.RightIndices()[index];
+    if (left>0) l = treeDepth(tree,left);
+    if (right>0) r = treeDepth(tree,right);
+    return 1 + std::max(l,r);
+  }
+
+  void writeNode(const GBRTree &tree, int index, bool terminal, std::ostream &out) {
+    if (terminal) {
+      out << tree.Responses()[index] << "f";
+      return;
+    }
+    int left = tree.LeftIndices()[index];
+    int right = tree.RightIndices()[index];
+    out << "(vector[" << int(tree.CutIndices()[index]) << "] > " << tree.CutVals()[index] << "f ? ";
+    writeNode(tree, right>0 ? right : -right, right<=0, out);
+    out << " : ";
+    writeNode(tree, left>0 ? left : -left, left<=0, out);
+    out << ")";
+  }
+
+}
+
+//_______________________________________________________________________
+GBRForestEvaluator::GBRForestEvaluator(const GBRForest &forest, unsigned int maxDepth) :
+  fInitialResponse(forest.InitialResponse()),
+  fNPadded(0)
+{
+  fTrees.reserve(forest.Trees().size());
+  for (auto const &tree : forest.Trees()) {
+    Tree t{0, 0, 0, &tree};
+    unsigned int depth = treeDepth(tree,0);
+    if (depth<=maxDepth) {
+      t.depth = depth;
+      t.offset = fVars.size();
+      t.leafOffset = fLeaves.size();
+      fVars.resize(fVars.size() + (1u<<depth) - 1);
+      fCuts.resize(fCuts.size() + (1u<<depth) - 1);
+      fLeaves.resize(fLeaves.size() + (1u<<depth));
+      Pad(tree, 0, false, 0, 0, t);
+      ++fNPadded;
+    }
+    fTrees.push_back(t);
+  }
+}
+
+//_______________________________________________________________________
+void GBRForestEvaluator::Pad(const GBRTree &tree, int index, bool terminal, unsigned int pos, unsigned int level, const Tree &t) {
+  if (level==t.depth) {
+    // only leaves at the bottom level
+    fLeaves[t.leafOffset + pos - ((1u<<t.depth)-1)] = tree.Responses()[index];
+    return;
+  }
+  if (terminal) {
+    // leaf above the bottom level: both ways lead to a copy of it
+    fVars[t.offset+pos] = 0;
+    fCuts[t.offset+pos] = 0.f;
+    Pad(tree, index, true, 2*pos+1, level+1, t);
+    Pad(tree, index, true, 2*pos+2, level+1, t);
+    return;
+  }
+  fVars[t.offset+pos] = tree.CutIndices()[index];
+  fCuts[t.offset+pos] = tree.CutVals()[index];
+  int left = tree.LeftIndices()[index];
+  int right = tree.RightIndices()[index];
+  Pad(tree, left>0 ? left : -left, left<=0, 2*pos+1, level+1, t);
+  Pad(tree, right>0 ? right : -right, right<=0, 2*pos+2, level+1, t);
+}
+
+//_______________________________________________________________________
+void GBRForestEvaluator::GetResponse(const float* inputs, unsigned int stride, unsigned int n, double* responses) const {
+  constexpr unsigned int kBlock = 16;
+  unsigned int node[kBlock];
+  for (unsigned int first=0; first<n; first+=kBlock) {
+    unsigned int nb = std::min(kBlock, n-first);
+    const float *x = inputs + first*stride;
+    double *response = responses + first;
+    for (unsigned int i=0; i<nb; ++i) response[i] = fInitialResponse;
+    for (auto const &t : fTrees) {
+      if (t.depth==0) {
+        for (unsigned int i=0; i<nb; ++i) response[i] += t.tree->GetResponse(x+i*stride);
+        continue;
+      }
+      const unsigned char *vars = &fVars[t.offset];
+      const float *cuts = &fCuts[t.offset];
+      for (unsigned int i=0; i<nb; ++i) node[i] = 0;
+      for (unsigned int level=0; level<t.depth; ++level)
+        for (unsigned int i=0; i<nb; ++i) {
+          auto k = node[i];
+          node[i] = 2*k + 1 + (x[i*stride+vars[k]] > cuts[k]);
+        }
+      const float *leaves = &fLeaves[t.leafOffset] - ((1u<<t.depth)-1);
+      for (unsigned int i=0; i<nb; ++i) response[i] += leaves[node[i]];
+    }
+  }
+}
+
+//_______________________________________________________________________
+void GBRForestEvaluator::GetGradBoostClassifier(const float* inputs, unsigned int stride, unsigned int n, double* responses) const {
+  GetResponse(inputs, stride, n, responses);
+  for (unsigned int i=0; i<n; ++i) responses[i] = 2.0/(1.0+exp(-2.0*responses[i]))-1;
+}
+
+//_______________________________________________________________________
+void GBRForestEvaluator::WriteCode(const GBRForest &forest, const std::string &name, std::ostream &out) {
+  auto flags = out.flags();
+  out << std::hexfloat;
+  out << "// generated by GBRForestEvaluator::WriteCode, " << forest.Trees().size() << " trees\n";
+  out << "inline double " << name << "(const float* vector) {\n";
+  out << "  double response = " << forest.InitialResponse() << ";\n";
+  for (auto const &tree : forest.Trees()) {
+    out << "  response += ";
+    writeNode(tree, 0, false, out);
+    out << ";\n";
+  }
+  out << "  return response;\n}\n";
+  out.flags(flags);
+}
@@ -0,0 +1,118 @@
+#include "CondFormats/EgammaObjects/interface/GBRForestEvaluator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <ios>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+  std::mt19937 eng;
+
+  // random tree with up to maxDepth levels of intermediate nodes
+  int addNode(GBRTree &tree, unsigned int level, unsigned int maxDepth, unsigned int nvar) {
+    std::uniform_real_distribution<float> rgen(-1.f,1.f);
+    if (level>0 && (level==maxDepth || rgen(eng)>0.6f)) {
+      tree.Responses().push_back(rgen(eng));
+      return -int(tree.Responses().size()-1);
+    }
+    int index = tree.CutIndices().size();
+    tree.CutIndices().push_back(eng()%nvar);
+    tree.CutVals().push_back(rgen(eng));
+    tree.LeftIndices().push_back(0);
+    tree.RightIndices().push_back(0);
+    int left = addNode(tree, level+1, maxDepth, nvar);
+    tree.LeftIndices()[index] = left;
+    int right = addNode(tree, level+1, maxDepth, nvar);
+    tree.RightIndices()[index] = right;
+    return index;
+  }
+
+}
+
+int main() {
+
+  constexpr unsigned int nvar = 7;
+  constexpr unsigned int n = 37;
+
+  GBRForest forest;
+  forest.SetInitialResponse(0.25);
+  for (unsigned int it=0; it<50; ++it) {
+    forest.Trees().emplace_back();
+    addNode(forest.Trees().back(), 0, 3+it%12, nvar);
+  }
+  // root node terminal, as written by the TMVA conversion
+  forest.Trees().emplace_back();
+  GBRTree &single = forest.Trees().back();
+  single.Responses().push_back(0.5f);
+  single.CutIndices().push_back(0);
+  single.CutVals().push_back(0.f);
+  single.LeftIndices().push_back(0);
+  single.RightIndices().push_back(0);
+
+  // the inputs of the largest batch, nvar values and then padding read by no tree
+  std::uniform_real_distribution<float> rgen(-1.2f,1.2f);
+  constexpr unsigned int maxStride = nvar+3;
+  std::vector<float> inputs(n*maxStride);
+  for (unsigned int i=0; i<n; ++i)
+    for (unsigned int k=0; k<maxStride; ++k) inputs[i*maxStride+k] = k<nvar ? rgen(eng) : 1e30f;
+  // exactly on a cut
+  inputs[forest.Trees()[0].CutIndices()[0]] = forest.Trees()[0].CutVals()[0];
+
+  GBRForestEvaluator evaluator(forest);
+  assert(evaluator.NTrees()==forest.Trees().size());
+  assert(evaluator.NPaddedTrees()>0 && evaluator.NPaddedTrees()<evaluator.NTrees());
+
+  // no tree padded, only the shallow ones, all of them
+  for (unsigned int maxDepth : {0u, 4u, 10u, 14u}) {
+    GBRForestEvaluator limited(forest, maxDepth);
+    assert(limited.NTrees()==forest.Trees().size());
+    if (maxDepth==0) assert(limited.NPaddedTrees()==0);
+    if (maxDepth==14) assert(limited.NPaddedTrees()==limited.NTrees());
+
+    // contiguous and strided inputs; empty, single, full and partial blocks
+    for (unsigned int stride : {nvar, nvar+1, maxStride}) {
+      std::vector<float> x(n*stride);
+      for (unsigned int i=0; i<n; ++i)
+        std::copy(&inputs[i*maxStride], &inputs[i*maxStride]+stride, &x[i*stride]);
+      for (unsigned int m : {0u, 1u, 16u, 32u, n}) {
+        std::vector<double> responses(m+1, -99.);
+        limited.GetResponse(x.data(), stride, m, responses.data());
+        for (unsigned int i=0; i<m; ++i)
+          assert(responses[i]==forest.GetResponse(&x[i*stride]));
+        assert(responses[m]==-99.);
+
+        limited.GetGradBoostClassifier(x.data(), stride, m, responses.data());
+        for (unsigned int i=0; i<m; ++i)
+          assert(responses[i]==forest.GetGradBoostClassifier(&x[i*stride]));
+        assert(responses[m]==-99.);
+      }
+    }
+  }
+
+  // generated code: one statement per tree, cuts and responses in hexfloat,
+  // and the formatting of the stream left as it was
+  std::ostringstream code;
+  code << 1.5;
+  GBRForestEvaluator::WriteCode(forest, "testForest", code);
+  code << 1.5;
+  const std::string text = code.str();
+  assert(text.compare(0, 3, "1.5")==0);
+  assert(text.compare(text.size()-3, 3, "1.5")==0);
+  assert(text.find("inline double testForest(const float* vector) {\n")!=std::string::npos);
+  unsigned int nstatements = 0;
+  for (auto pos = text.find("  response += "); pos!=std::string::npos; pos = text.find("  response += ", pos+1)) ++nstatements;
+  assert(nstatements==forest.Trees().size());
+  std::ostringstream cut;
+  cut << std::hexfloat << "(vector[" << int(forest.Trees()[0].CutIndices()[0]) << "] > " << forest.Trees()[0].CutVals()[0] << "f ? ";
+  assert(text.find(cut.str())!=std::string::npos);
+  std::ostringstream last;
+  last << std::hexfloat << "  response += (vector[0] > " << single.CutVals()[0] << "f ? "
+       << single.Responses()[0] << "f : " << single.Responses()[0] << "f);\n  return response;\n}\n1.5";
+  assert(text.compare(text.size()-last.str().size(), last.str().size(), last.str())==0);
+
+  return 0;
+}
@@ -0,0 +1,41 @@
+#ifndef SiPixelFedCablingTable_H
+#define SiPixelFedCablingTable_H
+
+/** \class SiPixelFedCablingTable
+ *  Dense (fed, link, roc) lookup table of the PixelROCs of a SiPixelFedCablingTree,
+ *  for the raw to digi conversion. The table owns the tree the ROCs belong to.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingTree.h"
+#include "CondFormats/SiPixelObjects/interface/PixelROC.h"
+
+class SiPixelFedCablingTable {
+
+public:
+
+  explicit SiPixelFedCablingTable(std::unique_ptr<SiPixelFedCablingTree> tree);
+
+  const SiPixelFedCablingTree & cablingTree() const { return *theTree; }
+
+  /// ROC at link (from 1) and roc (from 1) of the fed, nullptr if it is not cabled
+  const sipixelobjects::PixelROC * roc(unsigned int fedId, unsigned int linkId, unsigned int rocId) const {
+    unsigned int fed = fedId - theMinFed;
+    unsigned int link = linkId - 1;
+    unsigned int roc = rocId - 1;
+    if (fed >= theNFeds || link >= theNLinks || roc >= theNRocs) return nullptr;
+    return theRocs[(fed*theNLinks + link)*theNRocs + roc];
+  }
+
+private:
+  std::unique_ptr<SiPixelFedCablingTree> theTree;
+  unsigned int theMinFed = 0;
+  unsigned int theNFeds = 0;
+  unsigned int theNLinks = 0;
+  unsigned int theNRocs = 0;
+  std::vector<const sipixelobjects::PixelROC *> theRocs;
+};
+
+#endif
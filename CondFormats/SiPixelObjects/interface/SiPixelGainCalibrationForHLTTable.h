@@ -0,0 +1,72 @@
+#ifndef SiPixelGainCalibrationForHLTTable_H
+#define SiPixelGainCalibrationForHLTTable_H
+
+/** \class SiPixelGainCalibrationForHLTTable
+ *  Decoded gains and pedestals of a SiPixelGainCalibrationForHLT payload, 
+ *  stored as flat arrays indexed by module, column and averaged block of rows,
+ *  for the calibration of the pixel digis in the clusterizer.
+ */
+
+#include <cstdint>
+#include <vector>
+
+class SiPixelGainCalibrationForHLT;
+
+class SiPixelGainCalibrationForHLTTable {
+
+public:
+
+  /// calibration of one module
+  struct Module {
+    const float * gain = nullptr;
+    const float * pedestal = nullptr;
+    const unsigned char * bad = nullptr;  // dead or noisy column
+    unsigned int size = 0;
+    unsigned int nBlocks = 0;
+    unsigned int rowsPerBlock = 1;
+    bool valid() const { return gain!=nullptr; }
+    unsigned int index(int col, int row) const { return col*nBlocks + row/rowsPerBlock; }
+  };
+
+  explicit SiPixelGainCalibrationForHLTTable(const SiPixelGainCalibrationForHLT & payload);
+
+  /// invalid if the module is not in the payload
+  Module module(uint32_t detId) const;
+
+  unsigned int nModules() const { return theDetIds.size(); }
+
+  /// Calibrates the digis of a valid module to electrons, with the same arithmetic as
+  /// SiPixelGainCalibrationForHLTService::calibrate, split in a gather and a loop
+  /// without branches. Digis of dead or noisy columns, or outside the module, get 0.
+  template<typename DigiIterator>
+  static void calibrate(const Module & module, DigiIterator begin, DigiIterator end,
+                        float conversionFactor, float offset, int * electron) {
+    int n = end-begin;
+    unsigned int index[n];
+    float adc[n];
+    int i=0;
+    for (DigiIterator di = begin; di != end; ++di, ++i) {
+      index[i] = module.index(di->column(), di->row());
+      adc[i] = di->adc();
+    }
+    for (i=0; i<n; ++i) {
+      bool inModule = index[i] < module.size;
+      unsigned int k = inModule ? index[i] : 0;
+      float gain = module.gain[k];
+      float vcal = adc[i] * gain  - module.pedestal[k]*gain;
+      int e = int( vcal * conversionFactor + offset);
+      electron[i] = (inModule & !module.bad[k]) ? e : 0;
+    }
+  }
+
+private:
+  unsigned int theRowsPerBlock;
+  std::vector<uint32_t> theDetIds;            // sorted
+  std::vector<unsigned int> theOffsets;       // first entry of each module, and end
+  std::vector<unsigned int> theNBlocks;       // averaged blocks of rows per column
+  std::vector<float> theGains;
+  std::vector<float> thePedestals;
+  std::vector<unsigned char> theBad;
+};
+
+#endif
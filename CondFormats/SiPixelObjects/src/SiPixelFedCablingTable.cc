@@ -0,0 +1,32 @@
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingTable.h"
+
+#include <algorithm>
+
+using namespace sipixelobjects;
+
+SiPixelFedCablingTable::SiPixelFedCablingTable(std::unique_ptr<SiPixelFedCablingTree> tree)
+  : theTree(std::move(tree))
+{
+  std::vector<const PixelFEDCabling *> feds = theTree->fedList();
+  if (feds.empty()) return;
+
+  unsigned int maxFed = 0;
+  theMinFed = feds.front()->id();
+  for (auto fed : feds) {
+    theMinFed = std::min(theMinFed, fed->id());
+    maxFed = std::max(maxFed, fed->id());
+    theNLinks = std::max(theNLinks, fed->numberOfLinks());
+    for (unsigned int idLink = 1; idLink <= fed->numberOfLinks(); ++idLink)
+      theNRocs = std::max(theNRocs, fed->link(idLink)->numberOfROCs());
+  }
+  theNFeds = maxFed - theMinFed + 1;
+
+  theRocs.resize(theNFeds*theNLinks*theNRocs, nullptr);
+  for (auto fed : feds) {
+    for (unsigned int idLink = 1; idLink <= fed->numberOfLinks(); ++idLink) {
+      const PixelFEDLink * link = fed->link(idLink);
+      for (unsigned int idRoc = 1; idRoc <= link->numberOfROCs(); ++idRoc)
+        theRocs[((fed->id() - theMinFed)*theNLinks + idLink-1)*theNRocs + idRoc-1] = link->roc(idRoc);
+    }
+  }
+}
@@ -0,0 +1,50 @@
+#include "CondFormats/SiPixelObjects/interface/SiPixelGainCalibrationForHLTTable.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelGainCalibrationForHLT.h"
+
+#include <algorithm>
+
+SiPixelGainCalibrationForHLTTable::SiPixelGainCalibrationForHLTTable(const SiPixelGainCalibrationForHLT & payload)
+  : theRowsPerBlock(std::max(1U, payload.getNumberOfRowsToAverageOver()))
+{
+  payload.getDetIds(theDetIds);
+  std::sort(theDetIds.begin(), theDetIds.end());
+
+  theOffsets.reserve(theDetIds.size()+1);
+  theNBlocks.reserve(theDetIds.size());
+  for (auto detId : theDetIds) {
+    theOffsets.push_back(theGains.size());
+    auto rangeAndNCols = payload.getRangeAndNCols(detId);
+    auto const & range = rangeAndNCols.first;
+    int nCols = rangeAndNCols.second;
+    // two values (pedestal and gain) per column and averaged block
+    unsigned int nBlocks = nCols>0 ? (range.second-range.first)/nCols/2 : 0;
+    theNBlocks.push_back(nBlocks);
+    for (int col = 0; col < nCols; ++col) {
+      for (unsigned int block = 0; block < nBlocks; ++block) {
+        bool isDead = false, isNoisy = false;
+        auto pedAndGain = payload.getPedAndGain(col, block*theRowsPerBlock, range, nCols, isDead, isNoisy);
+        thePedestals.push_back(pedAndGain.first);
+        theGains.push_back(pedAndGain.second);
+        theBad.push_back(isDead || isNoisy);
+      }
+    }
+  }
+  theOffsets.push_back(theGains.size());
+}
+
+SiPixelGainCalibrationForHLTTable::Module
+SiPixelGainCalibrationForHLTTable::module(uint32_t detId) const
+{
+  Module module;
+  auto p = std::lower_bound(theDetIds.begin(), theDetIds.end(), detId);
+  if (p == theDetIds.end() || *p != detId) return module;
+  auto i = p - theDetIds.begin();
+  if (theOffsets[i] == theOffsets[i+1]) return module;
+  module.gain = theGains.data() + theOffsets[i];
+  module.pedestal = thePedestals.data() + theOffsets[i];
+  module.bad = theBad.data() + theOffsets[i];
+  module.size = theOffsets[i+1] - theOffsets[i];
+  module.nBlocks = theNBlocks[i];
+  module.rowsPerBlock = theRowsPerBlock;
+  return module;
+}
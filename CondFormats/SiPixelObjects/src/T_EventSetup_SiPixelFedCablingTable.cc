@@ -0,0 +1,4 @@
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingTable.h"
+#include "FWCore/Utilities/interface/typelookup.h"
+
+TYPELOOKUP_DATA_REG(SiPixelFedCablingTable);
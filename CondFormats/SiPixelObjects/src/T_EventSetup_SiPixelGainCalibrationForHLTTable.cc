@@ -0,0 +1,4 @@
+#include "CondFormats/SiPixelObjects/interface/SiPixelGainCalibrationForHLTTable.h"
+#include "FWCore/Utilities/interface/typelookup.h"
+
+TYPELOOKUP_DATA_REG(SiPixelGainCalibrationForHLTTable);
@@ -0,0 +1,55 @@
+// SiPixelFedCablingTable must give the same ROC as SiPixelFedCablingTree::findItem
+// for every (fed, link, roc), including missing feds, missing links, links with
+// fewer ROCs and indices out of the table.
+
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingTable.h"
+#include "CondFormats/SiPixelObjects/interface/CablingPathToDetUnit.h"
+
+#include <iostream>
+#include <memory>
+#include <random>
+
+using namespace sipixelobjects;
+
+int main() {
+  std::mt19937 eng(7);
+  std::uniform_int_distribution<unsigned int> nRocs(0, 8);
+  std::uniform_int_distribution<unsigned int> skip(0, 5);
+
+  // feds 1200-1220 without 1203 and 1210, links 1-36 with some left out
+  auto tree = std::make_unique<SiPixelFedCablingTree>("test");
+  const uint32_t barrel = 0x12000000;
+  for (unsigned int fed = 1200; fed <= 1220; ++fed) {
+    if (fed == 1203 || fed == 1210) continue;
+    for (unsigned int link = 1; link <= 36; ++link) {
+      if (skip(eng) == 0) continue;
+      const unsigned int n = nRocs(eng);
+      for (unsigned int roc = 1; roc <= n; ++roc)
+        tree->addItem(fed, link, PixelROC(barrel + 4096*(fed-1200) + 64*link, roc-1, roc));
+    }
+  }
+  // a single far away fed
+  tree->addItem(1300, 2, PixelROC(barrel + 0x100000, 0, 1));
+
+  const SiPixelFedCablingTree * treePtr = tree.get();
+  const SiPixelFedCablingTable table(std::move(tree));
+
+  unsigned int nFound = 0;
+  for (unsigned int fed = 1190; fed <= 1310; ++fed) {
+    for (unsigned int link = 0; link <= 40; ++link) {
+      for (unsigned int roc = 0; roc <= 10; ++roc) {
+        const PixelROC * expected = treePtr->findItem(CablingPathToDetUnit{fed, link, roc});
+        const PixelROC * found = table.roc(fed, link, roc);
+        if (found != expected) {
+          std::cout << "fed " << fed << " link " << link << " roc " << roc << ": table gives " << found
+                    << ", tree gives " << expected << std::endl;
+          return 1;
+        }
+        if (found) ++nFound;
+      }
+    }
+  }
+  std::cout << "table equal to the tree for " << nFound << " ROCs" << std::endl;
+
+  return 0;
+}
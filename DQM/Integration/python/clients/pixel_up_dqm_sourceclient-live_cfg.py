@@ -119,6 +119,7 @@ process.PBClusters = cms.EDProducer("SiPixelClusterProducer",
   VCaltoElectronGain = cms.int32(65),
   VCaltoElectronOffset = cms.int32(-414),                          
   payloadType = cms.string('Offline'),
+  UseCalibrationTable = cms.bool(False),
   SeedThreshold = cms.int32(1000),
   ClusterThreshold = cms.double(4000.0),
   maxNumberOfClusters = cms.int32(-1),
@@ -8,6 +8,12 @@
  *  lenght of the data is a multiple of the S-Link64 word lenght (8 byte).
  *  The FED data should include the standard FED header and trailer.
  *
+ *  The data can also be a read-only view of a buffer owned elsewhere
+ *  (e.g. the read-ahead buffer of the input source), kept alive by a
+ *  reference-counted owner. A view is copied into the owned buffer by the
+ *  non-const accessors. Its members are transient: it is written out as an
+ *  owned buffer by FEDRawDataStreamer, which whoever makes views installs.
+ *
  *  \author G. Bruno - CERN, EP Division
  *  \author S. Argiro - CERN and INFN - 
  *                      Refactoring and Modifications to fit into CMSSW
@@ -16,6 +22,7 @@
 
 #include <vector>
 #include <cstddef>
+#include <memory>
 
 class FEDRawData {
 
@@ -31,6 +38,11 @@ class FEDRawData {
   /// word (8 bytes)
   FEDRawData(size_t newsize);
 
+  /// Ctor referencing size bytes at data, kept alive by owner.
+  /// It is required that the size is a multiple of the size of a FED
+  /// word (8 bytes)
+  FEDRawData(const unsigned char * data, size_t size, std::shared_ptr<const void> owner);
+
   /// Copy constructor
   FEDRawData(const FEDRawData &);
 
@@ -41,20 +53,34 @@ class FEDRawData {
   const unsigned char * data() const;
 
   /// Return a pointer to the beginning of the data buffer
+  /// (a view is copied into the owned buffer first)
   unsigned char * data();
 
   /// Lenght of the data buffer in bytes
-  size_t size() const {return data_.size();}
-    
+  size_t size() const {return view_ ? viewSize_ : data_.size();}
+
+  /// True if the data is a view of a buffer owned elsewhere
+  bool isView() const {return view_ != nullptr;}
+
   /// Resize to the specified size in bytes. It is required that 
   /// the size is a multiple of the size of a FED word (8 bytes)
   void resize(size_t newsize);
 
+  /// Reference size bytes at data, kept alive by owner, instead of
+  /// the owned buffer
+  void setView(const unsigned char * data, size_t size, std::shared_ptr<const void> owner);
+
  private:
 
+  void copyView();
 
   Data data_;
 
+  // transient view of an external buffer
+  const unsigned char * view_ = nullptr;
+  size_t viewSize_ = 0;
+  std::shared_ptr<const void> owner_;
+
 };
 
 #endif
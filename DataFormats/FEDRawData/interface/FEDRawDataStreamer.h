@@ -0,0 +1,31 @@
+#ifndef FEDRawData_FEDRawDataStreamer_h
+#define FEDRawData_FEDRawDataStreamer_h
+
+/** \class FEDRawDataStreamer
+ *
+ *  ROOT streamer of FEDRawData: a view of an external buffer is written
+ *  as if its bytes were owned, so that it reads back as an owned buffer.
+ *  It is needed only where views are made; setFEDRawDataStreamerInTClass()
+ *  installs it.
+ */
+
+#include "TClassStreamer.h"
+#include "TClassRef.h"
+
+class TBuffer;
+
+class FEDRawDataStreamer : public TClassStreamer {
+ public:
+  explicit FEDRawDataStreamer() : cl_("FEDRawData") {}
+
+  void operator() (TBuffer &R__b, void *objp) override;
+
+  TClassStreamer* Generate() const override;
+
+ private:
+  TClassRef cl_;
+};
+
+void setFEDRawDataStreamerInTClass();
+
+#endif
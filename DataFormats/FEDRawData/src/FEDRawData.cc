@@ -19,20 +19,46 @@ FEDRawData::FEDRawData(size_t newsize):data_(newsize){
   if (newsize%8!=0) throw cms::Exception("DataCorrupt") << "FEDRawData::resize: " << newsize << " is not a multiple of 8 bytes." << endl;
 }
 
-FEDRawData::FEDRawData(const FEDRawData &in) : data_(in.data_)
+FEDRawData::FEDRawData(const unsigned char * data, size_t size, std::shared_ptr<const void> owner){
+  setView(data, size, std::move(owner));
+}
+
+FEDRawData::FEDRawData(const FEDRawData &in) : data_(in.data_),
+  view_(in.view_), viewSize_(in.viewSize_), owner_(in.owner_)
 {
 }
 FEDRawData::~FEDRawData()
 {
 }
-const unsigned char * FEDRawData::data()const {return &data_[0];}
+const unsigned char * FEDRawData::data()const {return view_ ? view_ : &data_[0];}
 
-unsigned char * FEDRawData::data() {return &data_[0];}
+unsigned char * FEDRawData::data() {
+  if (view_) copyView();
+  return &data_[0];
+}
 
 void FEDRawData::resize(size_t newsize) {
   if (size()==newsize) return;
 
+  if (view_) copyView();
+
   data_.resize(newsize);
 
   if (newsize%8!=0) throw cms::Exception("DataCorrupt") << "FEDRawData::resize: " << newsize << " is not a multiple of 8 bytes." << endl;
 }
+
+void FEDRawData::setView(const unsigned char * data, size_t size, std::shared_ptr<const void> owner) {
+  if (size%8!=0) throw cms::Exception("DataCorrupt") << "FEDRawData::setView: " << size << " is not a multiple of 8 bytes." << endl;
+
+  Data().swap(data_);
+  view_ = data;
+  viewSize_ = size;
+  owner_ = std::move(owner);
+}
+
+void FEDRawData::copyView() {
+  data_.assign(view_, view_ + viewSize_);
+  view_ = nullptr;
+  viewSize_ = 0;
+  owner_.reset();
+}
@@ -0,0 +1,36 @@
+#include "DataFormats/FEDRawData/interface/FEDRawDataStreamer.h"
+#include "DataFormats/FEDRawData/interface/FEDRawData.h"
+#include "TBuffer.h"
+#include "TClass.h"
+
+#include <cstring>
+
+void
+FEDRawDataStreamer::operator()(TBuffer &R__b, void *objp) {
+  if (R__b.IsReading()) {
+    cl_->ReadBuffer(R__b, objp);
+  } else {
+    FEDRawData* obj = static_cast<FEDRawData*>(objp);
+    if (obj->isView()) {
+      // the view members are transient: write an owned copy of the bytes
+      FEDRawData owned(obj->size());
+      if (obj->size()) std::memcpy(owned.data(), static_cast<const FEDRawData*>(obj)->data(), obj->size());
+      cl_->WriteBuffer(R__b, &owned);
+    } else {
+      cl_->WriteBuffer(R__b, objp);
+    }
+  }
+}
+
+TClassStreamer*
+FEDRawDataStreamer::Generate() const {
+  return new FEDRawDataStreamer(*this);
+}
+
+void setFEDRawDataStreamerInTClass() {
+  TClass *cl = TClass::GetClass("FEDRawData");
+  TClassStreamer *st = cl->GetStreamer();
+  if (st == nullptr) {
+    cl->AdoptStreamer(new FEDRawDataStreamer());
+  }
+}
@@ -0,0 +1,62 @@
+// A FEDRawDataCollection holding views is written with FEDRawDataStreamer
+// and read back with the same bytes, as owned buffers.
+
+#include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+#include "DataFormats/FEDRawData/interface/FEDNumbering.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataStreamer.h"
+#include "FWCore/PluginManager/interface/PluginManager.h"
+#include "FWCore/PluginManager/interface/standard.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/TypeWithDict.h"
+
+#include "TClass.h"
+#include "TBufferFile.h"
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+int main() {
+  edmplugin::PluginManager::configure(edmplugin::standard::config());
+  if (!edm::TypeWithDict::byName("FEDRawDataCollection")) {
+    throw cms::Exception("DictionaryMissingClass") << "The dictionary of class 'FEDRawDataCollection' is missing!";
+  }
+  setFEDRawDataStreamerInTClass();
+
+  auto buffer = std::make_shared<std::vector<unsigned char> >(64);
+  for (unsigned int i=0; i<buffer->size(); ++i) (*buffer)[i] = i;
+
+  FEDRawDataCollection coll;
+  coll.FEDData(1).setView(buffer->data(), 16, buffer);
+  coll.FEDData(2).setView(buffer->data()+16, 48, buffer);
+  coll.FEDData(3).resize(8);
+  std::memset(coll.FEDData(3).data(), 7, 8);
+  assert(coll.FEDData(1).isView() && coll.FEDData(2).isView());
+
+  TClass* cl = TClass::GetClass(typeid(FEDRawDataCollection));
+  assert(cl);
+  TBufferFile wbuf(TBufferFile::kWrite);
+  wbuf.InitMap();
+  wbuf.WriteObjectAny(&coll, cl);
+
+  TBufferFile rbuf(TBufferFile::kRead, wbuf.Length(), wbuf.Buffer(), kFALSE);
+  rbuf.InitMap();
+  std::unique_ptr<FEDRawDataCollection> read(static_cast<FEDRawDataCollection*>(rbuf.ReadObjectAny(cl)));
+  assert(read);
+
+  const FEDRawDataCollection& in = coll;
+  const FEDRawDataCollection& out = *read;
+  for (int id=0; id<=FEDNumbering::lastFEDId(); ++id) {
+    assert(!out.FEDData(id).isView());
+    assert(out.FEDData(id).size() == in.FEDData(id).size());
+    if (in.FEDData(id).size())
+      assert(std::memcmp(out.FEDData(id).data(), in.FEDData(id).data(), in.FEDData(id).size()) == 0);
+  }
+  // writing does not touch the views
+  assert(coll.FEDData(1).isView() && coll.FEDData(2).isView());
+
+  std::cout << "FEDRawDataStreamer OK" << std::endl;
+  return 0;
+}
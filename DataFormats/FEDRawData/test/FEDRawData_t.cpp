@@ -10,6 +10,8 @@
 #include <DataFormats/FEDRawData/interface/FEDRawData.h>
 
 #include <iostream>
+#include <memory>
+#include <vector>
 
 class testFEDRawData: public CppUnit::TestFixture {
 
@@ -17,6 +19,7 @@ class testFEDRawData: public CppUnit::TestFixture {
 
   CPPUNIT_TEST(testCtor);
   CPPUNIT_TEST(testdata);
+  CPPUNIT_TEST(testView);
  
   CPPUNIT_TEST_SUITE_END();
 
@@ -27,6 +30,7 @@ public:
   void tearDown(){}  
   void testCtor();
   void testdata(); 
+  void testView();
  
 }; 
 
@@ -56,5 +60,33 @@ void testFEDRawData::testdata(){
   CPPUNIT_ASSERT(buf[47] == 'c');
 }
 
+void testFEDRawData::testView(){
+  auto buffer = std::make_shared<std::vector<unsigned char> >(32, 'x');
+  (*buffer)[8]='a';
+
+  FEDRawData f(buffer->data()+8, 16, buffer);
+  CPPUNIT_ASSERT(f.isView());
+  CPPUNIT_ASSERT(f.size()==size_t(16));
+  CPPUNIT_ASSERT(static_cast<const FEDRawData&>(f).data()==buffer->data()+8);
+
+  // copies share the view and keep the buffer alive
+  FEDRawData g(f);
+  std::weak_ptr<std::vector<unsigned char> > watch(buffer);
+  buffer.reset();
+  CPPUNIT_ASSERT(!watch.expired());
+  CPPUNIT_ASSERT(g.isView());
+
+  // non-const access copies the view
+  g.data()[0]='b';
+  CPPUNIT_ASSERT(!g.isView());
+  CPPUNIT_ASSERT(g.size()==size_t(16));
+  CPPUNIT_ASSERT(static_cast<const FEDRawData&>(f).data()[0]=='a');
+
+  f.resize(8);
+  CPPUNIT_ASSERT(watch.expired());
+  CPPUNIT_ASSERT(f.size()==size_t(8));
+  CPPUNIT_ASSERT(f.data()[0]=='a');
+}
+
 
 #include <Utilities/Testing/interface/CppUnit_testdriver.icpp>
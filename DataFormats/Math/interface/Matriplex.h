@@ -0,0 +1,106 @@
+#ifndef DataFormat_Math_Matriplex_H
+#define DataFormat_Math_Matriplex_H
+
+#define SMATRIX_USE_CONSTEXPR
+#include "Math/SMatrix.h"
+
+/*  Structure-of-arrays storage of N small matrices ("matriplex").
+ *
+ *  Element (i,j) of the N matrices is stored contiguously, so that a loop
+ *  over the N lanes in the innermost position is a plain vector operation.
+ *  Symmetric matrices keep only the lower triangle.
+ *  Lanes are filled from / written back to the usual SMatrix objects with
+ *  load()/store(); the arithmetic helpers act on all N lanes at once.
+ */
+namespace matriplex {
+
+  template<typename T, unsigned int R, unsigned int C, unsigned int N>
+  struct Matrix {
+    static constexpr unsigned int kSize = R*C;
+    alignas(64) T fArray[kSize][N];
+
+    T * operator()(unsigned int i, unsigned int j) { return fArray[i*C+j]; }
+    T const * operator()(unsigned int i, unsigned int j) const { return fArray[i*C+j]; }
+  };
+
+  template<typename T, unsigned int D, unsigned int N>
+  struct SymMatrix {
+    static constexpr unsigned int kSize = D*(D+1)/2;
+    static constexpr unsigned int idx(unsigned int i, unsigned int j) {
+      return i>=j ? i*(i+1)/2+j : j*(j+1)/2+i;
+    }
+    alignas(64) T fArray[kSize][N];
+
+    T * operator()(unsigned int i, unsigned int j) { return fArray[idx(i,j)]; }
+    T const * operator()(unsigned int i, unsigned int j) const { return fArray[idx(i,j)]; }
+  };
+
+  template<typename T, unsigned int D, unsigned int N>
+  using Vector = Matrix<T,D,1,N>;
+
+
+  // lane n <-> SMatrix
+  template<typename T, unsigned int R, unsigned int C, unsigned int N, typename M>
+  inline void load(Matrix<T,R,C,N> & m, unsigned int n, M const & s) {
+    for (unsigned int i=0; i<R; ++i)
+      for (unsigned int j=0; j<C; ++j)
+	m(i,j)[n] = s(i,j);
+  }
+
+  template<typename T, unsigned int D, unsigned int N, typename V>
+  inline void loadVector(Vector<T,D,N> & m, unsigned int n, V const & s) {
+    for (unsigned int i=0; i<D; ++i) m(i,0)[n] = s[i];
+  }
+
+  template<typename T, unsigned int D, unsigned int N, typename M>
+  inline void load(SymMatrix<T,D,N> & m, unsigned int n, M const & s) {
+    for (unsigned int i=0; i<D; ++i)
+      for (unsigned int j=0; j<=i; ++j)
+	m(i,j)[n] = s(i,j);
+  }
+
+  template<typename T, unsigned int D, unsigned int N, typename M>
+  inline void store(SymMatrix<T,D,N> const & m, unsigned int n, M & s) {
+    for (unsigned int i=0; i<D; ++i)
+      for (unsigned int j=0; j<=i; ++j)
+	s(i,j) = m(i,j)[n];
+  }
+
+  template<typename T, unsigned int D, unsigned int N, typename V>
+  inline void storeVector(Vector<T,D,N> const & m, unsigned int n, V & s) {
+    for (unsigned int i=0; i<D; ++i) s[i] = m(i,0)[n];
+  }
+
+
+  // B = J*A*J^T for the first n lanes
+  template<typename T, unsigned int D, unsigned int N>
+  inline void similarity(Matrix<T,D,D,N> const & __restrict__ J,
+			 SymMatrix<T,D,N> const & __restrict__ A,
+			 SymMatrix<T,D,N> & __restrict__ B,
+			 unsigned int n = N) {
+    Matrix<T,D,D,N> JA;
+    for (unsigned int i=0; i<D; ++i)
+      for (unsigned int j=0; j<D; ++j) {
+	T * __restrict__ ja = JA(i,j);
+	for (unsigned int l=0; l<n; ++l) ja[l] = T(0);
+	for (unsigned int k=0; k<D; ++k) {
+	  T const * __restrict__ jik = J(i,k);
+	  T const * __restrict__ akj = A(k,j);
+	  for (unsigned int l=0; l<n; ++l) ja[l] += jik[l]*akj[l];
+	}
+      }
+    for (unsigned int i=0; i<D; ++i)
+      for (unsigned int j=0; j<=i; ++j) {
+	T * __restrict__ b = B(i,j);
+	for (unsigned int l=0; l<n; ++l) b[l] = T(0);
+	for (unsigned int k=0; k<D; ++k) {
+	  T const * __restrict__ jaik = JA(i,k);
+	  T const * __restrict__ jjk = J(j,k);
+	  for (unsigned int l=0; l<n; ++l) b[l] += jaik[l]*jjk[l];
+	}
+      }
+  }
+
+}
+
+#endif
@@ -0,0 +1,47 @@
+#include "DataFormats/Math/interface/Matriplex.h"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+typedef ROOT::Math::SMatrix<double,5,5,ROOT::Math::MatRepSym<double,5> > Sym5;
+typedef ROOT::Math::SMatrix<double,5,5> Mat5;
+
+int main() {
+
+  constexpr unsigned int N = 8;
+  std::mt19937 eng;
+  std::uniform_real_distribution<double> rgen(-1.,1.);
+
+  Mat5 J[N];
+  Sym5 C[N];
+  matriplex::Matrix<double,5,5,N> mJ;
+  matriplex::SymMatrix<double,5,N> mC, mB;
+
+  for (unsigned int n=0; n<N; ++n) {
+    for (unsigned int i=0; i<5; ++i) {
+      for (unsigned int j=0; j<5; ++j) J[n](i,j) = rgen(eng);
+      for (unsigned int j=0; j<=i; ++j) C[n](i,j) = rgen(eng);
+      C[n](i,i) += 5.;
+    }
+    matriplex::load(mJ,n,J[n]);
+    matriplex::load(mC,n,C[n]);
+  }
+
+  // all lanes and a partial batch
+  for (unsigned int nl : {N, N-3}) {
+    matriplex::similarity(mJ,mC,mB,nl);
+    for (unsigned int n=0; n<nl; ++n) {
+      Sym5 ref = ROOT::Math::Similarity(J[n],C[n]);
+      Sym5 res;
+      matriplex::store(mB,n,res);
+      for (unsigned int i=0; i<5; ++i)
+	for (unsigned int j=0; j<=i; ++j)
+	  assert(std::abs(res(i,j)-ref(i,j)) <= 1.e-12*std::max(1.,std::abs(ref(i,j))));
+    }
+  }
+
+  std::cout << "matriplex similarity OK" << std::endl;
+  return 0;
+}
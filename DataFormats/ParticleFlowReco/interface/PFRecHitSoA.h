@@ -0,0 +1,47 @@
+#ifndef DataFormats_ParticleFlowReco_PFRecHitSoA_h
+#define DataFormats_ParticleFlowReco_PFRecHitSoA_h
+
+#include "DataFormats/ParticleFlowReco/interface/PFRecHitFwd.h"
+
+#include <vector>
+
+namespace reco {
+
+  /**\class PFRecHitSoA
+     \brief Structure-of-arrays copy of a PFRecHitCollection for clustering.
+
+     Produced by the PFRecHitProducer next to the PFRecHitCollection, with
+     the same hit indexing. It keeps the quantities the topological
+     clustering needs in flat arrays (energy, pt2, position, layer key,
+     depth) and the neighbour lists in CSR form: the neighbours of hit i
+     are neighbours[neighbourOffsets[i] .. neighbours4End[i]) for the 4
+     sharing a side and neighbours[neighbourOffsets[i] .. neighbours8End[i])
+     including the corners.
+     Transient: the neighbours of the PFRecHits are not persistent either.
+  */
+  class PFRecHitSoA {
+  public:
+    PFRecHitSoA() = default;
+
+    /// refills the arrays from the collection, whose neighbours must be set
+    void fill(const PFRecHitCollection& hits);
+
+    unsigned int size() const { return energy.size(); }
+
+    // flat per-hit quantities
+    std::vector<float> energy;
+    std::vector<double> pt2;
+    std::vector<float> x, y, z;
+    std::vector<int> layer; // PFLayer, with HCAL_BARREL2 ring 1 scaled by 100
+    std::vector<int> depth;
+
+    // CSR neighbour storage
+    std::vector<unsigned int> neighbourOffsets;
+    std::vector<unsigned int> neighbours4End;
+    std::vector<unsigned int> neighbours8End;
+    std::vector<unsigned int> neighbours;
+  };
+
+}
+
+#endif
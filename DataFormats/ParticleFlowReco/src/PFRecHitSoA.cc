@@ -0,0 +1,45 @@
+#include "DataFormats/ParticleFlowReco/interface/PFRecHitSoA.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHit.h"
+
+#include <cmath>
+
+void reco::PFRecHitSoA::fill(const reco::PFRecHitCollection& hits) {
+  const unsigned int nhits = hits.size();
+  energy.resize(nhits);
+  pt2.resize(nhits);
+  x.resize(nhits);
+  y.resize(nhits);
+  z.resize(nhits);
+  layer.resize(nhits);
+  depth.resize(nhits);
+  neighbourOffsets.resize(nhits+1);
+  neighbours4End.resize(nhits);
+  neighbours8End.resize(nhits);
+  neighbours.clear();
+
+  neighbourOffsets[0] = 0;
+  for( unsigned int i = 0; i < nhits; ++i ) {
+    auto const & hit = hits[i];
+    auto const & pos = hit.position();
+    energy[i] = hit.energy();
+    pt2[i]    = hit.pt2();
+    x[i]      = pos.x();
+    y[i]      = pos.y();
+    z[i]      = pos.z();
+    depth[i]  = hit.depth();
+    int cell_layer = (int)hit.layer();
+    if( cell_layer == PFLayer::HCAL_BARREL2 &&
+        std::abs(hit.positionREP().eta()) > 0.34 ) {
+      cell_layer *= 100;
+    }
+    layer[i] = cell_layer;
+
+    // the 4 and 8 neighbours are the first ones of the full list
+    const unsigned int first = neighbours.size();
+    auto const & nbs = hit.neighbours();
+    neighbours.insert(neighbours.end(),nbs.begin(),nbs.end());
+    neighbours4End[i] = first + hit.neighbours4().size();
+    neighbours8End[i] = first + hit.neighbours8().size();
+    neighbourOffsets[i+1] = neighbours.size();
+  }
+}
@@ -7,6 +7,7 @@
 #include "DataFormats/ParticleFlowReco/interface/PFCluster.h"
 #include "Math/Cartesian3D.h"
 #include "DataFormats/ParticleFlowReco/interface/PFRecHit.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHitSoA.h"
 #include "Math/Polar3D.h"
 #include "Math/CylindricalEta3D.h"
 #include "DataFormats/ParticleFlowReco/interface/PFRecTrack.h"
@@ -71,6 +72,9 @@ namespace DataFormats_ParticleFlowReco {
     std::vector<reco::PFCluster>                         dummy1;
     edm::Wrapper< std::vector<reco::PFCluster> >         dummy2;
 
+    reco::PFRecHitSoA dummy_soa;
+    edm::Wrapper<reco::PFRecHitSoA> dummy_wsoa;
+
     reco::HGCalMultiCluster dummy_hgcmc;
     std::vector<reco::HGCalMultiCluster> dummy_vhgcmc;
     edm::Wrapper<std::vector<reco::HGCalMultiCluster> > dummy_wvhgcmc;
@@ -51,6 +51,7 @@ class SiPixelQuality;
 class SiPixelFrameConverter;
 class SiPixelFrameReverter;
 class SiPixelFedCablingTree;
+class SiPixelFedCablingTable;
 
 class PixelDataFormatter {
 
@@ -68,18 +69,32 @@ public:
   typedef cms_uint32_t Word32;
   typedef cms_uint64_t Word64;
 
+  /// digis of one FED in unpacking order, with the modules (DetId, index of the first digi) they belong to
+  struct DigiBuffer {
+    std::vector<std::pair<cms_uint32_t, unsigned int> > modules;
+    std::vector<PixelDigi> digis;
+    void clear() { modules.clear(); digis.clear(); }
+  };
+
   PixelDataFormatter(const SiPixelFedCabling* map, bool phase1=false);
 
   void setErrorStatus(bool ErrorStatus);
   void setQualityStatus(bool QualityStatus, const SiPixelQuality* QualityInfo);
   void setModulesToUnpack(const std::set<unsigned int> * moduleIds);
   void passFrameReverter(const SiPixelFrameReverter* reverter);
+  void setCablingTable(const SiPixelFedCablingTable* table);
 
   int nDigis() const { return theDigiCounter; }
   int nWords() const { return theWordCounter; }
 
   void interpretRawData(bool& errorsInEvent, int fedId,  const FEDRawData & data, Collection & digis, Errors & errors);
 
+  /// unpack into a buffer, so that FEDs can be unpacked concurrently
+  void interpretRawData(bool& errorsInEvent, int fedId,  const FEDRawData & data, DigiBuffer & digis, Errors & errors);
+
+  /// move the digis of a buffer into the collection
+  static void fillDigis(const DigiBuffer & buffer, Collection & digis);
+
   void formatRawData( unsigned int lvl1_ID, RawData & fedRawData, const Digis & digis);
 
   cms_uint32_t linkId(cms_uint32_t word32) { return (word32 >> LINK_shift) & LINK_mask; }
@@ -89,6 +104,7 @@ private:
   mutable int theWordCounter;
 
   SiPixelFedCabling const * theCablingTree;
+  const SiPixelFedCablingTable* theCablingTable;
   const SiPixelFrameReverter* theFrameReverter;
   const SiPixelQuality* badPixelInfo;
   const std::set<unsigned int> * modulesToUnpack;
@@ -112,6 +128,9 @@ private:
 
   int checkError(const Word32& data) const;
 
+  template<typename DigiFiller>
+  void unpack(bool& errorsInEvent, int fedId, const FEDRawData & data, DigiFiller & digis, Errors & errors);
+
   int digi2word(  cms_uint32_t detId, const PixelDigi& digi,
                   std::map<int, std::vector<Word32> > & words) const;
   int digi2wordPhase1Layer1(  cms_uint32_t detId, const PixelDigi& digi,
@@ -1,8 +1,11 @@
 #include "FWCore/PluginManager/interface/ModuleDef.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/ModuleFactory.h"
 
 #include "SiPixelRawToDigi.h"
 #include "SiPixelDigiToRaw.h"
+#include "SiPixelFedCablingTableESProducer.h"
 
 DEFINE_FWK_MODULE(SiPixelDigiToRaw);
 DEFINE_FWK_MODULE(SiPixelRawToDigi);
+DEFINE_FWK_EVENTSETUP_MODULE(SiPixelFedCablingTableESProducer);
@@ -0,0 +1,25 @@
+#include "SiPixelFedCablingTableESProducer.h"
+
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingMap.h"
+
+SiPixelFedCablingTableESProducer::SiPixelFedCablingTableESProducer(const edm::ParameterSet& iConfig)
+  : cablingMapLabel_(iConfig.getParameter<std::string>("CablingMapLabel"))
+{
+  // the table is labelled as the map it is derived from
+  setWhatProduced(this, cablingMapLabel_);
+}
+
+void SiPixelFedCablingTableESProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<std::string>("CablingMapLabel","")->setComment("CablingMap label");
+  descriptions.add("siPixelFedCablingTableESProducer", desc);
+}
+
+std::unique_ptr<SiPixelFedCablingTable> SiPixelFedCablingTableESProducer::produce(const SiPixelFedCablingMapRcd& iRecord) {
+  edm::ESHandle<SiPixelFedCablingMap> cablingMap;
+  iRecord.get(cablingMapLabel_, cablingMap);
+  return std::make_unique<SiPixelFedCablingTable>(cablingMap->cablingTree());
+}
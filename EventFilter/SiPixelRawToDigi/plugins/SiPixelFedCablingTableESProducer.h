@@ -0,0 +1,33 @@
+#ifndef SiPixelFedCablingTableESProducer_H
+#define SiPixelFedCablingTableESProducer_H
+
+/** \class SiPixelFedCablingTableESProducer
+ *  Derives the dense SiPixelFedCablingTable from the SiPixelFedCablingMap,
+ *  once per IOV and for all the streams.
+ */
+
+#include "FWCore/Framework/interface/ESProducer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "CondFormats/DataRecord/interface/SiPixelFedCablingMapRcd.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingTable.h"
+
+#include <memory>
+#include <string>
+
+namespace edm {
+  class ConfigurationDescriptions;
+}
+
+class SiPixelFedCablingTableESProducer : public edm::ESProducer {
+public:
+  explicit SiPixelFedCablingTableESProducer(const edm::ParameterSet& iConfig);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  std::unique_ptr<SiPixelFedCablingTable> produce(const SiPixelFedCablingMapRcd& iRecord);
+
+private:
+  std::string cablingMapLabel_;
+};
+
+#endif
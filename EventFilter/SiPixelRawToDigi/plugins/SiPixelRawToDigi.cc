@@ -5,6 +5,7 @@
 // 20-10-2010 Andrew York (Tennessee)
 // Jan 2016 Tamas Almos Vami (Tav) (Wigner RCP) -- Cabling Map label option
 // Jul 2017 Viktor Veszpremi -- added PixelFEDChannel
+// Dense cabling table and concurrent unpacking of the FEDs (both optional)
 
 #include "SiPixelRawToDigi.h"
 
@@ -28,6 +29,7 @@
 #include "DataFormats/DetId/interface/DetIdCollection.h"
 #include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingMap.h"
 #include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingTree.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingTable.h"
 #include "EventFilter/SiPixelRawToDigi/interface/PixelDataFormatter.h"
 
 #include "CondFormats/SiPixelObjects/interface/SiPixelQuality.h"
@@ -39,11 +41,17 @@
 #include "TH1D.h"
 #include "TFile.h"
 
+#include "tbb/parallel_for.h"
+
+#include <atomic>
+
 using namespace std;
 
 // -----------------------------------------------------------------------------
 SiPixelRawToDigi::SiPixelRawToDigi( const edm::ParameterSet& conf ) 
   : config_(conf), 
+    cablingTree_(nullptr),
+    cablingTable_(nullptr),
     badPixelInfo_(nullptr),
     regions_(nullptr),
     hCPU(nullptr), hDigi(nullptr)
@@ -104,6 +112,18 @@ SiPixelRawToDigi::SiPixelRawToDigi( const edm::ParameterSet& conf )
   //CablingMap could have a label //Tav
   cablingMapLabel = config_.getParameter<std::string> ("CablingMapLabel");
 
+  // Look up the ROCs in the dense table of the SiPixelFedCablingTableESProducer
+  useCablingTable = false;
+  if (config_.exists("UseCablingTable")) {
+    useCablingTable = config_.getParameter<bool> ("UseCablingTable");
+  }
+
+  // Unpack the FEDs of an event concurrently
+  parallelUnpacking = false;
+  if (config_.exists("ParallelFEDUnpacking")) {
+    parallelUnpacking = config_.getParameter<bool> ("ParallelFEDUnpacking");
+  }
+
 }
 
 
@@ -151,6 +171,8 @@ SiPixelRawToDigi::fillDescriptions(edm::ConfigurationDescriptions& descriptions)
   desc.add<bool>("UsePilotBlade",false)->setComment("##  Use pilot blades");
   desc.add<bool>("UsePhase1",false)->setComment("##  Use phase1");
   desc.add<std::string>("CablingMapLabel","")->setComment("CablingMap label"); //Tav
+  desc.add<bool>("UseCablingTable",false)->setComment("##  Use the SiPixelFedCablingTable (SiPixelFedCablingTableESProducer) for the ROC lookup");
+  desc.add<bool>("ParallelFEDUnpacking",false)->setComment("##  Unpack the FEDs of an event concurrently");
   desc.addOptional<bool>("CheckPixelOrder");  // never used, kept for back-compatibility
   descriptions.add("siPixelRawToDigi",desc);
 }
@@ -171,8 +193,17 @@ void SiPixelRawToDigi::produce( edm::Event& ev,
     edm::ESTransientHandle<SiPixelFedCablingMap> cablingMap;
     es.get<SiPixelFedCablingMapRcd>().get( cablingMapLabel, cablingMap ); //Tav
     fedIds   = cablingMap->fedIds();
-    cabling_ = cablingMap->cablingTree();
-    LogDebug("map version:")<< cabling_->version();
+    if (useCablingTable) {
+      // the table and the tree it owns are shared by all the streams
+      edm::ESHandle<SiPixelFedCablingTable> cablingTable;
+      es.get<SiPixelFedCablingMapRcd>().get( cablingMapLabel, cablingTable );
+      cablingTable_ = cablingTable.product();
+      cablingTree_ = &cablingTable_->cablingTree();
+    } else {
+      cabling_ = cablingMap->cablingTree();
+      cablingTree_ = cabling_.get();
+    }
+    LogDebug("map version:")<< cablingTree_->version();
   }
 // initialize quality record or update if necessary
   if (qualityWatcher.check( es )&&useQuality) {
@@ -197,9 +228,10 @@ void SiPixelRawToDigi::produce( edm::Event& ev,
   auto disabled_channelcollection = std::make_unique<edmNew::DetSetVector<PixelFEDChannel> >();
 
   //PixelDataFormatter formatter(cabling_.get()); // phase 0 only
-  PixelDataFormatter formatter(cabling_.get(), usePhase1); // for phase 1 & 0
+  PixelDataFormatter formatter(cablingTree_, usePhase1); // for phase 1 & 0
 
   formatter.setErrorStatus(includeErrors);
+  formatter.setCablingTable(cablingTable_);
 
   if (useQuality) formatter.setQualityStatus(useQuality, badPixelInfo_);
 
@@ -214,6 +246,8 @@ void SiPixelRawToDigi::produce( edm::Event& ev,
     LogDebug("SiPixelRawToDigi") << "region2unpack #modules (BPIX,EPIX,total): "<<regions_->nBarrelModules()<<" "<<regions_->nForwardModules()<<" "<<regions_->nModules();
   }
 
+  std::vector<int> fedsToUnpack;
+  fedsToUnpack.reserve(fedIds.size());
   for (auto aFed = fedIds.begin(); aFed != fedIds.end(); ++aFed) {
     int fedId = *aFed;
 
@@ -221,15 +255,50 @@ void SiPixelRawToDigi::produce( edm::Event& ev,
 
     if (regions_ && !regions_->mayUnpackFED(fedId)) continue;
 
+    fedsToUnpack.push_back(fedId);
+  }
+
+  int parallelWords = 0, parallelDigis = 0;
+  if (parallelUnpacking) {
+    // unpack each FED into its own buffer; the buffers are merged in FED order below,
+    // so that the collections are the same as with the sequential unpacking
+    fedDigis_.resize(fedsToUnpack.size());
+    fedErrors_.resize(fedsToUnpack.size());
+    std::atomic<bool> errorsInFeds(false);
+    std::atomic<int> wordsInFeds(0), digisInFeds(0);
+    tbb::parallel_for(size_t(0), fedsToUnpack.size(), [&](size_t iFed) {
+        PixelDataFormatter fedFormatter(formatter);
+        bool errorsInFed = false;
+        fedDigis_[iFed].clear();
+        fedErrors_[iFed].clear();
+        fedFormatter.interpretRawData( errorsInFed, fedsToUnpack[iFed], buffers->FEDData( fedsToUnpack[iFed] ),
+                                       fedDigis_[iFed], fedErrors_[iFed]);
+        if (errorsInFed) errorsInFeds = true;
+        wordsInFeds += fedFormatter.nWords();
+        digisInFeds += fedFormatter.nDigis();
+      });
+    if (errorsInFeds) errorsInEvent = true;
+    parallelWords = wordsInFeds;
+    parallelDigis = digisInFeds;
+  }
+
+  for (unsigned int iFed = 0; iFed < fedsToUnpack.size(); ++iFed) {
+    int fedId = fedsToUnpack[iFed];
+
     if(debug) LogDebug("SiPixelRawToDigi")<< " PRODUCE DIGI FOR FED: " <<  fedId << endl;
 
     PixelDataFormatter::Errors errors;
 
-    //get event data for this fed
-    const FEDRawData& fedRawData = buffers->FEDData( fedId );
+    if (parallelUnpacking) {
+      PixelDataFormatter::fillDigis( fedDigis_[iFed], *collection);
+      errors.swap(fedErrors_[iFed]);
+    } else {
+      //get event data for this fed
+      const FEDRawData& fedRawData = buffers->FEDData( fedId );
 
-    //convert data to digi and strip off errors
-    formatter.interpretRawData( errorsInEvent, fedId, fedRawData, *collection, errors);
+      //convert data to digi and strip off errors
+      formatter.interpretRawData( errorsInEvent, fedId, fedRawData, *collection, errors);
+    }
 
     //pack errors into collection
     if(includeErrors) {
@@ -253,7 +322,7 @@ void SiPixelRawToDigi::produce( edm::Event& ev,
 	    // In the future, we should sort out how the usage of tkerrorlist can be generalized
 	    if (aPixelError.getType()==25) {
 	      assert(aPixelError.getFedId()==fedId);
-	      const sipixelobjects::PixelFEDCabling* fed = cabling_->fed(fedId);
+	      const sipixelobjects::PixelFEDCabling* fed = cablingTree_->fed(fedId);
 	      if (fed) {
 		cms_uint32_t linkId = formatter.linkId(aPixelError.getWord32());
 		const sipixelobjects::PixelFEDLink* link = fed->link(linkId);
@@ -307,12 +376,12 @@ void SiPixelRawToDigi::produce( edm::Event& ev,
   if (theTimer) {
     theTimer->stop();
     LogDebug("SiPixelRawToDigi") << "TIMING IS: (real)" << theTimer->realTime() ;
-    ndigis += formatter.nDigis();
-    nwords += formatter.nWords();
+    ndigis += formatter.nDigis() + parallelDigis;
+    nwords += formatter.nWords() + parallelWords;
     LogDebug("SiPixelRawToDigi") << " (Words/Digis) this ev: "
-         <<formatter.nWords()<<"/"<<formatter.nDigis() << "--- all :"<<nwords<<"/"<<ndigis;
+         <<formatter.nWords() + parallelWords<<"/"<<formatter.nDigis() + parallelDigis << "--- all :"<<nwords<<"/"<<ndigis;
     hCPU->Fill( theTimer->realTime() ); 
-    hDigi->Fill(formatter.nDigis());
+    hDigi->Fill(formatter.nDigis() + parallelDigis);
   }
 
   //send digis and errors back to framework 
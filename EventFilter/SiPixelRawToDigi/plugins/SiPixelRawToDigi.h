@@ -16,8 +16,10 @@
 #include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
 #include "FWCore/Framework/interface/ConsumesCollector.h"
 #include "FWCore/Utilities/interface/CPUTimer.h"
+#include "EventFilter/SiPixelRawToDigi/interface/PixelDataFormatter.h"
 
 class SiPixelFedCablingTree;
+class SiPixelFedCablingTable;
 class SiPixelFedCabling;
 class SiPixelQuality;
 class TH1D;
@@ -41,6 +43,8 @@ private:
 
   edm::ParameterSet config_;
   std::unique_ptr<SiPixelFedCablingTree> cabling_;
+  const SiPixelFedCablingTree* cablingTree_;
+  const SiPixelFedCablingTable* cablingTable_;
   const SiPixelQuality* badPixelInfo_;
   PixelUnpackingRegions* regions_;
   edm::EDGetTokenT<FEDRawDataCollection> tFEDRawDataCollection; 
@@ -61,5 +65,10 @@ private:
   bool usePilotBlade;
   bool usePhase1;
   std::string cablingMapLabel;
+  bool useCablingTable;
+  bool parallelUnpacking;
+  // per-FED unpacking buffers, reused from event to event
+  std::vector<PixelDataFormatter::DigiBuffer> fedDigis_;
+  std::vector<PixelDataFormatter::Errors> fedErrors_;
 };
 #endif
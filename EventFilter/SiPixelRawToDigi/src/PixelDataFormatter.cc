@@ -1,6 +1,7 @@
 #include "EventFilter/SiPixelRawToDigi/interface/PixelDataFormatter.h"
 
 #include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingTree.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingTable.h"
 #include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingMap.h"
 #include "CondFormats/SiPixelObjects/interface/SiPixelFrameConverter.h"
 
@@ -16,6 +17,7 @@
 #include "FWCore/Utilities/interface/Exception.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include <algorithm>
 #include <bitset>
 #include <sstream>
 #include <iostream>
@@ -52,10 +54,37 @@ namespace {
   // constexpr PixelDataFormatter::Word32 PXID_mask = ~(~PixelDataFormatter::Word32(0) << PXID_bits);
   // constexpr PixelDataFormatter::Word32 ADC_mask  = ~(~PixelDataFormatter::Word32(0) << ADC_bits);
   //const bool DANEK = false;
+
+  // unpacked digis go directly to the DetSetVector
+  class CollectionFiller {
+  public:
+    CollectionFiller(PixelDataFormatter::Collection & digis) : theDigis(digis) {}
+    void setModule(cms_uint32_t rawId) {
+      theDetDigis = &theDigis.find_or_insert(rawId);
+      if ( (*theDetDigis).empty() ) (*theDetDigis).data.reserve(32); // avoid the first relocations
+    }
+    void add(int row, int col, int adc) {
+      (*theDetDigis).data.emplace_back(row, col, adc);
+      LogTrace("") << (*theDetDigis).data.back();
+    }
+  private:
+    PixelDataFormatter::Collection & theDigis;
+    edm::DetSet<PixelDigi> * theDetDigis = nullptr;
+  };
+
+  // unpacked digis are buffered, with the modules they belong to
+  class BufferFiller {
+  public:
+    BufferFiller(PixelDataFormatter::DigiBuffer & digis) : theDigis(digis) {}
+    void setModule(cms_uint32_t rawId) { theDigis.modules.emplace_back(rawId, theDigis.digis.size()); }
+    void add(int row, int col, int adc) { theDigis.digis.emplace_back(row, col, adc); }
+  private:
+    PixelDataFormatter::DigiBuffer & theDigis;
+  };
 }
 
 PixelDataFormatter::PixelDataFormatter( const SiPixelFedCabling* map, bool phase)
-  : theDigiCounter(0), theWordCounter(0), theCablingTree(map), badPixelInfo(nullptr), modulesToUnpack(nullptr), phase1(phase)
+  : theDigiCounter(0), theWordCounter(0), theCablingTree(map), theCablingTable(nullptr), badPixelInfo(nullptr), modulesToUnpack(nullptr), phase1(phase)
 {
   int s32 = sizeof(Word32);
   int s64 = sizeof(Word64);
@@ -124,7 +153,38 @@ void PixelDataFormatter::passFrameReverter(const SiPixelFrameReverter* reverter)
   theFrameReverter = reverter;
 }
 
+void PixelDataFormatter::setCablingTable(const SiPixelFedCablingTable* table)
+{
+  theCablingTable = table;
+}
+
 void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const FEDRawData& rawData, Collection & digis, Errors& errors)
+{
+  CollectionFiller filler(digis);
+  unpack(errorsInEvent, fedId, rawData, filler, errors);
+}
+
+void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const FEDRawData& rawData, DigiBuffer & digis, Errors& errors)
+{
+  // at most one digi per data word
+  digis.digis.reserve(digis.digis.size() + rawData.size()/sizeof(Word32));
+  BufferFiller filler(digis);
+  unpack(errorsInEvent, fedId, rawData, filler, errors);
+}
+
+void PixelDataFormatter::fillDigis(const DigiBuffer & buffer, Collection & digis)
+{
+  for (unsigned int i = 0; i < buffer.modules.size(); ++i) {
+    auto first = buffer.digis.begin() + buffer.modules[i].second;
+    auto last = (i+1 < buffer.modules.size()) ? buffer.digis.begin() + buffer.modules[i+1].second : buffer.digis.end();
+    edm::DetSet<PixelDigi> & detDigis = digis.find_or_insert(buffer.modules[i].first);
+    if ( detDigis.empty() ) detDigis.data.reserve(std::max<long>(32, last-first)); // avoid the first relocations
+    detDigis.data.insert(detDigis.data.end(), first, last);
+  }
+}
+
+template<typename DigiFiller>
+void PixelDataFormatter::unpack(bool& errorsInEvent, int fedId, const FEDRawData& rawData, DigiFiller & digis, Errors& errors)
 {
   using namespace sipixelobjects;
 
@@ -166,7 +226,6 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
   int layer = 0;
   PixelROC const * rocp=nullptr;
   bool skipROC=false;
-  edm::DetSet<PixelDigi> * detDigis=nullptr;
 
   const  Word32 * bw =(const  Word32 *)(header+1);
   const  Word32 * ew =(const  Word32 *)(trailer);
@@ -185,7 +244,8 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
       link = nlink; roc=nroc;
       skipROC = likely(roc<maxROCIndex) ? false : !errorcheck.checkROC(errorsInEvent, fedId, &converter, theCablingTree, ww, errors);
       if (skipROC) continue;
-      rocp = converter.toRoc(link,roc);
+      rocp = theCablingTable ? theCablingTable->roc(fedId,link,roc) : nullptr;
+      if (!rocp) rocp = converter.toRoc(link,roc);
       if unlikely(!rocp) {
 	errorsInEvent = true;
 	errorcheck.conversionError(fedId, &converter, 2, ww, errors);
@@ -208,15 +268,14 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
       skipROC= modulesToUnpack && ( modulesToUnpack->find(rawId) == modulesToUnpack->end());
       if (skipROC) continue;
       
-      detDigis = &digis.find_or_insert(rawId);
-      if ( (*detDigis).empty() ) (*detDigis).data.reserve(32); // avoid the first relocations
+      digis.setModule(rawId);
     }
 
     // skip is roc to be skipped ot invalid
     if unlikely(skipROC || !rocp) continue;
     
     int adc  = (ww >> ADC_shift) & ADC_mask;
-    std::unique_ptr<LocalPixel> local;
+    GlobalPixel global;
 
     if(phase1 && layer==1) { // special case for layer 1ROC
       // for l1 roc use the roc column and row index instead of dcol and pixel index.
@@ -234,7 +293,7 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
 	  errorcheck.conversionError(fedId, &converter, 3, ww, errors);
 	  continue;
 	}
-      local = std::make_unique<LocalPixel>(localCR); // local pixel coordinate 
+      global = rocp->toGlobal( LocalPixel(localCR) ); // global pixel coordinate (in module)
       //if(DANEK) cout<<local->dcol()<<" "<<local->pxid()<<" "<<local->rocCol()<<" "<<local->rocRow()<<endl;
 
     } else { // phase0 and phase1 except bpix layer 1
@@ -253,14 +312,12 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
 	  errorcheck.conversionError(fedId, &converter, 3, ww, errors);
 	  continue;
 	}
-      local = std::make_unique<LocalPixel>(localDP); // local pixel coordinate 
+      global = rocp->toGlobal( LocalPixel(localDP) ); // global pixel coordinate (in module)
       //if(DANEK) cout<<local->dcol()<<" "<<local->pxid()<<" "<<local->rocCol()<<" "<<local->rocRow()<<endl;
     }    
 
-    GlobalPixel global = rocp->toGlobal( *local ); // global pixel coordinate (in module)
-    (*detDigis).data.emplace_back(global.row, global.col, adc);
+    digis.add(global.row, global.col, adc);
     //if(DANEK) cout<<global.row<<" "<<global.col<<" "<<adc<<endl;    
-    LogTrace("") << (*detDigis).data.back();
   }
 
 }
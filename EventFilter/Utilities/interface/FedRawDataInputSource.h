@@ -1,6 +1,7 @@
 #ifndef EventFilter_Utilities_FedRawDataInputSource_h
 #define EventFilter_Utilities_FedRawDataInputSource_h
 
+#include <algorithm>
 #include <memory>
 #include <cstdio>
 #include <mutex>
@@ -72,6 +73,11 @@ private:
   //functions for single buffered reader
   void readNextChunkIntoBuffer(InputFile *file);
 
+  //chunk references held by FEDRawData views
+  std::shared_ptr<const void> chunkReference(InputChunk *chunk);
+  void releaseChunk(InputChunk *chunk);
+  void freeChunk(InputChunk *chunk);
+
   //monitoring
   void reportEventsThisLumiInSource(unsigned int lumi,unsigned int events);
 
@@ -97,6 +103,8 @@ private:
   const bool verifyAdler32_;
   const bool verifyChecksum_;
   const bool useL1EventID_;
+  bool useFEDRawDataViews_;
+  unsigned int maxChunksInViews_;
   std::vector<std::string> fileNames_;
   //std::vector<std::string> fileNamesSorted_;
 
@@ -174,6 +182,11 @@ private:
   int fileDescriptor_ = -1;
   uint32_t bufferInputRead_ = 0;
 
+  //events crossing a chunk boundary are assembled here when FEDRawData views are used
+  std::unique_ptr<unsigned char[]> eventAssemblyBuffer_;
+  //chunks kept from the reader by FEDRawData views of events still in processing
+  std::atomic<unsigned int> chunksInViews_ {0};
+
   std::atomic<bool> threadInit_;
 
   std::map<unsigned int,unsigned int> sourceEventsReport_;
@@ -190,6 +203,15 @@ struct InputChunk {
   unsigned int offset_;
   unsigned int fileIndex_;
   std::atomic<bool> readComplete_;
+  //source reference, the chunk is freed when it and all the FEDRawData views are released
+  std::shared_ptr<InputChunk> holder_;
+
+  //events fully contained in the chunk (offset in the chunk, checksum verified),
+  //indexed by the reader threads. The source still walks the events itself and
+  //only looks up here whether it can skip the checksum.
+  enum IndexState {notIndexed, indexing, indexed};
+  std::atomic<int> indexState_;
+  std::vector<std::pair<uint32_t,bool>> events_;
 
   InputChunk(unsigned int index, uint32_t size): size_(size),index_(index) {
     buf_ = new unsigned char[size_];
@@ -200,6 +222,14 @@ struct InputChunk {
     usedSize_=toRead;
     fileIndex_=fileIndex;
     readComplete_=false;
+    indexState_=notIndexed;
+  }
+
+  //true if the reader threads have verified the checksum of the event at offset
+  bool checksumVerified(uint32_t offset) const {
+    if (indexState_.load(std::memory_order_acquire)!=indexed) return false;
+    auto it = std::lower_bound(events_.begin(),events_.end(),std::make_pair(offset,false));
+    return it!=events_.end() && it->first==offset && it->second;
   }
 
   ~InputChunk() {delete[] buf_;}
@@ -222,6 +252,15 @@ struct InputFile {
   uint32_t  chunkPosition_ = 0;
   unsigned int currentChunk_ = 0;
 
+  //indexing of the events by the reader threads, in chunk order.
+  //nIndexing_ counts the reader threads which have read a chunk and not finished
+  //indexChunks; indexDone_ is notified when a chunk or a reader thread is done
+  std::mutex indexLock_;
+  std::condition_variable indexDone_;
+  unsigned int nextChunkToIndex_ = 0;
+  uint32_t nextEventPosition_ = 0;
+  std::atomic<unsigned int> nIndexing_ {0};
+
   InputFile(evf::EvFDaqDirector::FileStatus status, unsigned int lumi = 0, std::string const& name = std::string(),
       uint32_t fileSize =0, uint32_t nChunks=0, int nEvents=0, FedRawDataInputSource *parent = nullptr):
     parent_(parent),
@@ -244,6 +283,10 @@ struct InputFile {
     return chunks_[chunkid]!=nullptr && chunks_[chunkid]->readComplete_;
   }
   bool advance(unsigned char* & dataPosition, const size_t size);
+  //indexes the chunks read so far and verifies the checksums of their events,
+  //called by a reader thread after incrementing nIndexing_, which it decrements
+  void indexChunks(uint32 version, uint32_t maxEventSize, bool verifyChecksum, bool verifyAdler32);
+  void waitIndexingDone();
   void moveToPreviousChunk(const size_t size, const size_t offset);
   void rewindChunk(const size_t size);
 };
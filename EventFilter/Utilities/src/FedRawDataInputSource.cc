@@ -21,6 +21,7 @@
 #include "DataFormats/FEDRawData/interface/FEDHeader.h"
 #include "DataFormats/FEDRawData/interface/FEDTrailer.h"
 #include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataStreamer.h"
 
 #include "DataFormats/TCDS/interface/TCDSRaw.h"
 
@@ -65,6 +66,8 @@ FedRawDataInputSource::FedRawDataInputSource(edm::ParameterSet const& pset,
   verifyAdler32_(pset.getUntrackedParameter<bool> ("verifyAdler32", true)),
   verifyChecksum_(pset.getUntrackedParameter<bool> ("verifyChecksum", true)),
   useL1EventID_(pset.getUntrackedParameter<bool> ("useL1EventID", false)),
+  useFEDRawDataViews_(pset.getUntrackedParameter<bool> ("useFEDRawDataViews", false)),
+  maxChunksInViews_(pset.getUntrackedParameter<unsigned int> ("maxChunksInViews", 0)),
   fileNames_(pset.getUntrackedParameter<std::vector<std::string>> ("fileNames",std::vector<std::string>())),
   fileListMode_(pset.getUntrackedParameter<bool> ("fileListMode", false)),
   fileListLoopMode_(pset.getUntrackedParameter<bool> ("fileListLoopMode", false)),
@@ -130,6 +133,21 @@ FedRawDataInputSource::FedRawDataInputSource(edm::ParameterSet const& pset,
   singleBufferMode_ = !(numBuffers_>1);
   readingFilesCount_=0;
 
+  if (useFEDRawDataViews_) {
+    if (singleBufferMode_) {
+      //the single buffer is overwritten while events are still in processing
+      edm::LogWarning("FedRawDataInputSource") << "FEDRawData views are not supported with a single buffer, FED data will be copied";
+      useFEDRawDataViews_ = false;
+    }
+    else {
+      eventAssemblyBuffer_.reset(new unsigned char[eventChunkSize_]);
+      //by default, views keep at most half of the buffers from the reader
+      if (!maxChunksInViews_) maxChunksInViews_ = std::max(1U, numBuffers_/2);
+      //views are written out as owned FEDRawData
+      setFEDRawDataStreamerInTClass();
+    }
+  }
+
   if (!crc32c_hw_test())
     edm::LogError("FedRawDataInputSource::FedRawDataInputSource") << "Intel crc32c checksum computation unavailable";
 
@@ -227,6 +245,8 @@ void FedRawDataInputSource::fillDescriptions(edm::ConfigurationDescriptions& des
   desc.addUntracked<bool> ("verifyAdler32", true)->setComment("Verify event Adler32 checksum with FRDv3 or v4");
   desc.addUntracked<bool> ("verifyChecksum", true)->setComment("Verify event CRC-32C checksum of FRDv5 or higher");
   desc.addUntracked<bool> ("useL1EventID", false)->setComment("Use L1 event ID from FED header if true or from TCDS FED if false");
+  desc.addUntracked<bool> ("useFEDRawDataViews", false)->setComment("Reference FED data in the input buffers instead of copying it (requires numBuffers > 1). FEDRawDataCollection written out is then a copy");
+  desc.addUntracked<unsigned int> ("maxChunksInViews", 0)->setComment("With useFEDRawDataViews, maximum number of buffers kept by events still being processed; FED data of further events is copied (0: half of numBuffers)");
   desc.addUntracked<bool> ("fileListMode", false)->setComment("Use fileNames parameter to directly specify raw files to open");
   desc.addUntracked<std::vector<std::string>> ("fileNames", std::vector<std::string>())->setComment("file list used when fileListMode is enabled");
   desc.setAllowAnything();
@@ -447,7 +467,9 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
   if (currentFile_->bufferPosition_==currentFile_->fileSize_) {
     readingFilesCount_--;
     //release last chunk (it is never released elsewhere)
-    freeChunks_.push(currentFile_->chunks_[currentFile_->currentChunk_]);
+    releaseChunk(currentFile_->chunks_[currentFile_->currentChunk_]);
+    //reader threads may still be indexing the file
+    currentFile_->waitIndexingDone();
     if (currentFile_->nEvents_>=0 && currentFile_->nEvents_!=int(currentFile_->nProcessed_))
     {
       throw cms::Exception("FedRawDataInputSource::getNextEvent")
@@ -456,11 +478,6 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
 	<< " but according to BU JSON there should be "
 	<< currentFile_->nEvents_ << " events";
     }
-    //try to wake up supervisor thread which might be sleeping waiting for the free chunk
-    if (singleBufferMode_) {
-      std::unique_lock<std::mutex> lkw(mWakeup_);
-      cvWakeup_.notify_one();
-    }
     bufferInputRead_=0;
     if (!daqDirector_->isSingleStreamThread() && !fileListMode_) {
       //put the file in pending delete list;
@@ -483,6 +500,7 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
     throw cms::Exception("FedRawDataInputSource::getNextEvent") <<
       "Premature end of input file while reading event header";
   }
+  bool checksumVerified = false;
   if (singleBufferMode_) {
 
     //should already be there
@@ -558,6 +576,8 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
     //check if header is at the boundary of two chunks
     chunkIsFree_ = false;
     unsigned char *dataPosition;
+    InputChunk *eventChunk = currentFile_->chunks_[currentFile_->currentChunk_];
+    const uint32_t eventOffset = currentFile_->chunkPosition_;
 
     //read header, copy it to a single chunk if necessary
     bool chunkEnd = currentFile_->advance(dataPosition,FRDHeaderVersionSize[detectedFRDversion_]);
@@ -600,12 +620,14 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
 	chunkEnd = currentFile_->advance(dataPosition,msgSize);
 	assert(!chunkEnd);
 	chunkIsFree_=false;
+	//the checksum may already be verified by the reader threads
+	checksumVerified = eventChunk->checksumVerified(eventOffset);
       }
     }
   }//end multibuffer mode
   if (fms_) fms_->setInState(evf::FastMonitoringThread::inChecksumEvent);
 
-  if (verifyChecksum_ && event_->version() >= 5)
+  if (verifyChecksum_ && event_->version() >= 5 && !checksumVerified)
   {
     uint32_t crc=0;
     crc = crc32c(crc,(const unsigned char*)event_->payload(),event_->eventSize());
@@ -616,7 +638,7 @@ inline evf::EvFDaqDirector::FileStatus FedRawDataInputSource::getNextEvent()
         " but calculated 0x" << crc;
     }
   }
-  else if ( verifyAdler32_ && event_->version() >= 3)
+  else if ( verifyAdler32_ && event_->version() >= 3 && !checksumVerified)
   {
     uint32_t adler = adler32(0L,Z_NULL,0);
     adler = adler32(adler,(Bytef*)event_->payload(),event_->eventSize());
@@ -738,7 +760,7 @@ void FedRawDataInputSource::read(edm::EventPrincipal& eventPrincipal)
     }
 
   }
-  if (chunkIsFree_) freeChunks_.push(currentFile_->chunks_[currentFile_->currentChunk_-1]);
+  if (chunkIsFree_) releaseChunk(currentFile_->chunks_[currentFile_->currentChunk_-1]);
   chunkIsFree_=false;
   if (fms_) fms_->setInState(evf::FastMonitoringThread::inNoRequest);
   return;
@@ -757,6 +779,14 @@ edm::Timestamp FedRawDataInputSource::fillFEDRawDataCollection(FEDRawDataCollect
   unsigned char* event = (unsigned char*)event_->payload();
   GTPEventID_=0;
   tcds_pointer_ = nullptr;
+
+  //events copied at a chunk boundary are in the assembly buffer, which is reused.
+  //A view keeps its whole chunk from the reader until the event is deleted,
+  //so the FED data is copied when too many chunks are kept by events.
+  std::shared_ptr<const void> chunkRef;
+  if (useFEDRawDataViews_ && !chunkIsFree_)
+    chunkRef = chunkReference(currentFile_->chunks_[currentFile_->currentChunk_]);
+
   while (eventSize > 0) {
     assert(eventSize>=FEDTrailer::length);
     eventSize -= FEDTrailer::length;
@@ -790,14 +820,58 @@ edm::Timestamp FedRawDataInputSource::fillFEDRawDataCollection(FEDRawDataCollect
       }
     }
     FEDRawData& fedData = rawData.FEDData(fedId);
-    fedData.resize(fedSize);
-    memcpy(fedData.data(), event + eventSize, fedSize);
+    if (chunkRef)
+      fedData.setView(event + eventSize, fedSize, chunkRef);
+    else {
+      fedData.resize(fedSize);
+      memcpy(fedData.data(), event + eventSize, fedSize);
+    }
   }
   assert(eventSize == 0);
 
   return tstamp;
 }
 
+std::shared_ptr<const void> FedRawDataInputSource::chunkReference(InputChunk *chunk)
+{
+  if (!chunk->holder_) {
+    //only this thread makes holders, the count is decreased by the last event using one
+    if (chunksInViews_ >= maxChunksInViews_) return std::shared_ptr<const void>();
+    chunksInViews_++;
+    chunk->holder_ = std::shared_ptr<InputChunk>(chunk, [this](InputChunk *ch) {
+      chunksInViews_--;
+      freeChunk(ch);
+    });
+  }
+  return chunk->holder_;
+}
+
+void FedRawDataInputSource::releaseChunk(InputChunk *chunk)
+{
+  {
+    //consumed chunks are not indexed any more, the next event is at the current position
+    std::unique_lock<std::mutex> lk(currentFile_->indexLock_);
+    if (currentFile_->nextChunkToIndex_ <= chunk->fileIndex_) {
+      currentFile_->nextChunkToIndex_ = chunk->fileIndex_+1;
+      currentFile_->nextEventPosition_ = currentFile_->bufferPosition_;
+    }
+    //a reader thread may still be verifying the checksums of the chunk
+    currentFile_->indexDone_.wait(lk, [chunk] {return chunk->indexState_!=InputChunk::indexing;});
+  }
+
+  //if views were made, the chunk is freed by the last event using it
+  if (chunk->holder_) chunk->holder_.reset();
+  else freeChunk(chunk);
+}
+
+void FedRawDataInputSource::freeChunk(InputChunk *chunk)
+{
+  freeChunks_.push(chunk);
+  //wake up the supervisor thread which might be sleeping waiting for the free chunk
+  std::unique_lock<std::mutex> lkw(mWakeup_);
+  cvWakeup_.notify_one();
+}
+
 int FedRawDataInputSource::grabNextJsonFile(boost::filesystem::path const& jsonSourcePath)
 {
   std::string data;
@@ -1258,9 +1332,12 @@ void FedRawDataInputSource::readWorker(unsigned int tid)
 
     if (detectedFRDversion_==0 && chunk->offset_==0) detectedFRDversion_=*((uint32*)chunk->buf_);
     assert(detectedFRDversion_<=5);
+    file->nIndexing_++;
     chunk->readComplete_=true;//this is atomic to secure the sequential buffer fill before becoming available for processing)
     file->chunks_[chunk->fileIndex_]=chunk;//put the completed chunk in the file chunk vector at predetermined index
 
+    //find the events in the chunks read so far and verify their checksums
+    file->indexChunks(detectedFRDversion_, eventChunkSize_, verifyChecksum_, verifyAdler32_);
   }
 }
 
@@ -1272,6 +1349,84 @@ void FedRawDataInputSource::threadError()
 }
 
 
+namespace {
+  bool checksumIsValid(const FRDEventMsgView& event, bool verifyChecksum, bool verifyAdler32)
+  {
+    if (verifyChecksum && event.version() >= 5)
+      return crc32c(0,(const unsigned char*)event.payload(),event.eventSize()) == event.crc32c();
+    if (verifyAdler32 && event.version() >= 3)
+      return adler32(adler32(0L,Z_NULL,0),(Bytef*)event.payload(),event.eventSize()) == event.adler32();
+    return true;
+  }
+}
+
+void InputFile::indexChunks(uint32 version, uint32_t maxEventSize, bool verifyChecksum, bool verifyAdler32)
+{
+  std::vector<InputChunk*> indexedChunks;
+  //event sizes are only known from the version 3 header
+  if (version >= 3) {
+    const uint32_t headerSize = FRDHeaderVersionSize[version];
+    std::unique_lock<std::mutex> lk(indexLock_);
+    while (nextChunkToIndex_ < nChunks_ && waitForChunk(nextChunkToIndex_)) {
+      InputChunk *chunk = chunks_[nextChunkToIndex_];
+      uint32_t position = nextEventPosition_ - chunk->offset_;
+      std::vector<std::pair<uint32_t,bool>> events;
+      bool corrupted = false;
+
+      while (position + headerSize <= chunk->usedSize_) {
+        FRDEventMsgView event(chunk->buf_ + position);
+        if (event.size() < headerSize || event.size() > maxEventSize) {corrupted = true; break;}
+        if (position + event.size() > chunk->usedSize_) break;
+        events.emplace_back(position,false);
+        position += event.size();
+      }
+      //leave it to the source to report corrupted events
+      if (corrupted) break;
+
+      //the size of the event crossing into the next chunk gives the position of the next event
+      uint32_t nextEventPosition = chunk->offset_ + position;
+      if (position < chunk->usedSize_) {
+        if (position + headerSize <= chunk->usedSize_)
+          nextEventPosition += FRDEventMsgView(chunk->buf_ + position).size();
+        else {
+          //header is split, retry when the next chunk is read
+          if (nextChunkToIndex_+1 >= nChunks_ || !waitForChunk(nextChunkToIndex_+1)) break;
+          std::vector<unsigned char> header(headerSize);
+          const uint32_t headerLeft = chunk->usedSize_ - position;
+          memcpy(&header[0], chunk->buf_ + position, headerLeft);
+          memcpy(&header[headerLeft], chunks_[nextChunkToIndex_+1]->buf_, headerSize - headerLeft);
+          nextEventPosition += FRDEventMsgView(&header[0]).size();
+        }
+      }
+
+      chunk->events_.swap(events);
+      chunk->indexState_ = InputChunk::indexing;
+      indexedChunks.push_back(chunk);
+      nextEventPosition_ = nextEventPosition;
+      nextChunkToIndex_++;
+    }
+  }
+
+  //checksums are verified in parallel, the source waits for them before releasing a chunk
+  for (auto chunk : indexedChunks) {
+    for (auto & event : chunk->events_)
+      event.second = checksumIsValid(FRDEventMsgView(chunk->buf_ + event.first), verifyChecksum, verifyAdler32);
+    std::unique_lock<std::mutex> lk(indexLock_);
+    chunk->indexState_.store(InputChunk::indexed,std::memory_order_release);
+    indexDone_.notify_all();
+  }
+
+  std::unique_lock<std::mutex> lk(indexLock_);
+  nIndexing_--;
+  indexDone_.notify_all();
+}
+
+void InputFile::waitIndexingDone()
+{
+  std::unique_lock<std::mutex> lk(indexLock_);
+  indexDone_.wait(lk, [this] {return nIndexing_==0;});
+}
+
 inline bool InputFile::advance(unsigned char* & dataPosition, const size_t size)
 {
   //wait for chunk
@@ -1290,11 +1445,27 @@ inline bool InputFile::advance(unsigned char* & dataPosition, const size_t size)
       usleep(100000);
       if (parent_->exceptionState()) parent_->threadError();
     }
-    //copy everything to beginning of the first chunk
-    dataPosition-=chunkPosition_;
-    assert(dataPosition==chunks_[currentChunk_]->buf_);
-    memmove(chunks_[currentChunk_]->buf_, chunks_[currentChunk_]->buf_+chunkPosition_, currentLeft);
-    memcpy(chunks_[currentChunk_]->buf_ + currentLeft, chunks_[currentChunk_+1]->buf_, size - currentLeft);
+    if (parent_->useFEDRawDataViews_) {
+      //earlier events may still reference the chunk, assemble the data aside
+      dataPosition = parent_->eventAssemblyBuffer_.get();
+      memcpy(dataPosition, chunks_[currentChunk_]->buf_+chunkPosition_, currentLeft);
+      memcpy(dataPosition + currentLeft, chunks_[currentChunk_+1]->buf_, size - currentLeft);
+    }
+    else {
+      {
+        //the reader threads must not read the chunk while it is overwritten: stop indexing
+        //the file if they have not gone past it, and wait for a checksum pass on it
+        std::unique_lock<std::mutex> lk(indexLock_);
+        if (nextChunkToIndex_ <= currentChunk_) nextChunkToIndex_ = nChunks_;
+        InputChunk *chunk = chunks_[currentChunk_];
+        indexDone_.wait(lk, [chunk] {return chunk->indexState_!=InputChunk::indexing;});
+      }
+      //copy everything to beginning of the first chunk
+      dataPosition-=chunkPosition_;
+      assert(dataPosition==chunks_[currentChunk_]->buf_);
+      memmove(chunks_[currentChunk_]->buf_, chunks_[currentChunk_]->buf_+chunkPosition_, currentLeft);
+      memcpy(chunks_[currentChunk_]->buf_ + currentLeft, chunks_[currentChunk_+1]->buf_, size - currentLeft);
+    }
     //set pointers at the end of the old data position
     bufferPosition_+=size;
     chunkPosition_=size-currentLeft;
@@ -1313,7 +1484,8 @@ inline void InputFile::moveToPreviousChunk(const size_t size, const size_t offse
   //this will fail in case of events that are too large
   assert(size < chunks_[currentChunk_]->size_ - chunkPosition_);
   assert(size - offset < chunks_[currentChunk_]->size_);
-  memcpy(chunks_[currentChunk_-1]->buf_+offset,chunks_[currentChunk_]->buf_+chunkPosition_,size);
+  unsigned char *eventStart = parent_->useFEDRawDataViews_ ? parent_->eventAssemblyBuffer_.get() : chunks_[currentChunk_-1]->buf_;
+  memcpy(eventStart+offset,chunks_[currentChunk_]->buf_+chunkPosition_,size);
   chunkPosition_+=size;
   bufferPosition_+=size;
 }
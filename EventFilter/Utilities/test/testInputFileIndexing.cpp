@@ -0,0 +1,96 @@
+// Indexing of the events of an input file by the reader threads: chunks are
+// completed in any order by concurrent threads, and every event fully
+// contained in a chunk is found with its checksum verified, including after
+// events and headers split over two chunks.
+
+#include "EventFilter/Utilities/interface/FedRawDataInputSource.h"
+#include "EventFilter/Utilities/interface/crc32c.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+  struct Event {
+    uint32_t offset;
+    uint32_t size;
+    bool good;
+  };
+
+  // version 5 events of random sizes, every 7th one with a wrong checksum
+  std::vector<unsigned char> makeFile(unsigned int nEvents, std::vector<Event>& events) {
+    std::mt19937 eng(42);
+    std::uniform_int_distribution<uint32_t> words(0,40);
+    std::vector<unsigned char> file;
+    for (unsigned int i=0; i<nEvents; ++i) {
+      const uint32_t payloadSize = 8*words(eng);
+      std::vector<unsigned char> payload(payloadSize);
+      for (auto& b : payload) b = eng();
+      uint32 header[6] = {5, 1, 1, i, payloadSize, crc32c(0, payload.data(), payloadSize)};
+      const bool good = i%7 != 3;
+      if (!good) header[5] ^= 1;
+      events.push_back({uint32_t(file.size()), uint32_t(sizeof(header)+payloadSize), good});
+      file.insert(file.end(), (unsigned char*)header, (unsigned char*)header + sizeof(header));
+      file.insert(file.end(), payload.begin(), payload.end());
+    }
+    return file;
+  }
+}
+
+int main() {
+  std::vector<Event> events;
+  const std::vector<unsigned char> data = makeFile(500, events);
+
+  // chunks smaller than some events, so that events and headers are split
+  for (uint32_t chunkSize : {100U, 256U, 1000U}) {
+    const uint32_t nChunks = (data.size()+chunkSize-1)/chunkSize;
+    InputFile file(evf::EvFDaqDirector::newFile, 1, "test", data.size(), nChunks, events.size());
+    std::vector<InputChunk*> chunks;
+    for (uint32_t i=0; i<nChunks; ++i) {
+      chunks.push_back(new InputChunk(i, chunkSize));
+      const uint32_t offset = i*chunkSize;
+      const uint32_t size = std::min<uint32_t>(chunkSize, data.size()-offset);
+      chunks.back()->reset(offset, size, i);
+      std::memcpy(chunks.back()->buf_, data.data()+offset, size);
+    }
+
+    // reader threads complete the chunks in a random order
+    std::vector<unsigned int> order(nChunks);
+    for (unsigned int i=0; i<nChunks; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(chunkSize));
+    std::vector<std::thread> readers;
+    for (unsigned int t=0; t<4; ++t) {
+      readers.emplace_back([&, t] {
+        for (unsigned int k=t; k<nChunks; k+=4) {
+          InputChunk* chunk = chunks[order[k]];
+          file.nIndexing_++;
+          chunk->readComplete_ = true;
+          file.chunks_[chunk->fileIndex_] = chunk;
+          file.indexChunks(5, 1 << 20, true, false);
+        }
+      });
+    }
+    for (auto& reader : readers) reader.join();
+    file.waitIndexingDone();
+    assert(file.nextChunkToIndex_ == nChunks);
+
+    unsigned int nVerified = 0;
+    for (auto const& event : events) {
+      InputChunk* chunk = chunks[event.offset/chunkSize];
+      const uint32_t offset = event.offset - chunk->offset_;
+      const bool contained = offset + event.size <= chunk->usedSize_;
+      assert(chunk->checksumVerified(offset) == (contained && event.good));
+      if (contained && event.good) ++nVerified;
+    }
+    assert(nVerified > 0);
+    std::cout << "chunk size " << chunkSize << ": " << nVerified << " of " << events.size()
+              << " events verified by the reader threads" << std::endl;
+
+    for (auto chunk : chunks) delete chunk;
+  }
+  return 0;
+}
@@ -189,10 +189,30 @@ def customiseForEcalTestPR22254thresholdC(process):
 
 
 
+# new parameters of the topological clustering, the union-find mode is off
+def customiseForPFTopoClusterUnionFind(process):
+    for producer in producers_by_type(process, "PFClusterProducer"):
+        step = producer.initialClusteringStep
+        if step.algoName.value() == "Basic2DGenericTopoClusterizer" and not hasattr(step, "useUnionFind"):
+            step.useUnionFind = cms.bool(False)
+            step.recHitSoA = cms.InputTag("")
+    return process
+
+
+# new parameter of the pixel clusterizer, the decoded gain calibration table is not used
+def customiseForPixelGainCalibrationTable(process):
+    for producer in producers_by_type(process, "SiPixelClusterProducer"):
+        if not hasattr(producer, "UseCalibrationTable"):
+            producer.UseCalibrationTable = cms.bool(False)
+    return process
+
+
 # CMSSW version specific customizations
 def customizeHLTforCMSSW(process, menuType="GRun"):
 
     # add call to action function in proper order: newest last!
     # process = customiseFor12718(process)
+    process = customiseForPFTopoClusterUnionFind(process)
+    process = customiseForPixelGainCalibrationTable(process)
 
     return process
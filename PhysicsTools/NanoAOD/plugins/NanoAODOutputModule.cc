@@ -11,6 +11,7 @@
 //
 
 // system include files
+#include <algorithm>
 #include <string>
 #include "TFile.h"
 #include "TTree.h"
@@ -57,6 +58,9 @@ private:
   void openFile(edm::FileBlock const&) override;
   void reallyCloseFile() override;
 
+  /// columnar mode: fill the tree with the events appended so far and write them as one cluster
+  void writeCluster();
+
   std::string m_fileName;
   std::string m_logicalFileName;
   int m_compressionLevel;
@@ -65,6 +69,9 @@ private:
   bool m_writeProvenance;
   bool m_fakeName; //crab workaround, remove after crab is fixed
   int m_autoFlush;
+  int m_columnarClusterSize;
+  int m_eventsInCluster{0};
+  edm::RunNumber_t m_clusterRun{0};
   edm::ProcessHistoryRegistry m_processHistoryRegistry;
   edm::JobReport::Token m_jrToken;
   std::unique_ptr<TFile> m_file;
@@ -82,8 +89,23 @@ private:
          void fill(const edm::EventID & id) { 
             m_run = id.run(); m_luminosityBlock = id.luminosityBlock(); m_event = id.event(); 
          }
+         void append(const edm::EventID & id) { 
+            m_ids.push_back(id);
+         }
+         void fillAppended(TTree &tree) {
+            for (const char * name : {"run", "luminosityBlock", "event"}) {
+               TBranch * branch = tree.GetBranch(name);
+               branch->SetBasketSize(std::max<int>(m_ids.size()*sizeof(ULong64_t), 512));
+               for (const auto & id : m_ids) {
+                  fill(id);
+                  branch->Fill();
+               }
+            }
+            m_ids.clear();
+         }
      private:
          UInt_t m_run; UInt_t m_luminosityBlock; ULong64_t m_event;
+         std::vector<edm::EventID> m_ids;
   } m_commonBranches;
 
   class CommonLumiBranches {
@@ -144,6 +166,7 @@ NanoAODOutputModule::NanoAODOutputModule(edm::ParameterSet const& pset):
   m_writeProvenance(pset.getUntrackedParameter<bool>("saveProvenance", true)),
   m_fakeName(pset.getUntrackedParameter<bool>("fakeNameForCrab", false)),
   m_autoFlush(pset.getUntrackedParameter<int>("autoFlush", -10000000)),
+  m_columnarClusterSize(pset.getUntrackedParameter<int>("columnarClusterSize", 0)),
   m_processHistoryRegistry()
 {
 }
@@ -158,6 +181,22 @@ NanoAODOutputModule::write(edm::EventForOutput const& iEvent) {
   edm::Service<edm::JobReport> jr;
   jr->eventWrittenToFile(m_jrToken, iEvent.id().run(), iEvent.id().event());
 
+  if (m_columnarClusterSize > 0) {
+    // trigger branches may be added at a new run, and are back filled for the events already in the tree
+    if (m_eventsInCluster > 0 && iEvent.id().run() != m_clusterRun) writeCluster();
+    m_clusterRun = iEvent.id().run();
+
+    m_commonBranches.append(iEvent.id());
+    for (unsigned int extensions = 0; extensions <= 1; ++extensions) {
+        for (auto & t : m_tables) t.append(iEvent,*m_tree,extensions);
+    }
+    for (auto & t : m_triggers) t.append(iEvent,*m_tree);
+    if (++m_eventsInCluster == m_columnarClusterSize) writeCluster();
+
+    m_processHistoryRegistry.registerProcessHistory(iEvent.processHistory());
+    return;
+  }
+
   if (m_autoFlush) {
     int64_t events = m_tree->GetEntriesFast();
     if (events == m_firstFlush) {
@@ -203,6 +242,20 @@ NanoAODOutputModule::write(edm::EventForOutput const& iEvent) {
   m_processHistoryRegistry.registerProcessHistory(iEvent.processHistory());
 }
 
+void
+NanoAODOutputModule::writeCluster() {
+  if (m_eventsInCluster == 0) return;
+  // one column after the other: each branch gets all the events of the cluster in one basket
+  m_commonBranches.fillAppended(*m_tree);
+  for (auto & t : m_tables) t.fillAppended();
+  for (auto & t : m_triggers) t.fillAppended();
+  m_tree->SetEntries(m_tree->GetEntries() + m_eventsInCluster);
+  // with ROOT implicit multithreading enabled, the baskets of the different branches are
+  // compressed and written in parallel
+  m_tree->FlushBaskets();
+  m_eventsInCluster = 0;
+}
+
 void 
 NanoAODOutputModule::writeLuminosityBlock(edm::LuminosityBlockForOutput const& iLumi) {
   edm::Service<edm::JobReport> jr;
@@ -316,6 +369,7 @@ NanoAODOutputModule::openFile(edm::FileBlock const&) {
 }
 void 
 NanoAODOutputModule::reallyCloseFile() {
+  if (m_columnarClusterSize > 0) writeCluster();
   if (m_writeProvenance) {
       int basketSize = 16384; // fixme configurable?
       edm::fillParameterSetBranch(m_parameterSetsTree.get(), basketSize);
@@ -356,6 +410,8 @@ NanoAODOutputModule::fillDescriptions(edm::ConfigurationDescriptions& descriptio
         ->setComment("Change the OutputModule name in the fwk job report to fake PoolOutputModule. This is needed to run on cran (and publish) till crab is fixed");
   desc.addUntracked<int>("autoFlush", -10000000)
         ->setComment("Autoflush parameter for ROOT file");
+  desc.addUntracked<int>("columnarClusterSize", 0)
+        ->setComment("If positive, keep this many events in memory and write them column by column as one cluster, with one basket per branch, instead of filling the tree event by event. autoFlush is then ignored");
 
   //replace with whatever you want to get from the EDM by default
   const std::vector<std::string> keep = {"drop *", "keep nanoaodFlatTable_*Table_*_*", "keep edmTriggerResults_*_*_*", "keep nanoaodMergeableCounterTable_*Table_*_*", "keep nanoaodUniqueString_nanoMetadata_*_*"};
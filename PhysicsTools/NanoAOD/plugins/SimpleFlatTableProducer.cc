@@ -7,19 +7,43 @@
 
 #include "CommonTools/Utils/interface/StringCutObjectSelector.h"
 #include "CommonTools/Utils/interface/StringObjectFunction.h"
+#include "CommonTools/Utils/interface/StringExpressionTranslator.h"
+#include "CommonTools/Utils/interface/ExpressionEvaluator.h"
+#include "CommonTools/Utils/interface/ExpressionEvaluatorTemplates.h"
+#include "CommonTools/Utils/interface/expressionParser.h"
+#include "CommonTools/Utils/interface/cutParser.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/TypeDemangler.h"
+#include "FWCore/Utilities/interface/TypeWithDict.h"
 
+#include <typeinfo>
 #include <vector>
 #include <boost/ptr_container/ptr_vector.hpp>
 
+// Compiled mode: the expressions and cuts of a table are translated to C++ and compiled with
+// reco::ExpressionEvaluator once per job, when the module is constructed, and evaluated on whole
+// collections.  They are compiled for compiledType, the concrete type of the objects of the table
+// (e.g. pat::Jet), whose header must be in PhysicsTools/NanoAOD/src/precompile.h; the objects are
+// checked to be of that type before the compiled code is used.  Only expressions that the string
+// parser accepts for compiledType are compiled, all of them in one library; the others, or all of
+// them if the library does not build, go through the string parser as before.
+template<typename T>
+struct SimpleFlatTableCompiled {
+    struct Compiled { const reco::ValuesOnCollection<T> * evaluator; unsigned int index; };
+    std::vector<Compiled> expressions; // empty if not compiled, else one per expression
+    const std::type_info * type = nullptr; // the compiled type
+};
+
 template<typename T, typename TProd>
-class SimpleFlatTableProducerBase : public edm::stream::EDProducer<> {
+class SimpleFlatTableProducerBase : public edm::stream::EDProducer<edm::GlobalCache<SimpleFlatTableCompiled<T>>> {
     public:
+        typedef SimpleFlatTableCompiled<T> Cache;
 
-        SimpleFlatTableProducerBase( edm::ParameterSet const & params ):
+        SimpleFlatTableProducerBase( edm::ParameterSet const & params, const Cache * ):
             name_( params.getParameter<std::string>("name") ),
             doc_(params.existsAs<std::string>("doc") ? params.getParameter<std::string>("doc") : ""),
             extension_(params.existsAs<bool>("extension") ? params.getParameter<bool>("extension") : false),
-            src_(consumes<TProd>( params.getParameter<edm::InputTag>("src") )) 
+            src_(this->template consumes<TProd>( params.getParameter<edm::InputTag>("src") ))
         {
             edm::ParameterSet const & varsPSet = params.getParameter<edm::ParameterSet>("variables");
             for (const std::string & vname : varsPSet.getParameterNamesForType<edm::ParameterSet>()) {
@@ -32,11 +56,20 @@ class SimpleFlatTableProducerBase : public edm::stream::EDProducer<> {
                 else throw cms::Exception("Configuration", "unsupported type "+type+" for variable "+vname);
             }
 
-            produces<nanoaod::FlatTable>();
+            this->template produces<nanoaod::FlatTable>();
         }
 
         ~SimpleFlatTableProducerBase() override {}
 
+        static std::unique_ptr<Cache> initializeGlobalCache(edm::ParameterSet const & params) {
+            auto cache = std::make_unique<Cache>();
+            if (params.existsAs<bool>("compiled") && params.getParameter<bool>("compiled")) {
+                compile(params, *cache);
+            }
+            return cache;
+        }
+        static void globalEndJob(const Cache *) {}
+
         // this is to be overriden by the child class
         virtual std::unique_ptr<nanoaod::FlatTable> fillTable(const edm::Event &iEvent, const edm::Handle<TProd> & prod) const = 0;
 
@@ -57,6 +90,100 @@ class SimpleFlatTableProducerBase : public edm::stream::EDProducer<> {
         const bool extension_;
         const edm::EDGetTokenT<TProd> src_;
 
+        /// the expressions of a table: variables in the order of vars_, then the cut if any
+        static std::vector<std::pair<std::string,bool>> expressions(edm::ParameterSet const & params) {
+            std::vector<std::pair<std::string,bool>> exprs; // expression, is a cut
+            edm::ParameterSet const & varsPSet = params.getParameter<edm::ParameterSet>("variables");
+            for (const std::string & vname : varsPSet.getParameterNamesForType<edm::ParameterSet>()) {
+                const auto & varPSet = varsPSet.getParameter<edm::ParameterSet>(vname);
+                exprs.emplace_back(varPSet.getParameter<std::string>("expr"), varPSet.getParameter<std::string>("type") == "bool");
+            }
+            bool singleton = params.existsAs<bool>("singleton") && params.getParameter<bool>("singleton");
+            if (!singleton && params.existsAs<std::string>("cut")) exprs.emplace_back(params.getParameter<std::string>("cut"), true);
+            return exprs;
+        }
+
+        static void compile(edm::ParameterSet const & params, Cache & cache) {
+            const auto exprs = expressions(params);
+            const std::string name = params.getParameter<std::string>("name");
+            const std::string compiledCache = params.existsAs<std::string>("compiledCache", false) ? params.getUntrackedParameter<std::string>("compiledCache") : "";
+            const std::string tableType = edm::typeDemangle(typeid(T).name());
+            const std::string type = params.existsAs<std::string>("compiledType") ? params.getParameter<std::string>("compiledType") : tableType;
+            const edm::TypeWithDict dict = edm::TypeWithDict::byName(type);
+            if (!dict) throw cms::Exception("Configuration", "no dictionary for compiledType "+type+" of table "+name);
+            const std::string object = type == tableType ? "*p" : "static_cast<" + type + " const &>(*p)";
+
+            reco::StringExpressionTranslator translator("obj");
+            std::string cases;
+            std::vector<unsigned int> translated;
+            for (unsigned int i = 0, n = exprs.size(); i < n; ++i) {
+                const auto & expr = exprs[i];
+                try {
+                    // methods missing in compiledType are found here, without running the compiler
+                    reco::parser::SelectorPtr sel;
+                    reco::parser::ExpressionPtr ex;
+                    if (expr.second ? !reco::parser::cutParser(dict, expr.first, sel, false) : !reco::parser::expressionParser(dict, expr.first, ex, false)) continue;
+                    const std::string code = expr.second ? "(" + translator.cut(expr.first) + ") ? 1. : 0." : translator.expression(expr.first);
+                    cases += "  case " + std::to_string(translated.size()) + ": for (auto p : c) { auto const & obj = " + object + "; *out++ = " + code + "; } break;\n";
+                    translated.push_back(i);
+                } catch (cms::Exception const & e) {
+                    LogDebug("SimpleFlatTableProducer") << e.what();
+                }
+            }
+            if (translated.empty()) return;
+
+            std::string source = translator.helpers();
+            source += "unsigned int size() const override { return " + std::to_string(translated.size()) + "; }\n";
+            source += "void eval(unsigned int i, Collection const & c, double * out) const override {\n  switch (i) {\n" + cases + "  }\n}\n";
+            const std::string base = "reco::ValuesOnCollection<" + tableType + ">";
+            try {
+                std::unique_ptr<reco::ExpressionEvaluator> ee(compiledCache.empty() ?
+                    new reco::ExpressionEvaluator("PhysicsTools/NanoAOD", base.c_str(), source) :
+                    new reco::ExpressionEvaluator("PhysicsTools/NanoAOD", base.c_str(), source, compiledCache));
+                auto evaluator = ee->template expr<reco::ValuesOnCollection<T>>();
+                cache.expressions.assign(exprs.size(), typename Cache::Compiled{nullptr, 0});
+                for (unsigned int k = 0; k < translated.size(); ++k) cache.expressions[translated[k]] = typename Cache::Compiled{evaluator, k};
+                cache.type = &dict.typeInfo();
+            } catch (cms::Exception const & e) {
+                edm::LogWarning("SimpleFlatTableProducer") << "table " << name << ": the expressions do not compile for " << type
+                                                           << ", using the string parser\n" << e.what();
+                return;
+            }
+            edm::LogInfo("SimpleFlatTableProducer") << "table " << name << ": " << translated.size() << " of " << exprs.size()
+                                                    << " expressions compiled for " << type;
+        }
+
+        /// true if expressions were compiled; throws if objs are not of the compiled type
+        bool compiledFor(const std::vector<const T *> & objs) const {
+            const auto * cache = this->globalCache();
+            if (cache->expressions.empty()) return false;
+            for (const T * obj : objs) {
+                if (typeid(*obj) != *cache->type) {
+                    throw cms::Exception("Configuration") << "table " << name_ << " compiled for " << edm::typeDemangle(cache->type->name())
+                                                          << ", but it has an object of type " << edm::typeDemangle(typeid(*obj).name()) << "\n";
+                }
+            }
+            return true;
+        }
+
+        /// evaluate expression i on objs if it was compiled
+        bool evalCompiled(unsigned int i, const std::vector<const T *> & objs, std::vector<double> & vals) const {
+            const auto & compiled = this->globalCache()->expressions;
+            if (compiled[i].evaluator == nullptr) return false;
+            vals.resize(objs.size());
+            compiled[i].evaluator->eval(compiled[i].index, objs, vals.data());
+            return true;
+        }
+
+        void fillVars(const std::vector<const T *> & selobjs, nanoaod::FlatTable & out) const {
+            std::vector<double> vals;
+            const bool compiled = compiledFor(selobjs);
+            for (unsigned int i = 0, n = vars_.size(); i < n; ++i) {
+                if (compiled && evalCompiled(i, selobjs, vals)) vars_[i].fill(vals, out);
+                else vars_[i].fill(selobjs, out);
+            }
+        }
+
         class VariableBase {
             public:
                 VariableBase(const std::string & aname, nanoaod::FlatTable::ColumnType atype, const edm::ParameterSet & cfg) : 
@@ -77,6 +204,8 @@ class SimpleFlatTableProducerBase : public edm::stream::EDProducer<> {
                 Variable(const std::string & aname, nanoaod::FlatTable::ColumnType atype, const edm::ParameterSet & cfg) : 
                     VariableBase(aname, atype, cfg) {}
                 virtual void fill(std::vector<const T *> selobjs, nanoaod::FlatTable & out) const = 0;
+                /// fill from the values of the compiled expression
+                virtual void fill(const std::vector<double> & compiled, nanoaod::FlatTable & out) const = 0;
         };
         template<typename StringFunctor, typename ValType>
             class FuncVariable : public Variable {
@@ -91,6 +220,13 @@ class SimpleFlatTableProducerBase : public edm::stream::EDProducer<> {
                         }
                         out.template addColumn<ValType>(this->name_, vals, this->doc_, this->type_,this->precision_);
                     }
+                    void fill(const std::vector<double> & compiled, nanoaod::FlatTable & out) const override {
+                        std::vector<ValType> vals(compiled.size());
+                        for (unsigned int i = 0, n = vals.size(); i < n; ++i) {
+                            vals[i] = compiled[i];
+                        }
+                        out.template addColumn<ValType>(this->name_, vals, this->doc_, this->type_,this->precision_);
+                    }
                 protected:
                     StringFunctor func_;
 
@@ -107,11 +243,12 @@ class SimpleFlatTableProducer : public SimpleFlatTableProducerBase<T, edm::View<
     public:
         typedef SimpleFlatTableProducerBase<T, edm::View<T>> base;
 
-        SimpleFlatTableProducer( edm::ParameterSet const & params ) :
-            SimpleFlatTableProducerBase<T, edm::View<T>>(params),
+        SimpleFlatTableProducer( edm::ParameterSet const & params, const typename base::Cache * cache ) :
+            SimpleFlatTableProducerBase<T, edm::View<T>>(params, cache),
             singleton_(params.getParameter<bool>("singleton")),
             maxLen_(params.existsAs<unsigned int>("maxLen") ? params.getParameter<unsigned int>("maxLen") : std::numeric_limits<unsigned int>::max()),
-            cut_(!singleton_ ? params.getParameter<std::string>("cut") : "", true) 
+            cut_(!singleton_ ? params.getParameter<std::string>("cut") : "", true),
+            cutIndex_(this->vars_.size())
         {
             if (params.existsAs<edm::ParameterSet>("externalVariables")) {
                 edm::ParameterSet const & extvarsPSet = params.getParameter<edm::ParameterSet>("externalVariables");
@@ -138,9 +275,15 @@ class SimpleFlatTableProducer : public SimpleFlatTableProducerBase<T, edm::View<
                 selobjs.push_back(& (*prod)[0] );
                 if (!extvars_.empty()) selptrs.emplace_back(prod->ptrAt(0));
             } else {
+                std::vector<double> pass;
+                if (!this->globalCache()->expressions.empty()) {
+                    std::vector<const T *> all;
+                    for (const auto & obj : *prod) all.push_back(&obj);
+                    if (!this->compiledFor(all) || !this->evalCompiled(cutIndex_, all, pass)) pass.clear();
+                }
                 for (unsigned int i = 0, n = prod->size(); i < n; ++i) {
                     const auto & obj = (*prod)[i];
-                    if (cut_(obj)) { 
+                    if (pass.empty() ? cut_(obj) : pass[i] != 0) { 
                         selobjs.push_back(&obj); 
                         if (!extvars_.empty()) selptrs.emplace_back(prod->ptrAt(i));
                     }
@@ -148,7 +291,7 @@ class SimpleFlatTableProducer : public SimpleFlatTableProducerBase<T, edm::View<
                 }
             }
             auto out = std::make_unique<nanoaod::FlatTable>(selobjs.size(), this->name_, singleton_, this->extension_);
-            for (const auto & var : this->vars_) var.fill(selobjs, *out);
+            this->fillVars(selobjs, *out);
             for (const auto & var : this->extvars_) var.fill(iEvent, selptrs, *out);
             return out;
         } 
@@ -157,6 +300,7 @@ class SimpleFlatTableProducer : public SimpleFlatTableProducerBase<T, edm::View<
         bool  singleton_;
 	const unsigned int maxLen_;
         const StringCutObjectSelector<T> cut_;
+        const unsigned int cutIndex_;
 
         class ExtVariable : public base::VariableBase {
             public:
@@ -193,15 +337,15 @@ class SimpleFlatTableProducer : public SimpleFlatTableProducerBase<T, edm::View<
 template<typename T>
 class EventSingletonSimpleFlatTableProducer : public SimpleFlatTableProducerBase<T,T> {
     public:
-        EventSingletonSimpleFlatTableProducer( edm::ParameterSet const & params ):
-            SimpleFlatTableProducerBase<T,T>(params) {}
+        EventSingletonSimpleFlatTableProducer( edm::ParameterSet const & params, const SimpleFlatTableCompiled<T> * cache ):
+            SimpleFlatTableProducerBase<T,T>(params, cache) {}
 
         ~EventSingletonSimpleFlatTableProducer() override {}
 
         std::unique_ptr<nanoaod::FlatTable> fillTable(const edm::Event &, const edm::Handle<T> & prod) const override {
             auto out = std::make_unique<nanoaod::FlatTable>(1, this->name_, true, this->extension_);
             std::vector<const T *> selobjs(1, prod.product());
-            for (const auto & var : this->vars_) var.fill(selobjs, *out);
+            this->fillVars(selobjs, *out);
             return out;
         }
 };
@@ -209,15 +353,15 @@ class EventSingletonSimpleFlatTableProducer : public SimpleFlatTableProducerBase
 template<typename T>
 class FirstObjectSimpleFlatTableProducer : public SimpleFlatTableProducerBase<T, edm::View<T>> {
     public:
-        FirstObjectSimpleFlatTableProducer( edm::ParameterSet const & params ):
-          SimpleFlatTableProducerBase<T, edm::View<T>>(params) {}
+        FirstObjectSimpleFlatTableProducer( edm::ParameterSet const & params, const SimpleFlatTableCompiled<T> * cache ):
+          SimpleFlatTableProducerBase<T, edm::View<T>>(params, cache) {}
 
         ~FirstObjectSimpleFlatTableProducer() override {}
 
         std::unique_ptr<nanoaod::FlatTable> fillTable(const edm::Event &iEvent, const edm::Handle<edm::View<T>> & prod) const override {
             auto out = std::make_unique<nanoaod::FlatTable>(1, this->name_, true, this->extension_);
             std::vector<const T *> selobjs(1, & (*prod)[0]);
-            for (const auto & var : this->vars_) var.fill(selobjs, *out);
+            this->fillVars(selobjs, *out);
             return out;
         }
 };
@@ -61,10 +61,10 @@ TableOutputBranches::branch(TTree &tree)
     }
 }
 
-void TableOutputBranches::fill(const edm::EventForOutput &iEvent, TTree & tree, bool extensions) 
+const nanoaod::FlatTable * TableOutputBranches::table(const edm::EventForOutput &iEvent, TTree & tree, bool extensions) 
 {
     if (m_extension != DontKnowYetIfMainOrExtension) {
-        if (extensions != m_extension) return; // do nothing, wait to be called with the proper flag
+        if (extensions != m_extension) return nullptr; // do nothing, wait to be called with the proper flag
     }
 
     edm::Handle<nanoaod::FlatTable> handle;
@@ -74,7 +74,7 @@ void TableOutputBranches::fill(const edm::EventForOutput &iEvent, TTree & tree,
     m_singleton = tab.singleton();
     if(!m_branchesBooked) {
         m_extension = tab.extension() ? IsExtension : IsMain;
-        if (extensions != m_extension) return; // do nothing, wait to be called with the proper flag
+        if (extensions != m_extension) return nullptr; // do nothing, wait to be called with the proper flag
         defineBranchesFromFirstEvent(tab);	
         m_doc = tab.doc();
         m_branchesBooked=true;
@@ -85,9 +85,46 @@ void TableOutputBranches::fill(const edm::EventForOutput &iEvent, TTree & tree,
             throw cms::Exception("LogicError", "Mismatch in number of entries between extension and main table for " + tab.name());
         }
     }
-    for (auto & pair : m_floatBranches) fillColumn<float>(pair, tab);
-    for (auto & pair : m_intBranches) fillColumn<int>(pair, tab);
-    for (auto & pair : m_uint8Branches) fillColumn<uint8_t>(pair, tab);
+    return &tab;
+}
+
+void TableOutputBranches::fill(const edm::EventForOutput &iEvent, TTree & tree, bool extensions) 
+{
+    const nanoaod::FlatTable * tab = table(iEvent, tree, extensions);
+    if (!tab) return;
+    for (auto & pair : m_floatBranches) fillColumn<float>(pair, *tab);
+    for (auto & pair : m_intBranches) fillColumn<int>(pair, *tab);
+    for (auto & pair : m_uint8Branches) fillColumn<uint8_t>(pair, *tab);
 }
 
+void TableOutputBranches::append(const edm::EventForOutput &iEvent, TTree & tree, bool extensions) 
+{
+    const nanoaod::FlatTable * tab = table(iEvent, tree, extensions);
+    if (!tab) return;
+    m_appendedCounts.push_back(m_counter);
+    for (auto & pair : m_floatBranches) appendColumn<float>(pair, *tab);
+    for (auto & pair : m_intBranches) appendColumn<int>(pair, *tab);
+    for (auto & pair : m_uint8Branches) appendColumn<uint8_t>(pair, *tab);
+}
 
+void TableOutputBranches::fillAppended() 
+{
+    if (m_appendedCounts.empty()) return;
+    // the length of the arrays is read from the counter leaf at each Fill, so it has to be set
+    // event by event also while filling the other columns
+    UInt_t * counter = nullptr;
+    if (!m_singleton) {
+        counter = reinterpret_cast<UInt_t *>(m_counterBranch->GetAddress());
+        if (m_extension == IsMain) {
+            m_counterBranch->SetBasketSize(std::max<int>(m_appendedCounts.size()*sizeof(UInt_t), 512));
+            for (UInt_t count : m_appendedCounts) {
+                *counter = count;
+                m_counterBranch->Fill();
+            }
+        }
+    }
+    for (auto & pair : m_floatBranches) fillAppendedColumn<float>(pair, counter);
+    for (auto & pair : m_intBranches) fillAppendedColumn<int>(pair, counter);
+    for (auto & pair : m_uint8Branches) fillAppendedColumn<uint8_t>(pair, counter);
+    m_appendedCounts.clear();
+}
@@ -1,6 +1,7 @@
 #ifndef PhysicsTools_NanoAOD_TableOutputBranches_h
 #define PhysicsTools_NanoAOD_TableOutputBranches_h
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <TTree.h>
@@ -24,6 +25,14 @@ class TableOutputBranches {
     /// This parameter is used so that the fill is called first for non-extensions and then for extensions
     void fill(const edm::EventForOutput &iEvent, TTree & tree, bool extensions) ;
 
+    /// Columnar mode: append the current table to the in-memory column buffers instead,
+    /// with the same convention on extensions as fill()
+    void append(const edm::EventForOutput &iEvent, TTree & tree, bool extensions) ;
+    /// Fill the branches column by column with all the appended events, then clear the buffers.
+    /// The basket size of each branch is set to hold all of them, so that each column of the
+    /// cluster goes to the file as a single basket
+    void fillAppended() ;
+
  private:
     edm::EDGetToken m_token;
     std::string  m_baseName;
@@ -34,6 +43,7 @@ class TableOutputBranches {
     struct NamedBranchPtr {
         std::string name, title, rootTypeCode;
         TBranch * branch;
+        std::vector<uint8_t> buffer; // columnar mode: values of the appended events, back to back
         NamedBranchPtr(const std::string & aname, const std::string & atitle, const std::string & rootType, TBranch *branchptr = nullptr) : 
             name(aname), title(atitle), rootTypeCode(rootType), branch(branchptr) {}
     };
@@ -42,6 +52,10 @@ class TableOutputBranches {
     std::vector<NamedBranchPtr>   m_intBranches;
     std::vector<NamedBranchPtr> m_uint8Branches;
     bool m_branchesBooked;
+    std::vector<UInt_t> m_appendedCounts; // columnar mode: table size of each appended event
+
+    /// Get the table and book the branches on the first call; nullptr if this is not the right pass
+    const nanoaod::FlatTable * table(const edm::EventForOutput &iEvent, TTree & tree, bool extensions) ;
 
     template<typename T>
     void fillColumn(NamedBranchPtr & pair, const nanoaod::FlatTable & tab) {
@@ -50,6 +64,30 @@ class TableOutputBranches {
         pair.branch->SetAddress( const_cast<T *>(& tab.columnData<T>(idx).front() ) ); // SetAddress should take a const * !
     }
 
+    template<typename T>
+    void appendColumn(NamedBranchPtr & pair, const nanoaod::FlatTable & tab) {
+        int idx = tab.columnIndex(pair.name);
+        if (idx == -1) throw cms::Exception("LogicError", "Missing column in input for "+m_baseName+"_"+pair.name);
+        const auto & data = tab.columnData<T>(idx);
+        if (data.empty()) return;
+        const uint8_t * begin = reinterpret_cast<const uint8_t *>(& data.front());
+        pair.buffer.insert(pair.buffer.end(), begin, begin + data.size()*sizeof(T));
+    }
+
+    template<typename T>
+    void fillAppendedColumn(NamedBranchPtr & pair, UInt_t * counter) {
+        pair.branch->SetBasketSize(std::max<int>(pair.buffer.size() + m_appendedCounts.size()*sizeof(Int_t), 512));
+        pair.buffer.reserve(sizeof(T)); // non-null address even if no values were appended
+        T * values = reinterpret_cast<T *>(pair.buffer.data());
+        for (UInt_t count : m_appendedCounts) {
+            if (counter) *counter = count;
+            pair.branch->SetAddress(values);
+            pair.branch->Fill();
+            values += count;
+        }
+        pair.buffer.clear();
+    }
+
 };
 
 #endif
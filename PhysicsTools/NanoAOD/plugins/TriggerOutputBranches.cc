@@ -2,6 +2,7 @@
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/Registry.h"
 
+#include <algorithm>
 #include <iostream>
 
 void 
@@ -72,20 +73,45 @@ edm::TriggerNames TriggerOutputBranches::triggerNames(const edm::TriggerResults
     return edm::TriggerNames();
 }
 
-void TriggerOutputBranches::fill(const edm::EventForOutput &iEvent,TTree & tree) 
+const edm::TriggerResults & TriggerOutputBranches::triggerResults(const edm::EventForOutput &iEvent,TTree & tree) 
 {
     edm::Handle<edm::TriggerResults> handle;
     iEvent.getByToken(m_token, handle);
     const edm::TriggerResults & triggers = *handle;
-    const edm::TriggerNames &names = triggerNames(triggers);
 
     if(m_lastRun!=iEvent.id().run()) {
+        if(m_appended) throw cms::Exception("LogicError", "TriggerOutputBranches: new run with appended events not yet filled");
         m_lastRun=iEvent.id().run();
-        updateTriggerNames(tree,names,triggers);
+        updateTriggerNames(tree,triggerNames(triggers),triggers);
     }
+    return triggers;
+}
+
+void TriggerOutputBranches::fill(const edm::EventForOutput &iEvent,TTree & tree) 
+{
+    const edm::TriggerResults & triggers = triggerResults(iEvent,tree);
     for (auto & pair : m_triggerBranches) fillColumn<uint8_t>(pair, triggers);
     m_fills++; 
 }
 
+void TriggerOutputBranches::append(const edm::EventForOutput &iEvent,TTree & tree) 
+{
+    const edm::TriggerResults & triggers = triggerResults(iEvent,tree);
+    for (auto & nb : m_triggerBranches) nb.values.push_back(nb.idx>=0 ? triggers.accept(nb.idx) : nb.buffer);
+    m_appended++;
+}
 
-
+void TriggerOutputBranches::fillAppended() 
+{
+    for (auto & nb : m_triggerBranches) {
+        nb.branch->SetBasketSize(std::max<int>(nb.values.size(), 512));
+        for (uint8_t value : nb.values) {
+            nb.buffer=value;
+            nb.branch->SetAddress(&(nb.buffer));
+            nb.branch->Fill();
+        }
+        nb.values.clear();
+    }
+    m_fills+=m_appended;
+    m_appended=0;
+}
@@ -13,7 +13,7 @@
 class TriggerOutputBranches {
  public:
     TriggerOutputBranches(const edm::BranchDescription *desc, const edm::EDGetToken & token ) :
-        m_token(token), m_lastRun(-1),m_fills(0)
+        m_token(token), m_lastRun(-1),m_fills(0),m_appended(0)
     {
         if (desc->className() != "edm::TriggerResults") throw cms::Exception("Configuration", "NanoAODOutputModule/TriggerOutputBranches can only write out edm::TriggerResults objects");
     }
@@ -21,6 +21,12 @@ class TriggerOutputBranches {
     void updateTriggerNames(TTree &tree,const edm::TriggerNames & names, const edm::TriggerResults & ta);
     void fill(const edm::EventForOutput &iEvent,TTree & tree) ;
 
+    /// Columnar mode: append the trigger bits to in-memory buffers instead (see TableOutputBranches).
+    /// New trigger branches are back filled with the entries already in the tree, so the appended
+    /// events have to be filled before the trigger names can change, i.e. before a new run
+    void append(const edm::EventForOutput &iEvent,TTree & tree) ;
+    void fillAppended() ;
+
  private:
     edm::TriggerNames triggerNames(const edm::TriggerResults triggerResults); //FIXME: if we have to keep it local we may use PsetID check per event instead of run boundary
 
@@ -33,12 +39,16 @@ class TriggerOutputBranches {
 	int idx;
         TBranch * branch;
 	uint8_t buffer;
+	std::vector<uint8_t> values; // columnar mode: bits of the appended events
         NamedBranchPtr(const std::string & aname, const std::string & atitle, TBranch *branchptr = nullptr) : 
             name(aname), title(atitle), branch(branchptr), buffer(-1) {}
     };
     std::vector<NamedBranchPtr> m_triggerBranches;
     long m_lastRun;
     unsigned long m_fills;
+    unsigned long m_appended;
+
+    const edm::TriggerResults & triggerResults(const edm::EventForOutput &iEvent,TTree & tree) ;
 
     template<typename T>
     void fillColumn(NamedBranchPtr & nb, const edm::TriggerResults & triggers) {
@@ -98,6 +98,43 @@ def nanoAOD_customizeMC(process):
         process.calibratedPatPhotons80X.isMC = cms.bool(True)
     return process
 
+# concrete type of the objects of the candidate tables, for which their expressions are compiled
+_compiledTableTypes = {
+    "electronTable" : "pat::Electron",
+    "muonTable" : "pat::Muon",
+    "photonTable" : "pat::Photon",
+    "tauTable" : "pat::Tau",
+    "jetTable" : "pat::Jet",
+    "fatJetTable" : "pat::Jet",
+    "subJetTable" : "pat::Jet",
+    "jetMCTable" : "pat::Jet",
+    "saJetTable" : "reco::PFJet",
+    "isoTrackTable" : "pat::IsolatedTrack",
+    "metTable" : "pat::MET",
+    "rawMetTable" : "pat::MET",
+    "caloMetTable" : "pat::MET",
+    "puppiMetTable" : "pat::MET",
+    "tkMetTable" : "pat::MET",
+    "metMCTable" : "pat::MET",
+    "genParticleTable" : "reco::GenParticle",
+    "genJetTable" : "reco::GenJet",
+    "genJetAK8Table" : "reco::GenJet",
+    "genSubJetAK8Table" : "reco::GenJet",
+    "svCandidateTable" : "reco::VertexCompositePtrCandidate",
+}
+
+def nanoAOD_customizeCompiledTables(process, compiledCache=""):
+    # evaluate the expressions and cuts of the candidate tables with code compiled at the start
+    # of the job, for the concrete type of their objects; with compiledCache, the libraries (and
+    # the failed compilations) are kept there and reused by later jobs
+    for name, module in process.producers_().items():
+        if module.type_() == "SimpleCandidateFlatTableProducer" and name in _compiledTableTypes:
+            module.compiled = cms.bool(True)
+            module.compiledType = cms.string(_compiledTableTypes[name])
+            if compiledCache:
+                module.compiledCache = cms.untracked.string(compiledCache)
+    return process
+
 ### Era dependent customization
 from Configuration.Eras.Modifier_run2_miniAOD_80XLegacy_cff import run2_miniAOD_80XLegacy
 _80x_sequence = nanoSequence.copy()
@@ -0,0 +1,68 @@
+#!/usr/bin/env python
+# Compares two NanoAOD files entry by entry with plain ROOT (no CMSSW library is
+# loaded): same branches with the same types in the Events, LuminosityBlocks and
+# Runs trees, same number of entries, and the same values of every leaf of every
+# entry. Used to check that the columnar writing mode of NanoAODOutputModule gives
+# the same content as the event by event one.
+
+import sys, math
+import ROOT
+ROOT.PyConfig.IgnoreCommandLineOptions = True
+ROOT.gROOT.SetBatch(True)
+
+def leaves(tree):
+    return dict((l.GetName(), l) for l in tree.GetListOfLeaves())
+
+def same(a, b):
+    return a == b or (math.isnan(a) and math.isnan(b))
+
+def compareTrees(name, tree1, tree2):
+    errors = []
+    leaves1, leaves2 = leaves(tree1), leaves(tree2)
+    for l in sorted(set(leaves1) ^ set(leaves2)):
+        errors.append("%s: leaf %s only in the %s file" % (name, l, "first" if l in leaves1 else "second"))
+    common = sorted(set(leaves1) & set(leaves2))
+    for l in common:
+        if leaves1[l].GetTypeName() != leaves2[l].GetTypeName():
+            errors.append("%s: leaf %s of type %s and %s" % (name, l, leaves1[l].GetTypeName(), leaves2[l].GetTypeName()))
+    if tree1.GetEntries() != tree2.GetEntries():
+        errors.append("%s: %d and %d entries" % (name, tree1.GetEntries(), tree2.GetEntries()))
+        return errors
+    for i in range(tree1.GetEntries()):
+        if tree1.GetEntry(i) <= 0 or tree2.GetEntry(i) <= 0:
+            errors.append("%s: cannot read entry %d" % (name, i))
+            continue
+        for l in common:
+            leaf1, leaf2 = leaves1[l], leaves2[l]
+            n1, n2 = leaf1.GetLen(), leaf2.GetLen()
+            if n1 != n2:
+                errors.append("%s: entry %d, %s has %d and %d values" % (name, i, l, n1, n2))
+                continue
+            for k in range(n1):
+                v1, v2 = leaf1.GetValue(k), leaf2.GetValue(k)
+                if not same(v1, v2):
+                    errors.append("%s: entry %d, %s[%d] = %r and %r" % (name, i, l, k, v1, v2))
+                    break
+    return errors
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3: raise RuntimeError("usage: %s file1.root file2.root" % sys.argv[0])
+    files = [ROOT.TFile.Open(f) for f in sys.argv[1:]]
+    for f, name in zip(files, sys.argv[1:]):
+        if not f or f.IsZombie(): raise RuntimeError("cannot open %s" % name)
+
+    errors = []
+    nentries = 0
+    for name in ("Events", "LuminosityBlocks", "Runs"):
+        trees = [f.Get(name) for f in files]
+        if not all(trees):
+            errors.append("no %s tree in %s" % (name, " and ".join(n for t, n in zip(trees, sys.argv[1:]) if not t)))
+            continue
+        errors += compareTrees(name, *trees)
+        nentries += trees[0].GetEntries()
+    for e in errors[:50]:
+        print(e)
+    if errors:
+        print("%d differences between %s and %s" % (len(errors), sys.argv[1], sys.argv[2]))
+        sys.exit(1)
+    print("%s and %s identical: %d entries" % (sys.argv[1], sys.argv[2], nentries))
@@ -0,0 +1,104 @@
+/*
+ * Service sharing TensorFlow graphs between modules and streams and batching their inference
+ * requests.
+ *
+ * Every model (graph file plus input and output names) is loaded once per process into one
+ * read-only GraphDef and one session. Modules submit requests from their acquire() method
+ * (edm::ExternalWork). A request is evaluated right away by the submitting thread if no evaluation
+ * of its model is running. Otherwise it is queued, and the thread running the current evaluation
+ * picks up all queued requests when it is done, concatenated along the first (batch) dimension
+ * up to maxBatchSize rows, and evaluates them together. Batches therefore grow with the load
+ * without any request waiting for others, and everything runs in the TBB threads of the
+ * framework. The outputs are split back per request and the waiting modules are released.
+ */
+
+#ifndef PHYSICSTOOLS_TENSORFLOW_TFBATCHINGSERVICE_H
+#define PHYSICSTOOLS_TENSORFLOW_TFBATCHINGSERVICE_H
+
+#include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
+
+#include "FWCore/Concurrency/interface/WaitingTaskWithArenaHolder.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace edm
+{
+class ActivityRegistry;
+class ConfigurationDescriptions;
+class ParameterSet;
+}
+
+namespace tensorflow
+{
+
+class TFBatchingService
+{
+public:
+    // one request: batched inputs in the order of the model input names, all with the same size
+    // of the first dimension; outputs is filled in the order of the model output names
+    struct Request
+    {
+        std::vector<Tensor> inputs;
+        std::vector<Tensor>* outputs;
+        edm::WaitingTaskWithArenaHolder holder;
+    };
+
+    class Model
+    {
+    public:
+        Model(const std::string& graphPath, const std::vector<std::string>& inputNames,
+            const std::vector<std::string>& outputNames, const NamedTensorList& fixedInputs,
+            SessionOptions& sessionOptions);
+        ~Model();
+
+        const std::vector<std::string>& inputNames() const { return inputNames_; }
+        const std::vector<std::string>& outputNames() const { return outputNames_; }
+
+    private:
+        friend class TFBatchingService;
+
+        std::unique_ptr<GraphDef> graphDef_;
+        Session* session_;
+        std::vector<std::string> inputNames_;
+        std::vector<std::string> outputNames_;
+        NamedTensorList fixedInputs_;
+
+        // guarded by the service mutex
+        std::vector<Request> pending_;
+        bool running_;
+    };
+
+    TFBatchingService(const edm::ParameterSet& pset, edm::ActivityRegistry& registry);
+    ~TFBatchingService();
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+    // the shared model for this graph and these names, loaded on first request; fixedInputs
+    // (e.g. learning phase flags) are added unchanged to every evaluation
+    Model* model(const std::string& graphPath, const std::vector<std::string>& inputNames,
+        const std::vector<std::string>& outputNames, const NamedTensorList& fixedInputs = {});
+
+    // evaluate a request, now or in the batch of the evaluation running for the model;
+    // request.holder is released once request.outputs is filled, or with the exception thrown by
+    // the evaluation
+    void submit(Model* model, Request&& request);
+
+private:
+    std::vector<Request> take(Model& model);
+    void runBatch(Model& model, std::vector<Request>& batch);
+
+    const int64 maxBatchSize_;
+    const int nThreads_;
+    const std::string singleThreadPool_;
+
+    std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<Model>> models_;
+};
+
+} // namespace tensorflow
+
+#endif // PHYSICSTOOLS_TENSORFLOW_TFBATCHINGSERVICE_H
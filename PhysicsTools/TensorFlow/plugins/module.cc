@@ -0,0 +1,6 @@
+#include "PhysicsTools/TensorFlow/interface/TFBatchingService.h"
+#include "FWCore/ServiceRegistry/interface/ServiceMaker.h"
+
+typedef tensorflow::TFBatchingService TFBatchingService;
+
+DEFINE_FWK_SERVICE(TFBatchingService);
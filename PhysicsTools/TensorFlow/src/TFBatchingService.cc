@@ -0,0 +1,222 @@
+/*
+ * Service sharing TensorFlow graphs between modules and streams and batching their inference
+ * requests.
+ */
+
+#include "PhysicsTools/TensorFlow/interface/TFBatchingService.h"
+
+#include "tensorflow/core/framework/tensor_util.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+
+#include <exception>
+#include <iterator>
+
+namespace tensorflow
+{
+
+TFBatchingService::Model::Model(const std::string& graphPath,
+    const std::vector<std::string>& inputNames, const std::vector<std::string>& outputNames,
+    const NamedTensorList& fixedInputs, SessionOptions& sessionOptions)
+    : graphDef_(loadGraphDef(graphPath))
+    , session_(createSession(graphDef_.get(), sessionOptions))
+    , inputNames_(inputNames)
+    , outputNames_(outputNames)
+    , fixedInputs_(fixedInputs)
+    , running_(false)
+{
+}
+
+TFBatchingService::Model::~Model()
+{
+    if (session_ != nullptr)
+    {
+        closeSession(session_);
+    }
+}
+
+TFBatchingService::TFBatchingService(const edm::ParameterSet& pset, edm::ActivityRegistry&)
+    : maxBatchSize_(pset.getUntrackedParameter<unsigned int>("maxBatchSize"))
+    , nThreads_(pset.getUntrackedParameter<unsigned int>("nThreads"))
+    , singleThreadPool_(pset.getUntrackedParameter<std::string>("singleThreadPool"))
+{
+    setLogging("3");
+}
+
+TFBatchingService::~TFBatchingService() {}
+
+void TFBatchingService::fillDescriptions(edm::ConfigurationDescriptions& descriptions)
+{
+    edm::ParameterSetDescription desc;
+    desc.addUntracked<unsigned int>("maxBatchSize", 256)
+        ->setComment("largest number of rows (e.g. jets) of queued requests evaluated together; "
+                     "a single larger request is still evaluated at once");
+    desc.addUntracked<unsigned int>("nThreads", 1);
+    desc.addUntracked<std::string>("singleThreadPool", "no_threads");
+    descriptions.add("TFBatchingService", desc);
+}
+
+TFBatchingService::Model* TFBatchingService::model(const std::string& graphPath,
+    const std::vector<std::string>& inputNames, const std::vector<std::string>& outputNames,
+    const NamedTensorList& fixedInputs)
+{
+    std::string key = graphPath;
+    for (const auto& name : inputNames)
+    {
+        key += ";" + name;
+    }
+    key += "|";
+    for (const auto& name : outputNames)
+    {
+        key += ";" + name;
+    }
+    for (const auto& input : fixedInputs)
+    {
+        key += "|" + input.first + "=" + input.second.DebugString();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& model = models_[key];
+    if (!model)
+    {
+        SessionOptions sessionOptions;
+        setThreading(sessionOptions, nThreads_, singleThreadPool_);
+        model = std::make_unique<Model>(graphPath, inputNames, outputNames, fixedInputs,
+            sessionOptions);
+    }
+    return model.get();
+}
+
+void TFBatchingService::submit(Model* model, Request&& request)
+{
+    if (request.inputs.size() != model->inputNames_.size())
+    {
+        throw cms::Exception("InvalidRequest")
+            << "got " << request.inputs.size() << " input tensors for "
+            << model->inputNames_.size() << " inputs";
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    model->pending_.push_back(std::move(request));
+    if (model->running_)
+    {
+        // picked up by the thread running the current evaluation
+        return;
+    }
+    model->running_ = true;
+    // evaluate this request and whatever was queued meanwhile, until nothing is left
+    while (!model->pending_.empty())
+    {
+        std::vector<Request> batch = take(*model);
+        lock.unlock();
+        runBatch(*model, batch);
+        lock.lock();
+    }
+    model->running_ = false;
+}
+
+std::vector<TFBatchingService::Request> TFBatchingService::take(Model& model)
+{
+    // the oldest requests, up to maxBatchSize rows but at least one request
+    size_t n = 0;
+    int64 rows = 0;
+    while (n < model.pending_.size() && (n == 0 || rows < maxBatchSize_))
+    {
+        const auto& inputs = model.pending_[n].inputs;
+        int64 requestRows = inputs.empty() ? 0 : inputs[0].dim_size(0);
+        if (n > 0 && rows + requestRows > maxBatchSize_)
+        {
+            break;
+        }
+        rows += requestRows;
+        n++;
+    }
+    std::vector<Request> batch(std::make_move_iterator(model.pending_.begin()),
+        std::make_move_iterator(model.pending_.begin() + n));
+    model.pending_.erase(model.pending_.begin(), model.pending_.begin() + n);
+    return batch;
+}
+
+void TFBatchingService::runBatch(Model& model, std::vector<Request>& batch)
+{
+    try
+    {
+        // concatenate the inputs along the batch dimension
+        NamedTensorList inputs;
+        inputs.reserve(model.inputNames_.size() + model.fixedInputs_.size());
+        std::vector<int64> rows;
+        for (const auto& request : batch)
+        {
+            rows.push_back(request.inputs.empty() ? 0 : request.inputs[0].dim_size(0));
+        }
+        for (size_t i = 0; i < model.inputNames_.size(); i++)
+        {
+            if (batch.size() == 1)
+            {
+                inputs.emplace_back(model.inputNames_[i], batch[0].inputs[i]);
+                continue;
+            }
+            std::vector<Tensor> parts;
+            parts.reserve(batch.size());
+            for (const auto& request : batch)
+            {
+                parts.push_back(request.inputs[i]);
+            }
+            Tensor merged;
+            Status status = tensor::Concat(parts, &merged);
+            if (!status.ok())
+            {
+                throw cms::Exception("InvalidRequest")
+                    << "error while batching input " << model.inputNames_[i] << ": "
+                    << status.ToString();
+            }
+            inputs.emplace_back(model.inputNames_[i], std::move(merged));
+        }
+        inputs.insert(inputs.end(), model.fixedInputs_.begin(), model.fixedInputs_.end());
+
+        std::vector<Tensor> outputs;
+        run(model.session_, inputs, model.outputNames_, &outputs);
+
+        // split the outputs back per request
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            if (batch.size() == 1)
+            {
+                batch[0].outputs->resize(outputs.size());
+                (*batch[0].outputs)[i] = outputs[i];
+                continue;
+            }
+            std::vector<Tensor> parts;
+            Status status = tensor::Split(outputs[i], rows, &parts);
+            if (!status.ok())
+            {
+                throw cms::Exception("InvalidRequest")
+                    << "error while unbatching output " << model.outputNames_[i] << ": "
+                    << status.ToString();
+            }
+            for (size_t r = 0; r < batch.size(); r++)
+            {
+                batch[r].outputs->resize(outputs.size());
+                (*batch[r].outputs)[i] = std::move(parts[r]);
+            }
+        }
+    }
+    catch (...)
+    {
+        std::exception_ptr exception = std::current_exception();
+        for (auto& request : batch)
+        {
+            request.holder.doneWaiting(exception);
+        }
+        return;
+    }
+    for (auto& request : batch)
+    {
+        request.holder.doneWaiting(nullptr);
+    }
+}
+
+} // namespace tensorflow
@@ -0,0 +1,186 @@
+/*
+ * Tests for the TFBatchingService: requests submitted concurrently are evaluated, batched or not,
+ * with the same outputs as a direct evaluation of each request, and errors reach every waiting
+ * request.
+ */
+
+#include <boost/filesystem.hpp>
+#include <cppunit/extensions/HelperMacros.h>
+#include <atomic>
+#include <stdexcept>
+
+#include "tbb/parallel_for.h"
+
+#include "FWCore/Concurrency/interface/WaitingTaskList.h"
+#include "FWCore/Concurrency/interface/WaitingTaskWithArenaHolder.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+#include "PhysicsTools/TensorFlow/interface/TFBatchingService.h"
+
+std::string cmsswPath(std::string path)
+{
+    if (path.size() > 0 && path.substr(0, 1) != "/")
+    {
+        path = "/" + path;
+    }
+
+    std::string base = std::string(std::getenv("CMSSW_BASE"));
+    std::string releaseBase = std::string(std::getenv("CMSSW_RELEASE_BASE"));
+
+    return (boost::filesystem::exists(base.c_str()) ? base : releaseBase) + path;
+}
+
+class testBatchingService : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE(testBatchingService);
+    CPPUNIT_TEST(checkAll);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    std::string dataPath;
+
+    void setUp();
+    void tearDown();
+    void checkAll();
+
+    // submits nRequests requests of 1 to 3 rows from concurrent tasks, returns the number of
+    // requests released with an exception
+    unsigned int submitAll(tensorflow::TFBatchingService& service,
+        tensorflow::TFBatchingService::Model* model, std::vector<tensorflow::Tensor>& inputs,
+        std::vector<std::vector<tensorflow::Tensor>>& outputs);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testBatchingService);
+
+void testBatchingService::setUp()
+{
+    dataPath = cmsswPath("/test/" + std::string(getenv("SCRAM_ARCH"))
+        + "/" + boost::filesystem::unique_path().string());
+
+    // create the graph
+    std::string testPath = cmsswPath("/src/PhysicsTools/TensorFlow/test");
+    std::string cmd = "python " + testPath + "/createconstantgraph.py " + dataPath;
+    std::array<char, 128> buffer;
+    std::string result;
+    std::shared_ptr<FILE> pipe(popen(cmd.c_str(), "r"), pclose);
+    if (!pipe)
+    {
+        throw std::runtime_error("popen() failed!");
+    }
+    while (!feof(pipe.get()))
+    {
+        if (fgets(buffer.data(), 128, pipe.get()) != NULL)
+        {
+            result += buffer.data();
+        }
+    }
+    std::cout << std::endl
+              << result << std::endl;
+}
+
+void testBatchingService::tearDown()
+{
+    if (boost::filesystem::exists(dataPath))
+    {
+        boost::filesystem::remove_all(dataPath);
+    }
+}
+
+unsigned int testBatchingService::submitAll(tensorflow::TFBatchingService& service,
+    tensorflow::TFBatchingService::Model* model, std::vector<tensorflow::Tensor>& inputs,
+    std::vector<std::vector<tensorflow::Tensor>>& outputs)
+{
+    std::atomic<unsigned int> nFailed(0);
+    auto waitTask = edm::make_empty_waiting_task();
+    waitTask->set_ref_count(1 + inputs.size());
+
+    tbb::parallel_for(size_t(0), inputs.size(), [&](size_t i) {
+        auto task = edm::make_waiting_task(waitTask->allocate_child(),
+            [&nFailed](std::exception_ptr const* exception) {
+                if (exception != nullptr)
+                {
+                    nFailed++;
+                }
+            });
+        tensorflow::TFBatchingService::Request request;
+        request.inputs.push_back(inputs[i]);
+        request.outputs = &outputs[i];
+        request.holder = edm::WaitingTaskWithArenaHolder(task);
+        service.submit(model, std::move(request));
+    });
+
+    waitTask->wait_for_all();
+    return nFailed;
+}
+
+void testBatchingService::checkAll()
+{
+    std::string pbFile = dataPath + "/constantgraph.pb";
+    tensorflow::setLogging();
+
+    // small batches so that queued requests are split over several evaluations
+    edm::ParameterSet pset;
+    pset.addUntrackedParameter<unsigned int>("maxBatchSize", 8);
+    pset.addUntrackedParameter<unsigned int>("nThreads", 1);
+    pset.addUntrackedParameter<std::string>("singleThreadPool", "no_threads");
+    edm::ActivityRegistry registry;
+    tensorflow::TFBatchingService service(pset, registry);
+
+    tensorflow::Tensor scale(tensorflow::DT_FLOAT, {});
+    scale.scalar<float>()() = 2.0;
+    tensorflow::TFBatchingService::Model* model = service.model(pbFile, { "input" },
+        { "output" }, { { "scale", scale } });
+    CPPUNIT_ASSERT(model != nullptr);
+    CPPUNIT_ASSERT(model == service.model(pbFile, { "input" }, { "output" },
+        { { "scale", scale } }));
+
+    // requests of 1 to 3 rows with different values
+    const size_t nRequests = 200;
+    std::vector<tensorflow::Tensor> inputs;
+    for (size_t i = 0; i < nRequests; i++)
+    {
+        int64_t rows = 1 + i % 3;
+        tensorflow::Tensor input(tensorflow::DT_FLOAT, { rows, 10 });
+        auto m = input.matrix<float>();
+        for (int64_t r = 0; r < rows; r++)
+        {
+            for (int64_t c = 0; c < 10; c++)
+            {
+                m(r, c) = float(i + r + c);
+            }
+        }
+        inputs.push_back(input);
+    }
+
+    // every request gets the outputs of its own rows, as evaluated alone
+    std::vector<std::vector<tensorflow::Tensor>> outputs(nRequests);
+    CPPUNIT_ASSERT(submitAll(service, model, inputs, outputs) == 0);
+
+    tensorflow::GraphDef* graphDef = tensorflow::loadGraphDef(pbFile);
+    tensorflow::Session* session = tensorflow::createSession(graphDef);
+    for (size_t i = 0; i < nRequests; i++)
+    {
+        std::vector<tensorflow::Tensor> expected;
+        tensorflow::run(session, { { "input", inputs[i] }, { "scale", scale } }, { "output" },
+            &expected);
+        CPPUNIT_ASSERT(outputs[i].size() == 1);
+        CPPUNIT_ASSERT(outputs[i][0].dim_size(0) == inputs[i].dim_size(0));
+        for (int64_t r = 0; r < inputs[i].dim_size(0); r++)
+        {
+            CPPUNIT_ASSERT(outputs[i][0].matrix<float>()(r, 0) == expected[0].matrix<float>()(r, 0));
+        }
+    }
+    CPPUNIT_ASSERT(tensorflow::closeSession(session));
+    delete graphDef;
+
+    // an unknown output fails the evaluation, which is reported to every request
+    tensorflow::TFBatchingService::Model* badModel = service.model(pbFile, { "input" }, { "foo" },
+        { { "scale", scale } });
+    std::vector<std::vector<tensorflow::Tensor>> badOutputs(nRequests);
+    CPPUNIT_ASSERT(submitAll(service, badModel, inputs, badOutputs) == nRequests);
+
+    // wrong number of inputs
+    tensorflow::TFBatchingService::Request request;
+    request.outputs = &badOutputs[0];
+    CPPUNIT_ASSERT_THROW(service.submit(model, std::move(request)), cms::Exception);
+}
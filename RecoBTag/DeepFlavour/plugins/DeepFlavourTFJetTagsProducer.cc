@@ -8,6 +8,7 @@
 #include "FWCore/Framework/interface/makeRefToBaseProdFrom.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/Utilities/interface/StreamID.h"
 
 #include "DataFormats/BTauReco/interface/JetTag.h"
@@ -15,6 +16,7 @@
 #include "DataFormats/BTauReco/interface/DeepFlavourTagInfo.h"
 
 #include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
+#include "PhysicsTools/TensorFlow/interface/TFBatchingService.h"
 
 #include "tensor_fillers.h"
 
@@ -33,7 +35,7 @@ struct DeepFlavourTFCache {
   std::atomic<tensorflow::GraphDef*> graphDef;
 };
 
-class DeepFlavourTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalCache<DeepFlavourTFCache>> {
+class DeepFlavourTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalCache<DeepFlavourTFCache>, edm::ExternalWork> {
 
   public:
     explicit DeepFlavourTFJetTagsProducer(const edm::ParameterSet&, const DeepFlavourTFCache*);
@@ -62,9 +64,16 @@ class DeepFlavourTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalC
     typedef reco::JetTagCollection JetTagCollection;
 
     void beginStream(edm::StreamID) override {}
+    void acquire(const edm::Event&, const edm::EventSetup&, edm::WaitingTaskWithArenaHolder) override;
     void produce(edm::Event&, const edm::EventSetup&) override;
     void endStream() override {}
 
+    // create the input tensors for batches of n_batch_jets jets
+    void allocate_inputs(int64_t n_batch_jets, std::vector<tensorflow::Tensor> & tensors) const;
+    // zero and fill the input tensors with the jets of the batch starting at first_jet
+    void make_inputs(const TagInfoCollection & tag_infos, std::size_t first_jet,
+                     std::vector<tensorflow::Tensor> & tensors) const;
+
     const edm::EDGetTokenT< TagInfoCollection > src_;
     std::vector<std::pair<std::string,std::vector<unsigned int>>> flav_pairs_;
     std::vector<std::string> input_names_;
@@ -77,6 +86,12 @@ class DeepFlavourTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalC
     std::vector<tensorflow::Tensor> lp_tensors_;
     // flag to evaluate model batch or jet by jet
     bool batch_eval_;
+    // shared model evaluated through the batching service, if requested
+    tensorflow::TFBatchingService* service_;
+    tensorflow::TFBatchingService::Model* model_;
+    // outputs of each evaluation of the current event, and jets per evaluation
+    std::vector<std::vector<tensorflow::Tensor>> outputs_;
+    int64_t n_batch_jets_;
 };
 
 DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterSet& iConfig,
@@ -86,16 +101,21 @@ DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterS
   output_names_(iConfig.getParameter<std::vector<std::string>>("output_names")),
   lp_names_(iConfig.getParameter<std::vector<std::string>>("lp_names")),
   session_(nullptr),
-  batch_eval_(iConfig.getParameter<bool>("batch_eval"))
+  batch_eval_(iConfig.getParameter<bool>("batch_eval")),
+  service_(nullptr),
+  model_(nullptr),
+  n_batch_jets_(0)
 {
-  // get threading config and build session options
-  size_t nThreads = iConfig.getParameter<unsigned int>("nThreads");
-  std::string singleThreadPool = iConfig.getParameter<std::string>("singleThreadPool");
-  tensorflow::SessionOptions sessionOptions;
-  tensorflow::setThreading(sessionOptions, nThreads, singleThreadPool);
-
-  // create the session using the meta graph from the cache
-  session_ = tensorflow::createSession(cache->graphDef, sessionOptions);
+  if (!iConfig.getParameter<bool>("use_batching_service")) {
+    // get threading config and build session options
+    size_t nThreads = iConfig.getParameter<unsigned int>("nThreads");
+    std::string singleThreadPool = iConfig.getParameter<std::string>("singleThreadPool");
+    tensorflow::SessionOptions sessionOptions;
+    tensorflow::setThreading(sessionOptions, nThreads, singleThreadPool);
+
+    // create the session using the meta graph from the cache
+    session_ = tensorflow::createSession(cache->graphDef, sessionOptions);
+  }
 
   // get output names from flav_table
   const auto & flav_pset = iConfig.getParameter<edm::ParameterSet>("flav_table");
@@ -117,6 +137,18 @@ DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterS
     t.scalar<bool>()() = false;
     lp_tensors_.push_back(t);
   }
+
+  // the graph and session are owned by the service and shared with all streams and modules
+  // using the same model
+  if (session_ == nullptr) {
+    tensorflow::NamedTensorList lp_inputs;
+    for (size_t i = 0; i < lp_names_.size(); i++) {
+      lp_inputs.emplace_back(lp_names_[i], lp_tensors_[i]);
+    }
+    service_ = &*edm::Service<tensorflow::TFBatchingService>();
+    model_ = service_->model(iConfig.getParameter<edm::FileInPath>("graph_path").fullPath(),
+                             input_names_, output_names_, lp_inputs);
+  }
 }
 
 DeepFlavourTFJetTagsProducer::~DeepFlavourTFJetTagsProducer()
@@ -153,6 +185,8 @@ void DeepFlavourTFJetTagsProducer::fillDescriptions(edm::ConfigurationDescriptio
   }
 
   desc.add<bool>("batch_eval", false);
+  desc.add<bool>("use_batching_service", false)
+    ->setComment("evaluate through the TFBatchingService, batching the jets of several events");
 
   desc.add<unsigned int>("nThreads", 1);
   desc.add<std::string>("singleThreadPool", "no_threads");
@@ -169,9 +203,11 @@ std::unique_ptr<DeepFlavourTFCache> DeepFlavourTFJetTagsProducer::initializeGlob
   // get the pb file
   std::string pbFile = iConfig.getParameter<edm::FileInPath>("graph_path").fullPath();
 
-  // load the graph def and save it in the cache
+  // load the graph def and save it in the cache, unless the batching service owns it
   DeepFlavourTFCache* cache = new DeepFlavourTFCache();
-  cache->graphDef = tensorflow::loadGraphDef(pbFile);
+  if (!iConfig.getParameter<bool>("use_batching_service")) {
+    cache->graphDef = tensorflow::loadGraphDef(pbFile);
+  }
 
   return std::unique_ptr<DeepFlavourTFCache>(cache);
 }
@@ -183,28 +219,9 @@ void DeepFlavourTFJetTagsProducer::globalEndJob(const DeepFlavourTFCache* cache)
   }
 }
 
-void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
+void DeepFlavourTFJetTagsProducer::allocate_inputs(int64_t n_batch_jets,
+                                                   std::vector<tensorflow::Tensor> & tensors) const
 {
-
-  edm::Handle<TagInfoCollection> tag_infos;
-  iEvent.getByToken(src_, tag_infos);
-
-  // initialize output collection
-  std::vector<std::unique_ptr<JetTagCollection>> output_tags;
-  for (std::size_t i=0; i < flav_pairs_.size(); i++) {
-    if (!tag_infos->empty()) {
-      auto jet_ref = tag_infos->begin()->jet();
-      output_tags.emplace_back(std::make_unique<JetTagCollection>(
-            edm::makeRefToBaseProdFrom(jet_ref, iEvent)));
-    } else {
-      output_tags.emplace_back(std::make_unique<JetTagCollection>());
-    }
-  }
-
-  const int64_t n_jets = tag_infos->size();
-  // either all jets or one per batch for the time being
-  const int64_t n_batch_jets = batch_eval_ ?  n_jets : 1;
-
   std::vector<tensorflow::TensorShape> input_sizes {
     {n_batch_jets, 15},         // input_1 - global jet features
     {n_batch_jets, 25, 16},     // input_2 - charged pf
@@ -213,81 +230,147 @@ void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventS
     {n_batch_jets, 1}           // input_5 - jet pt for reg 
   };
 
+  tensors.clear();
+  for (std::size_t i=0; i < input_sizes.size(); i++) {
+    tensors.emplace_back(tensorflow::DT_FLOAT, input_sizes.at(i));
+  }
+}
+
+void DeepFlavourTFJetTagsProducer::make_inputs(const TagInfoCollection & tag_infos,
+                                               std::size_t first_jet,
+                                               std::vector<tensorflow::Tensor> & tensors) const
+{
+  const int64_t n_batch_jets = tensors.at(kGlobal).dim_size(0);
+
+  // tensors have to be zeroed before filling per batch
+  for (auto & tensor : tensors) {
+    tensor.flat<float>().setZero();
+  }
+
+  // fill values of the input tensors
+  for (std::size_t jet_bn=0; jet_bn < (std::size_t) n_batch_jets; jet_bn++) {
+
+    // global jet index (jet_bn is the jet batch index)
+    std::size_t jet_n = first_jet + jet_bn;
+
+    // jet and other global features
+    const auto & features = tag_infos.at(jet_n).features();
+    jet_tensor_filler(tensors.at(kGlobal), jet_bn, features);
+
+    // c_pf candidates
+    auto max_c_pf_n = std::min(features.c_pf_features.size(),
+      (std::size_t) tensors.at(kChargedCandidates).dim_size(1));
+    for (std::size_t c_pf_n=0; c_pf_n < max_c_pf_n; c_pf_n++) {
+      const auto & c_pf_features = features.c_pf_features.at(c_pf_n);
+      c_pf_tensor_filler(tensors.at(kChargedCandidates),
+                         jet_bn, c_pf_n, c_pf_features);
+    }
+
+    // n_pf candidates
+    auto max_n_pf_n = std::min(features.n_pf_features.size(),
+      (std::size_t) tensors.at(kNeutralCandidates).dim_size(1));
+    for (std::size_t n_pf_n=0; n_pf_n < max_n_pf_n; n_pf_n++) {
+      const auto & n_pf_features = features.n_pf_features.at(n_pf_n);
+      n_pf_tensor_filler(tensors.at(kNeutralCandidates),
+                         jet_bn, n_pf_n, n_pf_features);
+    }
+
+    // sv candidates
+    auto max_sv_n = std::min(features.sv_features.size(),
+      (std::size_t) tensors.at(kVertices).dim_size(1));
+    for (std::size_t sv_n=0; sv_n < max_sv_n; sv_n++) {
+      const auto & sv_features = features.sv_features.at(sv_n);
+      sv_tensor_filler(tensors.at(kVertices),
+                       jet_bn, sv_n, sv_features);
+    }
+
+    // last input: jet pt
+    tensors.at(kJetPt).matrix<float>()(jet_bn, 0) = features.jet_features.pt;
+  }
+}
+
+void DeepFlavourTFJetTagsProducer::acquire(const edm::Event& iEvent, const edm::EventSetup& iSetup,
+                                           edm::WaitingTaskWithArenaHolder holder)
+{
+  edm::Handle<TagInfoCollection> tag_infos;
+  iEvent.getByToken(src_, tag_infos);
+
+  outputs_.clear();
+  const int64_t n_jets = tag_infos->size();
+  if (n_jets == 0) return;
+
+  if (model_ != nullptr) {
+    // all jets of the event in one request, the service batches it with other events
+    n_batch_jets_ = n_jets;
+    outputs_.resize(1);
+    tensorflow::TFBatchingService::Request request;
+    allocate_inputs(n_jets, request.inputs);
+    make_inputs(*tag_infos, 0, request.inputs);
+    request.outputs = &outputs_[0];
+    request.holder = std::move(holder);
+    service_->submit(model_, std::move(request));
+    return;
+  }
+
+  // either all jets or one per batch for the time being
+  n_batch_jets_ = batch_eval_ ?  n_jets : 1;
+
   // create a list of named tensors, i.e. a vector of (string, Tensor) pairs, with proper size to
   // prevent element copying that would occur via push_back's
   // the default Tensor constructor creates a scalar so this should be fine w.r.t. to memory
+  std::vector<tensorflow::Tensor> tensors;
+  allocate_inputs(n_batch_jets_, tensors);
   tensorflow::NamedTensorList input_tensors;
-  input_tensors.resize(input_sizes.size() + lp_tensors_.size());
+  input_tensors.resize(input_names_.size() + lp_tensors_.size());
 
-  // add actual input tensors that hold physics information
-  for (std::size_t i=0; i < input_sizes.size(); i++) {
-    input_tensors[i] = tensorflow::NamedTensor(
-      input_names_[i], tensorflow::Tensor(tensorflow::DT_FLOAT, input_sizes.at(i)));
+  // add actual input tensors that hold physics information, filled per batch
+  for (std::size_t i=0; i < tensors.size(); i++) {
+    input_tensors[i] = tensorflow::NamedTensor(input_names_[i], tensors[i]);
   }
 
-  // add learning-phase tensors behind them
+  // add learning-phase tensors behind the actual inputs
   for (std::size_t i=0; i < lp_tensors_.size(); i++) {
-    input_tensors[input_sizes.size() + i] = tensorflow::NamedTensor(lp_names_[i], lp_tensors_[i]);
+    input_tensors[input_names_.size() + i] = tensorflow::NamedTensor(lp_names_[i], lp_tensors_[i]);
   }
 
-  std::size_t n_batches = n_jets/n_batch_jets; // either 1 or n_jets
+  std::size_t n_batches = n_jets/n_batch_jets_; // either 1 or n_jets
+  outputs_.resize(n_batches);
   for (std::size_t batch_n=0; batch_n < n_batches; batch_n++) {
 
-    // tensors have to be zeroed before filling per batch
-    for (std::size_t i=0; i < input_sizes.size(); i++) {
-      input_tensors[i].second.flat<float>().setZero();
-    }
-
-    // fill values of the input tensors
-    for (std::size_t jet_bn=0; jet_bn < (std::size_t) n_batch_jets; jet_bn++) {
+    make_inputs(*tag_infos, batch_n*n_batch_jets_, tensors);
 
-      // global jet index (jet_bn is the jet batch index)
-      std::size_t jet_n = batch_n*n_batch_jets + jet_bn;
-
-      // jet and other global features
-      const auto & features = tag_infos->at(jet_n).features();
-      jet_tensor_filler(input_tensors.at(kGlobal).second, jet_bn, features);
-
-      // c_pf candidates
-      auto max_c_pf_n = std::min(features.c_pf_features.size(),
-        (std::size_t) input_sizes.at(kChargedCandidates).dim_size(1));
-      for (std::size_t c_pf_n=0; c_pf_n < max_c_pf_n; c_pf_n++) {
-        const auto & c_pf_features = features.c_pf_features.at(c_pf_n);
-        c_pf_tensor_filler(input_tensors.at(kChargedCandidates).second,
-                           jet_bn, c_pf_n, c_pf_features);
-      }
+    // run the session
+    tensorflow::run(session_, input_tensors, output_names_, &outputs_[batch_n]);
+  }
+}
 
-      // n_pf candidates
-      auto max_n_pf_n = std::min(features.n_pf_features.size(),
-        (std::size_t) input_sizes.at(kNeutralCandidates).dim_size(1));
-      for (std::size_t n_pf_n=0; n_pf_n < max_n_pf_n; n_pf_n++) {
-        const auto & n_pf_features = features.n_pf_features.at(n_pf_n);
-        n_pf_tensor_filler(input_tensors.at(kNeutralCandidates).second,
-                           jet_bn, n_pf_n, n_pf_features);
-      }
+void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
+{
 
-      // sv candidates
-      auto max_sv_n = std::min(features.sv_features.size(),
-        (std::size_t) input_sizes.at(kVertices).dim_size(1));
-      for (std::size_t sv_n=0; sv_n < max_sv_n; sv_n++) {
-        const auto & sv_features = features.sv_features.at(sv_n);
-        sv_tensor_filler(input_tensors.at(kVertices).second,
-                         jet_bn, sv_n, sv_features);
-      }
+  edm::Handle<TagInfoCollection> tag_infos;
+  iEvent.getByToken(src_, tag_infos);
 
-      // last input: jet pt
-      input_tensors.at(kJetPt).second.matrix<float>()(jet_bn, 0) = features.jet_features.pt;
+  // initialize output collection
+  std::vector<std::unique_ptr<JetTagCollection>> output_tags;
+  for (std::size_t i=0; i < flav_pairs_.size(); i++) {
+    if (!tag_infos->empty()) {
+      auto jet_ref = tag_infos->begin()->jet();
+      output_tags.emplace_back(std::make_unique<JetTagCollection>(
+            edm::makeRefToBaseProdFrom(jet_ref, iEvent)));
+    } else {
+      output_tags.emplace_back(std::make_unique<JetTagCollection>());
     }
+  }
 
-    // run the session
-    std::vector<tensorflow::Tensor> outputs;
-    tensorflow::run(session_, input_tensors, output_names_, &outputs);
+  for (std::size_t batch_n=0; batch_n < outputs_.size(); batch_n++) {
+
+    const auto & outputs = outputs_[batch_n];
 
     // set output values for flavour probs
-    for (std::size_t jet_bn=0; jet_bn < (std::size_t) n_batch_jets; jet_bn++) {
+    for (std::size_t jet_bn=0; jet_bn < (std::size_t) n_batch_jets_; jet_bn++) {
 
       // global jet index (jet_bn is the jet batch index)
-      std::size_t jet_n = batch_n*n_batch_jets + jet_bn;
+      std::size_t jet_n = batch_n*n_batch_jets_ + jet_bn;
 
       const auto & jet_ref = tag_infos->at(jet_n).jet();
       for (std::size_t flav_n=0; flav_n < flav_pairs_.size(); flav_n++) {
@@ -300,6 +383,7 @@ void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventS
       }
     }
   }
+  outputs_.clear();
 
   for (std::size_t i=0; i < flav_pairs_.size(); i++) {
     iEvent.put(std::move(output_tags[i]), flav_pairs_.at(i).first);
@@ -56,6 +56,8 @@
 #include "fastjet/ClusterSequence.hh"
 #include "fastjet/PseudoJet.hh"
 
+#include "tbb/parallel_for.h"
+
 //
 // constants, enums and typedefs
 //
@@ -173,10 +175,25 @@ class TemplatedSecondaryVertexProducer : public edm::stream::EDProducer<> {
 	edm::EDGetTokenT<edm::View<reco::Jet> > token_groomedFatJets;
 	
 	ClusterSequencePtr		fjClusterSeq;
+
+	bool				eventLevelVertexing;
 	JetDefPtr			fjJetDefinition;
 
 	void markUsedTracks(TrackDataVector & trackData, const input_container & trackRefs, const SecondaryVertex & sv,size_t idx);
 
+	BeamSpot pvBeamSpot(const Vertex &pv,
+	                    const edm::Handle<BeamSpot> &beamSpot,
+	                    const unsigned int bsCovSrc[7],
+	                    double sigmaZ, double beamWidth) const;
+
+	void findVerticesInEvent(const edm::Handle<std::vector<IPTI> > &trackIPTagInfos,
+	                         const TransientTrackBuilder &trackBuilder,
+	                         const ConfigurableVertexReconstructor &vertexReco,
+	                         const edm::Handle<BeamSpot> &beamSpot,
+	                         const unsigned int bsCovSrc[7],
+	                         double sigmaZ, double beamWidth,
+	                         Product &tagInfos);
+
 	struct SVBuilder :
 		public std::unary_function<const VTX&, SecondaryVertex> {
 
@@ -286,6 +303,13 @@ TemplatedSecondaryVertexProducer<IPTI,VTX>::TemplatedSecondaryVertexProducer(
 	}
 	useSVClustering = ( params.existsAs<bool>("useSVClustering") ? params.getParameter<bool>("useSVClustering") : false );
 	useSVMomentum = ( params.existsAs<bool>("useSVMomentum") ? params.getParameter<bool>("useSVMomentum") : false );
+	eventLevelVertexing = ( params.existsAs<bool>("eventLevelVertexing") ? params.getParameter<bool>("eventLevelVertexing") : false );
+	if( eventLevelVertexing && ( useGhostTrack || useExternalSV ) )
+		throw cms::Exception("Configuration")
+			<< "eventLevelVertexing is only supported for the "
+			   "vertex finding on the jet tracks, not with the ghost "
+			   "track finder or with external secondary vertices."
+			<< std::endl;
 	useFatJets = ( useExternalSV && params.exists("fatJets") );
 	useGroomedFatJets = ( useExternalSV && params.exists("groomedFatJets") );
 	if( useSVClustering )
@@ -659,6 +683,14 @@ void TemplatedSecondaryVertexProducer<IPTI,VTX>::produce(edm::Event &event,
 
 	auto tagInfos = std::make_unique<Product>();
 
+	if (eventLevelVertexing) {
+		findVerticesInEvent(trackIPTagInfos, *trackBuilder, *vertexReco,
+		                    beamSpot, bsCovSrc, sigmaZ, beamWidth,
+		                    *tagInfos);
+		event.put(std::move(tagInfos));
+		return;
+	}
+
 	for(typename std::vector<IPTI>::const_iterator iterJets =
 		trackIPTagInfos->begin(); iterJets != trackIPTagInfos->end();
 		++iterJets) {
@@ -796,26 +828,8 @@ void TemplatedSecondaryVertexProducer<IPTI,VTX>::produce(edm::Event &event,
 		    case CONSTRAINT_PV_BEAMSPOT_SIZE:
 		    case CONSTRAINT_PV_BS_Z_ERRORS_SCALED:
 		    case CONSTRAINT_PV_ERROR_SCALED: {
-			BeamSpot::CovarianceMatrix cov;
-			for(unsigned int i = 0; i < 7; i++) {
-				unsigned int covSrc = bsCovSrc[i];
-				for(unsigned int j = 0; j < 7; j++) {
-					double v=0.0;
-					if (!covSrc || bsCovSrc[j] != covSrc)
-						v = 0.0;
-					else if (covSrc == 1)
-						v = beamSpot->covariance(i, j);
-					else if (j<3 && i<3)
-						v = pv.covariance(i, j) *
-						    constraintScaling;
-					cov(i, j) = v;
-				}
-			}
-
-			BeamSpot bs(pv.position(), sigmaZ,
-			            beamSpot.isValid() ? beamSpot->dxdz() : 0.,
-			            beamSpot.isValid() ? beamSpot->dydz() : 0.,
-			            beamWidth, cov, BeamSpot::Unknown);
+			BeamSpot bs = pvBeamSpot(pv, beamSpot, bsCovSrc,
+			                         sigmaZ, beamWidth);
 
 			if (useGhostTrack)
 				fittedSVs = vertexRecoGT->vertices(
@@ -911,6 +925,257 @@ void TemplatedSecondaryVertexProducer<IPTI,VTX>::produce(edm::Event &event,
 	event.put(std::move(tagInfos));
 }
 
+// beam spot centred on the primary vertex, with the covariance taken from the
+// beam spot or the (scaled) primary vertex as configured by the constraint
+template <class IPTI,class VTX>
+BeamSpot TemplatedSecondaryVertexProducer<IPTI,VTX>::pvBeamSpot(
+		const Vertex &pv, const edm::Handle<BeamSpot> &beamSpot,
+		const unsigned int bsCovSrc[7],
+		double sigmaZ, double beamWidth) const
+{
+	BeamSpot::CovarianceMatrix cov;
+	for(unsigned int i = 0; i < 7; i++) {
+		unsigned int covSrc = bsCovSrc[i];
+		for(unsigned int j = 0; j < 7; j++) {
+			double v=0.0;
+			if (!covSrc || bsCovSrc[j] != covSrc)
+				v = 0.0;
+			else if (covSrc == 1)
+				v = beamSpot->covariance(i, j);
+			else if (j<3 && i<3)
+				v = pv.covariance(i, j) *
+				    constraintScaling;
+			cov(i, j) = v;
+		}
+	}
+
+	return BeamSpot(pv.position(), sigmaZ,
+	                beamSpot.isValid() ? beamSpot->dxdz() : 0.,
+	                beamSpot.isValid() ? beamSpot->dydz() : 0.,
+	                beamWidth, cov, BeamSpot::Unknown);
+}
+
+// Event-level mode: the tracks are selected for each jet as usual, but the
+// vertex finding is run only once per primary vertex, on the union of the
+// tracks selected in all jets. A vertex is then given to every jet which
+// contains all its tracks (ignoring those with a weight below
+// minimumTrackWeight and the primary vertex tracks of the fit). Tracks shared
+// by several jets are only built and fitted once, and the per-jet steps run
+// in parallel.
+template <class IPTI,class VTX>
+void TemplatedSecondaryVertexProducer<IPTI,VTX>::findVerticesInEvent(
+		const edm::Handle<std::vector<IPTI> > &trackIPTagInfos,
+		const TransientTrackBuilder &trackBuilder,
+		const ConfigurableVertexReconstructor &vertexReco,
+		const edm::Handle<BeamSpot> &beamSpot,
+		const unsigned int bsCovSrc[7],
+		double sigmaZ, double beamWidth,
+		Product &tagInfos)
+{
+	typedef std::map<const Track *, TransientTrack> TransientTrackMap;
+	typedef typename TemplatedSecondaryVertexTagInfo<IPTI,VTX>::IndexedTrackData IndexedTrackData;
+	typedef typename TemplatedSecondaryVertexTagInfo<IPTI,VTX>::TrackData TrackData;
+	typedef typename TemplatedSecondaryVertexTagInfo<IPTI,VTX>::VertexData VertexData;
+
+	struct JetData {
+		input_container			trackRefs;
+		TrackDataVector			trackData;
+		std::vector<unsigned int>	selected;	// into trackRefs
+		std::vector<TransientTrack>	fitTracks;	// sorted
+		std::vector<SecondaryVertex>	SVs;
+		std::vector<VertexData>		svData;
+	};
+
+	const std::size_t nJets = trackIPTagInfos->size();
+	std::vector<JetData> jets(nJets);
+
+	// select the tracks of every jet
+	tbb::parallel_for(std::size_t(0), nJets, [&](std::size_t iJet) {
+		const IPTI &tagInfo = (*trackIPTagInfos)[iJet];
+		JetData &jet = jets[iJet];
+		const Vertex &pv = *tagInfo.primaryVertex();
+		const Jet &jetRef = *tagInfo.jet();
+
+		std::vector<std::size_t> indices =
+				tagInfo.sortedIndexes(sortCriterium);
+		jet.trackRefs = tagInfo.sortedTracks(indices);
+
+		const std::vector<reco::btag::TrackIPData> &ipData =
+					tagInfo.impactParameterData();
+
+		for(unsigned int i = 0; i < indices.size(); i++) {
+			jet.trackData.push_back(IndexedTrackData());
+			jet.trackData.back().first = indices[i];
+
+			if (!trackSelector(*reco::btag::toTrack(jet.trackRefs[i]),
+			                   ipData[indices[i]], jetRef,
+			                   RecoVertex::convertPos(pv.position()))) {
+				jet.trackData.back().second.svStatus =
+					TrackData::trackSelected;
+				continue;
+			}
+
+			jet.trackData.back().second.svStatus =
+				TrackData::trackUsedForVertexFit;
+			jet.selected.push_back(i);
+		}
+	});
+
+	// group the jets by primary vertex, keeping the jet order
+	std::vector<std::pair<const Vertex *, std::vector<std::size_t> > > groups;
+	for(std::size_t iJet = 0; iJet < nJets; iJet++) {
+		const Vertex *pv = &*(*trackIPTagInfos)[iJet].primaryVertex();
+		std::size_t iGroup = 0;
+		while(iGroup < groups.size() && groups[iGroup].first != pv)
+			iGroup++;
+		if (iGroup == groups.size())
+			groups.push_back(std::make_pair(pv,
+					std::vector<std::size_t>()));
+		groups[iGroup].second.push_back(iJet);
+	}
+
+	for(const auto &group : groups) {
+		const Vertex &pv = *group.first;
+
+		// build the transient tracks once, primary vertex tracks first
+		TransientTrackMap tracksMap;
+		if (constraint == CONSTRAINT_PV_PRIMARIES_IN_FIT) {
+			for(Vertex::trackRef_iterator iter = pv.tracks_begin();
+			    iter != pv.tracks_end(); ++iter)
+				tracksMap.insert(std::make_pair(iter->get(),
+					trackBuilder.build(iter->castTo<TrackRef>())));
+		}
+
+		std::vector<TransientTrack> fitTracks;
+		for(std::size_t iJet : group.second) {
+			JetData &jet = jets[iJet];
+			for(unsigned int i : jet.selected) {
+				const input_item &trackRef = jet.trackRefs[i];
+				const Track *track = reco::btag::toTrack(trackRef);
+				TransientTrackMap::iterator pos =
+					tracksMap.lower_bound(track);
+				if (pos == tracksMap.end() || pos->first != track)
+					pos = tracksMap.insert(pos,
+						std::make_pair(track,
+						trackBuilder.build(trackRef)));
+				jet.fitTracks.push_back(pos->second);
+				fitTracks.push_back(pos->second);
+			}
+			std::sort(jet.fitTracks.begin(), jet.fitTracks.end());
+		}
+
+		// keep the first occurrence of every track, in jet order
+		{
+			std::set<TransientTrack> seen;
+			fitTracks.erase(std::remove_if(fitTracks.begin(), fitTracks.end(),
+				[&seen](const TransientTrack &track)
+				{ return !seen.insert(track).second; }),
+				fitTracks.end());
+		}
+		std::vector<TransientTrack> sortedFitTracks(fitTracks);
+		std::sort(sortedFitTracks.begin(), sortedFitTracks.end());
+
+		// perform the vertex finding on all the tracks of the jets
+
+		std::vector<TransientVertex> fittedSVs;
+		switch(constraint) {
+		    case CONSTRAINT_NONE:
+			fittedSVs = vertexReco.vertices(fitTracks);
+			break;
+
+		    case CONSTRAINT_BEAMSPOT:
+			fittedSVs = vertexReco.vertices(fitTracks, *beamSpot);
+			break;
+
+		    case CONSTRAINT_PV_BEAMSPOT_SIZE:
+		    case CONSTRAINT_PV_BS_Z_ERRORS_SCALED:
+		    case CONSTRAINT_PV_ERROR_SCALED:
+			fittedSVs = vertexReco.vertices(fitTracks,
+				pvBeamSpot(pv, beamSpot, bsCovSrc,
+				           sigmaZ, beamWidth));
+			break;
+
+		    case CONSTRAINT_PV_PRIMARIES_IN_FIT: {
+			std::vector<TransientTrack> primaries;
+			for(Vertex::trackRef_iterator iter = pv.tracks_begin();
+			    iter != pv.tracks_end(); ++iter) {
+				const TransientTrack &track =
+						tracksMap.find(iter->get())->second;
+				if (!std::binary_search(sortedFitTracks.begin(),
+				                        sortedFitTracks.end(), track))
+					primaries.push_back(track);
+			}
+			fittedSVs = vertexReco.vertices(primaries, fitTracks,
+			                                *beamSpot);
+		    }	break;
+		}
+
+		// associate the vertices to the jets, build and filter the SVs
+		tbb::parallel_for(std::size_t(0), group.second.size(),
+		                  [&](std::size_t j) {
+			JetData &jet = jets[group.second[j]];
+			const Jet &jetRef =
+				*(*trackIPTagInfos)[group.second[j]].jet();
+			GlobalVector jetDir(jetRef.momentum().x(),
+			                    jetRef.momentum().y(),
+			                    jetRef.momentum().z());
+
+			std::vector<TransientVertex> jetSVs;
+			for(const TransientVertex &sv : fittedSVs) {
+				bool inJet = false, outOfJet = false;
+				for(const TransientTrack &track : sv.originalTracks()) {
+					if (sv.trackWeight(track) < minTrackWeight ||
+					    !std::binary_search(sortedFitTracks.begin(),
+					                        sortedFitTracks.end(), track))
+						continue;
+					if (std::binary_search(jet.fitTracks.begin(),
+					                       jet.fitTracks.end(), track))
+						inJet = true;
+					else
+						outOfJet = true;
+				}
+				if (inJet && !outOfJet)
+					jetSVs.push_back(sv);
+			}
+
+			SVBuilder svBuilder(pv, jetDir, withPVError, minTrackWeight);
+			std::remove_copy_if(boost::make_transform_iterator(
+						jetSVs.begin(), svBuilder),
+					    boost::make_transform_iterator(
+						jetSVs.end(), svBuilder),
+					    std::back_inserter(jet.SVs),
+					    SVFilter(vertexFilter, pv, jetDir));
+
+			// sort SVs by importance
+
+			std::vector<unsigned int> vtxIndices = vertexSorting(jet.SVs);
+
+			jet.svData.resize(vtxIndices.size());
+			for(unsigned int idx = 0; idx < vtxIndices.size(); idx++) {
+				const SecondaryVertex &sv = jet.SVs[vtxIndices[idx]];
+
+				jet.svData[idx].vertex = sv;
+				jet.svData[idx].dist1d = sv.dist1d();
+				jet.svData[idx].dist2d = sv.dist2d();
+				jet.svData[idx].dist3d = sv.dist3d();
+				jet.svData[idx].direction = flightDirection(pv,sv);
+				// mark tracks successfully used in vertex fit
+				markUsedTracks(jet.trackData,jet.trackRefs,sv,idx);
+			}
+		});
+	}
+
+	// fill result into tag infos
+
+	tagInfos.reserve(nJets);
+	for(std::size_t iJet = 0; iJet < nJets; iJet++)
+		tagInfos.push_back(
+			TemplatedSecondaryVertexTagInfo<IPTI,VTX>(
+				jets[iJet].trackData, jets[iJet].svData,
+				jets[iJet].SVs.size(),
+				edm::Ref<std::vector<IPTI> >(trackIPTagInfos, iJet)));
+}
+
 //Need specialized template because reco::Vertex iterators are TrackBase and it is a mess to make general
 template <>
 void  TemplatedSecondaryVertexProducer<TrackIPTagInfo,reco::Vertex>::markUsedTracks(TrackDataVector & trackData, const input_container & trackRefs, const SecondaryVertex & sv,size_t idx)
@@ -1305,6 +1570,7 @@ void TemplatedSecondaryVertexProducer<IPTI,VTX>::fillDescriptions(edm::Configura
                         edm::ParameterDescription<std::string>("jetAlgorithm", true) and
                         edm::ParameterDescription<double>("rParam", true), true );
   desc.addOptional<bool>("useSVMomentum",false);
+  desc.addOptional<bool>("eventLevelVertexing",false);
   desc.addOptional<double>("ghostRescaling",1e-18);
   desc.addOptional<double>("relPtTolerance",1e-03);
   desc.addOptional<edm::InputTag>("fatJets");
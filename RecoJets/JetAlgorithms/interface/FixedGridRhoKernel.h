@@ -0,0 +1,50 @@
+#ifndef RecoJets_JetAlgorithms_FixedGridRhoKernel_h
+#define RecoJets_JetAlgorithms_FixedGridRhoKernel_h
+
+/** \class FixedGridRhoKernel
+ *
+ * Median pt density on fixed rapidity-phi grids, equivalent to
+ * fastjet::GridMedianBackgroundEstimator but without its per-event
+ * allocations: the tiles of all grids live in one flat array that is
+ * reused from event to event, and the median is found with nth_element.
+ *
+ * Several grids, each covering |y| < maxRapidity with the same requested
+ * spacing, are filled in a single pass over the particles, so the
+ * usual "All" and "Central" flavours of rho cost one loop.
+ *
+ ************************************************************/
+
+#include <vector>
+
+class FixedGridRhoKernel {
+ public:
+  FixedGridRhoKernel(const std::vector<double>& maxRapidities, double gridSpacing);
+
+  /// number of grids
+  unsigned int size() const { return grids_.size(); }
+
+  /// clear all tiles before filling a new event
+  void reset();
+
+  /// add one particle to every grid covering its rapidity
+  void add(double px, double py, double pz, double e);
+
+  /// median pt per unit area of the given grid
+  double rho(unsigned int igrid);
+
+ private:
+  struct Grid {
+    double ymax;
+    double dy;
+    int ny;
+    unsigned int offset; // first tile of this grid in tiles_
+  };
+
+  std::vector<Grid> grids_;
+  int nphi_;
+  double dphi_;
+  std::vector<double> tiles_;       // scalar pt per tile, all grids back to back
+  std::vector<double> scratch_;     // tile densities handed to nth_element
+};
+
+#endif
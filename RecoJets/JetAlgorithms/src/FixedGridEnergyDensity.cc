@@ -33,17 +33,26 @@ float FixedGridEnergyDensity::fixedGridRho(std::vector<float>& etabins,std::vect
      float phidist = phibins[1]-phibins[0];
      float etahalfdist = (etabins[1]-etabins[0])/2.;
      float phihalfdist = (phibins[1]-phibins[0])/2.;
-     vector<float> sumPFNallSMDQ;
-     sumPFNallSMDQ.reserve(etabins.size()*phibins.size());
-     for (unsigned int ieta=0;ieta<etabins.size();++ieta) {
-       for (unsigned int iphi=0;iphi<phibins.size();++iphi) {
-	 float pfniso_ieta_iphi = 0;
-	 for(PFCandidateCollection::const_iterator pf_it = pfCandidates->begin(); pf_it != pfCandidates->end(); pf_it++) {
-	   if (fabs(etabins[ieta]-pf_it->eta())>etahalfdist) continue;
-	   if (fabs(reco::deltaPhi(phibins[iphi],pf_it->phi()))>phihalfdist) continue;
-	   pfniso_ieta_iphi+=pf_it->pt();
-	 }
-	 sumPFNallSMDQ.push_back(pfniso_ieta_iphi);
+     const unsigned int nphi = phibins.size();
+     vector<float> sumPFNallSMDQ(etabins.size()*nphi,0.f);
+     // each candidate is matched once against the eta and the phi bins,
+     // instead of once per (eta,phi) tile; the tile sums are accumulated
+     // in the same candidate order as before
+     vector<unsigned int> phimatch;
+     phimatch.reserve(nphi);
+     for(PFCandidateCollection::const_iterator pf_it = pfCandidates->begin(); pf_it != pfCandidates->end(); pf_it++) {
+       const double eta = pf_it->eta();
+       const double phi = pf_it->phi();
+       const double pt = pf_it->pt();
+       phimatch.clear();
+       for (unsigned int iphi=0;iphi<nphi;++iphi) {
+	 if (fabs(reco::deltaPhi(phibins[iphi],phi))>phihalfdist) continue;
+	 phimatch.push_back(iphi);
+       }
+       if (phimatch.empty()) continue;
+       for (unsigned int ieta=0;ieta<etabins.size();++ieta) {
+	 if (fabs(etabins[ieta]-eta)>etahalfdist) continue;
+	 for (auto iphi : phimatch) sumPFNallSMDQ[ieta*nphi+iphi]+=pt;
        }
      }
      float evt_smdq = 0;
@@ -0,0 +1,75 @@
+#include "RecoJets/JetAlgorithms/interface/FixedGridRhoKernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  constexpr double twopi = 2.*M_PI;
+}
+
+FixedGridRhoKernel::FixedGridRhoKernel(const std::vector<double>& maxRapidities, double gridSpacing)
+{
+  // same tiling as fastjet::RectangularGrid(ymax, spacing)
+  nphi_ = int(twopi/gridSpacing + 0.5);
+  dphi_ = twopi/nphi_;
+  unsigned int ntiles = 0;
+  for (double ymax : maxRapidities) {
+    Grid grid;
+    grid.ymax = ymax;
+    grid.ny = std::max(1, int(2.*ymax/gridSpacing + 0.5));
+    grid.dy = 2.*ymax/grid.ny;
+    grid.offset = ntiles;
+    ntiles += grid.ny*nphi_;
+    grids_.push_back(grid);
+  }
+  tiles_.resize(ntiles, 0.);
+  scratch_.reserve(ntiles);
+}
+
+void FixedGridRhoKernel::reset()
+{
+  std::fill(tiles_.begin(), tiles_.end(), 0.);
+}
+
+void FixedGridRhoKernel::add(double px, double py, double pz, double e)
+{
+  const double kt2 = px*px + py*py;
+  if (kt2 == 0.) return; // no pt to add
+
+  // rapidity and phi computed as in fastjet::PseudoJet
+  const double m2 = std::max(0., (e+pz)*(e-pz) - kt2);
+  const double ePlusPz = e + std::abs(pz);
+  double y = 0.5*std::log((kt2 + m2)/(ePlusPz*ePlusPz));
+  if (pz > 0) y = -y;
+  double phi = std::atan2(py, px);
+  if (phi < 0.) phi += twopi;
+  if (phi >= twopi) phi -= twopi;
+  int iphi = int(phi/dphi_);
+  if (iphi == nphi_) iphi = 0;
+  const double pt = std::sqrt(kt2);
+
+  for (auto const& grid : grids_) {
+    // as fastjet::RectangularGrid::tile_index, rounding included
+    const int iy = int(std::floor((y + grid.ymax)/grid.dy));
+    if (iy < 0 || iy >= grid.ny) continue;
+    tiles_[grid.offset + iy*nphi_ + iphi] += pt;
+  }
+}
+
+double FixedGridRhoKernel::rho(unsigned int igrid)
+{
+  auto const& grid = grids_[igrid];
+  const unsigned int n = grid.ny*nphi_;
+  const double tileArea = grid.dy*dphi_;
+  scratch_.resize(n);
+  for (unsigned int i = 0; i < n; ++i) scratch_[i] = tiles_[grid.offset + i]/tileArea;
+
+  // median with the same interpolation as fastjet's 50% percentile
+  if (n == 1) return scratch_[0];
+  auto mid = scratch_.begin() + (n-1)/2;
+  std::nth_element(scratch_.begin(), mid, scratch_.end());
+  const double lo = *mid;
+  if (n % 2) return lo;
+  const double hi = *std::min_element(mid+1, scratch_.end());
+  return lo*(1. - 0.5) + hi*0.5;
+}
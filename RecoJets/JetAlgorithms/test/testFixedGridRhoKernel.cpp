@@ -0,0 +1,62 @@
+// Compares FixedGridRhoKernel with fastjet::GridMedianBackgroundEstimator, as used
+// before by FixedGridRhoProducerFastjet: rho must be identical for every range, on
+// events of random massless and massive particles, with particles beyond and exactly
+// at the edges of the ranges, empty events, and grids reused from event to event.
+
+#include "RecoJets/JetAlgorithms/interface/FixedGridRhoKernel.h"
+
+#include "fastjet/PseudoJet.hh"
+#include "fastjet/tools/GridMedianBackgroundEstimator.hh"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main() {
+  const double gridSpacing = 0.55;
+  // the standard ranges, the odd number of tiles of a single row, and ranges not
+  // multiple of the spacing
+  const std::vector<double> maxRapidities = {2.5, 3.0, 4.4, 5.0, 0.2, 1.234};
+
+  FixedGridRhoKernel kernel(maxRapidities, gridSpacing);
+  std::vector<fastjet::GridMedianBackgroundEstimator> estimators;
+  for (double ymax : maxRapidities) estimators.emplace_back(ymax, gridSpacing);
+
+  std::mt19937 eng(42);
+  std::uniform_real_distribution<double> unit(0., 1.);
+  std::exponential_distribution<double> pt(1.);
+
+  int nFailed = 0;
+  for (int ievent = 0; ievent < 200; ++ievent) {
+    // from empty events to more particles than tiles
+    const int n = ievent%20 == 0 ? 0 : int(3000*unit(eng)*unit(eng));
+    std::vector<fastjet::PseudoJet> particles;
+    for (int i = 0; i < n; ++i) {
+      double y = -6. + 12.*unit(eng);
+      // a few at the edges of the ranges
+      if (unit(eng) < 0.02) y = std::copysign(maxRapidities[i%maxRapidities.size()], y);
+      const double phi = 2.*M_PI*unit(eng) - M_PI;
+      const double p = 0.2 + pt(eng);
+      const double m = unit(eng) < 0.5 ? 0. : 0.13957;
+      const double mt = std::sqrt(p*p + m*m);
+      particles.emplace_back(p*std::cos(phi), p*std::sin(phi), mt*std::sinh(y), mt*std::cosh(y));
+    }
+
+    kernel.reset();
+    for (auto const& p : particles) kernel.add(p.px(), p.py(), p.pz(), p.E());
+    for (unsigned int igrid = 0; igrid < maxRapidities.size(); ++igrid) {
+      estimators[igrid].set_particles(particles);
+      const double expected = estimators[igrid].rho();
+      const double rho = kernel.rho(igrid);
+      if (rho != expected) {
+        std::cout << "event " << ievent << " with " << n << " particles, |y| < " << maxRapidities[igrid]
+                  << ": rho " << rho << " from the kernel, " << expected << " from fastjet" << std::endl;
+        ++nFailed;
+      }
+    }
+  }
+  if (nFailed) return 1;
+  std::cout << "rho of the kernel identical to fastjet for " << maxRapidities.size() << " ranges" << std::endl;
+  return 0;
+}
@@ -0,0 +1,65 @@
+#ifndef RecoJets_JetProducers_SharedJetInputs_h
+#define RecoJets_JetProducers_SharedJetInputs_h
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// SharedJetInputs
+// ---------------
+//
+// Fastjet inputs of a jet producer, and optionally the explicit ghosts it
+// clusters with, put in the event ("writeSharedInputs") for the other jet
+// producers of the same event clustering the same candidates with another
+// radius or algorithm ("sharedInputs"). The keys hold everything that changes
+// the content, and a producer reading the product checks them against its own
+// configuration. The user_index of the inputs is the index of the candidate
+// in the source collection, as for the inputs converted by the producer.
+//
+// Transient: PseudoJets are not persistent.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "fastjet/PseudoJet.hh"
+
+#include <string>
+#include <vector>
+
+
+class SharedJetInputs
+{
+public:
+  // everything that changes the content of the converted inputs
+  struct InputKey {
+    std::string  src;
+    std::string  jetType;
+    double       inputEtMin = 0;
+    double       inputEMin = 0;
+    bool         restrictInputs = false;
+    unsigned int maxInputs = 0;
+    bool operator==(const InputKey& o) const {
+      return src==o.src && jetType==o.jetType && inputEtMin==o.inputEtMin &&
+	inputEMin==o.inputEMin && restrictInputs==o.restrictInputs && maxInputs==o.maxInputs;
+    }
+  };
+
+  // everything that changes the ghosts generated by GhostedAreaSpec::add_ghosts
+  // with one repeat: the specification and the deterministic seeds of the event
+  struct GhostKey {
+    double           ghostEtaMax = 0;
+    double           ghostArea = 0;
+    std::vector<int> seeds;
+    bool operator==(const GhostKey& o) const {
+      return ghostEtaMax==o.ghostEtaMax && ghostArea==o.ghostArea && seeds==o.seeds;
+    }
+  };
+
+  InputKey                        inputKey;
+  std::vector<fastjet::PseudoJet> inputs;
+
+  bool                            hasGhosts = false;
+  GhostKey                        ghostKey;
+  std::vector<fastjet::PseudoJet> ghosts;
+  double                          actualGhostArea = 0;
+};
+
+
+#endif
@@ -81,16 +81,10 @@ void CATopJetProducer::produce(  edm::Event & e, const edm::EventSetup & c )
 
 void CATopJetProducer::runAlgorithm( edm::Event& iEvent, const edm::EventSetup& iSetup)
 {
-  if ( !doAreaFastjet_ && !doRhoFastjet_) {
-    fjClusterSeq_ = ClusterSequencePtr( new fastjet::ClusterSequence( fjInputs_, *fjJetDefinition_ ) );
-  } else if (voronoiRfact_ <= 0) {
-    fjClusterSeq_ = ClusterSequencePtr( new fastjet::ClusterSequenceArea( fjInputs_, *fjJetDefinition_ , *fjAreaDefinition_ ) );
-  } else {
-    fjClusterSeq_ = ClusterSequencePtr( new fastjet::ClusterSequenceVoronoiArea( fjInputs_, *fjJetDefinition_ , fastjet::VoronoiAreaSpec(voronoiRfact_) ) );
-  }
+  makeClusterSequence();
 
   if (tagAlgo_ == CA_TOPTAGGER){
-	(*legacyCMSTopTagger_).run( fjInputs_, fjJets_, fjClusterSeq_ );
+	(*legacyCMSTopTagger_).run( clusteringInputs(), fjJets_, fjClusterSeq_ );
 	
   }
   else {
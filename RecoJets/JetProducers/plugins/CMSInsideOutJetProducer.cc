@@ -60,6 +60,7 @@ CMSInsideOutJetProducer::CMSInsideOutJetProducer(const edm::ParameterSet& iConfi
 	  iConfig.getParameter<double>("maxSize"), 
 	  iConfig.getParameter<double>("minSize") )
 {
+  rejectSharedInputs("CMSInsideOutJetProducer");
 }
 
 
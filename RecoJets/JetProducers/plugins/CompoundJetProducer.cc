@@ -15,6 +15,8 @@ CompoundJetProducer::CompoundJetProducer(edm::ParameterSet const& conf):
 
   produces<reco::BasicJetCollection>();
   // the subjet collections are set through the config file in the "jetCollInstanceName" field.
+
+  rejectSharedInputs("CompoundJetProducer");
 }
 
 
@@ -162,6 +162,9 @@ FastjetJetProducer::FastjetJetProducer(const edm::ParameterSet& iConfig):
 	
 	if ( ( correctShape_ ) && ( ( gridMaxRapidity_ == -1 ) || ( gridSpacing_ == -1 )) ) 
 		throw cms::Exception("correctShape") << "Parameters gridMaxRapidity and/or gridSpacing for SoftDrop are not defined." << std::endl;
+
+	// track jets are clustered per vertex from their own inputs
+	if ( makeTrackJet(jetTypeE) ) rejectSharedInputs("FastjetJetProducer for track jets");
   
 }
 
@@ -352,13 +355,7 @@ void FastjetJetProducer::runAlgorithm( edm::Event & iEvent, edm::EventSetup cons
   fin.close();
   */
 
-  if ( !doAreaFastjet_ && !doRhoFastjet_) {
-    fjClusterSeq_ = ClusterSequencePtr( new fastjet::ClusterSequence( fjInputs_, *fjJetDefinition_ ) );
-  } else if (voronoiRfact_ <= 0) {
-    fjClusterSeq_ = ClusterSequencePtr( new fastjet::ClusterSequenceArea( fjInputs_, *fjJetDefinition_ , *fjAreaDefinition_ ) );
-  } else {
-    fjClusterSeq_ = ClusterSequencePtr( new fastjet::ClusterSequenceVoronoiArea( fjInputs_, *fjJetDefinition_ , fastjet::VoronoiAreaSpec(voronoiRfact_) ) );
-  }
+  makeClusterSequence();
 
   if ( !(useMassDropTagger_ || useCMSBoostedTauSeedingAlgorithm_ || useTrimming_ || useFiltering_ || usePruning_ || useSoftDrop_ || useConstituentSubtraction_ ) ) {
     fjJets_ = fastjet::sorted_by_pt(fjClusterSeq_->inclusive_jets(jetPtMin_));
@@ -375,7 +372,7 @@ void FastjetJetProducer::runAlgorithm( edm::Event & iEvent, edm::EventSetup cons
     if ( useConstituentSubtraction_ ) {
       fastjet::Selector rho_range =  fastjet::SelectorAbsRapMax(csRho_EtaMax_);
       bge_rho = unique_ptr<fastjet::JetMedianBackgroundEstimator> (new  fastjet::JetMedianBackgroundEstimator(rho_range, fastjet::JetDefinition(fastjet::kt_algorithm, csRParam_), *fjAreaDefinition_) );
-      bge_rho->set_particles(fjInputs_);
+      bge_rho->set_particles(clusteringInputs());
       fastjet::contrib::ConstituentSubtractor * constituentSubtractor = new fastjet::contrib::ConstituentSubtractor(bge_rho.get());
 
       transformers.push_back( transformer_ptr(constituentSubtractor) );
@@ -422,7 +419,7 @@ void FastjetJetProducer::runAlgorithm( edm::Event & iEvent, edm::EventSetup cons
     unique_ptr<fastjet::GridMedianBackgroundEstimator> bge_rho_grid;
     if ( correctShape_ ) {
       bge_rho_grid = unique_ptr<fastjet::GridMedianBackgroundEstimator> (new  fastjet::GridMedianBackgroundEstimator(gridMaxRapidity_, gridSpacing_) );
-      bge_rho_grid->set_particles(fjInputs_);
+      bge_rho_grid->set_particles(clusteringInputs());
       subtractor = unique_ptr<fastjet::Subtractor>( new fastjet::Subtractor(  bge_rho_grid.get()) );
       subtractor->set_use_rho_m();
       //subtractor->use_common_bge_for_rho_and_rhom(true);
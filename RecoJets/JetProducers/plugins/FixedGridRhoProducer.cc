@@ -27,13 +27,10 @@ void FixedGridRhoProducer::produce(edm::Event& iEvent, const edm::EventSetup& iS
    edm::Handle<reco::PFCandidateCollection> pfColl;
    iEvent.getByToken(input_pfcoll_token_, pfColl);
 
-   algo = new FixedGridEnergyDensity(pfColl.product());
+   FixedGridEnergyDensity algo(pfColl.product());
 
-   double result = algo->fixedGridRho(myEtaRegion);
+   double result = algo.fixedGridRho(myEtaRegion);
    iEvent.put(std::make_unique<double>(result));
-
-   delete algo;
- 
 }
 
 DEFINE_FWK_MODULE(FixedGridRhoProducer);
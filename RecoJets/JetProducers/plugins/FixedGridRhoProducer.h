@@ -17,7 +17,6 @@ class FixedGridRhoProducer : public edm::stream::EDProducer<> {
 
   edm::InputTag pfCandidatesTag_;
   FixedGridEnergyDensity::EtaRegion myEtaRegion;
-  FixedGridEnergyDensity* algo; 
 
   edm::EDGetTokenT<reco::PFCandidateCollection> input_pfcoll_token_;
 
@@ -6,12 +6,36 @@
 
 using namespace std;
 
+namespace {
+  // the main range has the empty instance label, the additional ones their own
+  std::vector<std::string> instanceLabels(const edm::ParameterSet& iConfig) {
+    std::vector<std::string> labels(1, "");
+    if (iConfig.exists("additionalRanges")) {
+      for (auto const& range : iConfig.getParameter<std::vector<edm::ParameterSet> >("additionalRanges")) {
+	labels.push_back(range.getParameter<std::string>("label"));
+      }
+    }
+    return labels;
+  }
+
+  std::vector<double> maxRapidities(const edm::ParameterSet& iConfig) {
+    std::vector<double> ymax(1, iConfig.getParameter<double>("maxRapidity"));
+    if (iConfig.exists("additionalRanges")) {
+      for (auto const& range : iConfig.getParameter<std::vector<edm::ParameterSet> >("additionalRanges")) {
+	ymax.push_back(range.getParameter<double>("maxRapidity"));
+      }
+    }
+    return ymax;
+  }
+}
+
 FixedGridRhoProducerFastjet::FixedGridRhoProducerFastjet(const edm::ParameterSet& iConfig) :
-  bge_( iConfig.getParameter<double>("maxRapidity"),
-	iConfig.getParameter<double>("gridSpacing") )
+  instanceLabels_( instanceLabels(iConfig) ),
+  kernel_( maxRapidities(iConfig),
+	   iConfig.getParameter<double>("gridSpacing") )
 {
   pfCandidatesTag_ = iConfig.getParameter<edm::InputTag>("pfCandidatesTag");
-  produces<double>();
+  for (auto const& label : instanceLabels_) produces<double>(label);
 
   input_pfcoll_token_ = consumes<edm::View<reco::Candidate> >(pfCandidatesTag_);
 
@@ -23,13 +47,15 @@ void FixedGridRhoProducerFastjet::produce(edm::Event& iEvent, const edm::EventSe
 
    edm::Handle< edm::View<reco::Candidate> > pfColl;
    iEvent.getByToken(input_pfcoll_token_, pfColl);
-   std::vector<fastjet::PseudoJet> inputs;
+   // one pass over the candidates fills the grids of all ranges
+   kernel_.reset();
    for ( edm::View<reco::Candidate>::const_iterator ibegin = pfColl->begin(),
 	   iend = pfColl->end(), i = ibegin; i != iend; ++i ){
-     inputs.push_back( fastjet::PseudoJet(i->px(), i->py(), i->pz(), i->energy()) );
+     kernel_.add(i->px(), i->py(), i->pz(), i->energy());
+   }
+   for (unsigned int igrid = 0; igrid < kernel_.size(); ++igrid) {
+     iEvent.put(std::make_unique<double>(kernel_.rho(igrid)), instanceLabels_[igrid]);
    }
-   bge_.set_particles(inputs);
-   iEvent.put(std::make_unique<double>(bge_.rho()));
 }
 
 DEFINE_FWK_MODULE(FixedGridRhoProducerFastjet);
@@ -6,7 +6,7 @@
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "DataFormats/ParticleFlowCandidate/interface/PFCandidateFwd.h"
 #include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
-#include "fastjet/tools/GridMedianBackgroundEstimator.hh"
+#include "RecoJets/JetAlgorithms/interface/FixedGridRhoKernel.h"
 
 
 class FixedGridRhoProducerFastjet : public edm::stream::EDProducer<> {
@@ -19,7 +19,9 @@ class FixedGridRhoProducerFastjet : public edm::stream::EDProducer<> {
   void produce(edm::Event&, const edm::EventSetup&) override;
 
   edm::InputTag pfCandidatesTag_;
-  fastjet::GridMedianBackgroundEstimator bge_;
+  // grid 0 is the main maxRapidity, the others are the additionalRanges
+  std::vector<std::string> instanceLabels_;
+  FixedGridRhoKernel kernel_;
 
   edm::EDGetTokenT<edm::View<reco::Candidate> > input_pfcoll_token_;
 
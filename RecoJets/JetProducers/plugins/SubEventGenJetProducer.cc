@@ -41,6 +41,8 @@ SubEventGenJetProducer::SubEventGenJetProducer(edm::ParameterSet const& conf):
 
    input_cand_token_ = consumes<reco::CandidateView>(src_);
 
+   // the inputs are split per sub-event
+   rejectSharedInputs("SubEventGenJetProducer");
 }
 
 
@@ -58,6 +58,8 @@ SubjetFilterJetProducer::SubjetFilterJetProducer(const edm::ParameterSet& iConfi
   produces<reco::BasicJetCollection>("fat");
   makeProduces(moduleLabel_,"sub");
   makeProduces(moduleLabel_,"filter");
+
+  rejectSharedInputs("SubjetFilterJetProducer");
 }
 
 
@@ -44,6 +44,7 @@
 #include "fastjet/CMSIterativeConePlugin.hh"
 #include "fastjet/ATLASConePlugin.hh"
 #include "fastjet/CDFMidPointPlugin.hh"
+#include "fastjet/ClusterSequenceActiveAreaExplicitGhosts.hh"
 
 #include <iostream>
 #include <memory>
@@ -159,6 +160,9 @@ VirtualJetProducer::VirtualJetProducer(const edm::ParameterSet& iConfig) {
 	useDeterministicSeed_ 	= iConfig.getParameter<bool>	("useDeterministicSeed");
 	minSeed_ 		= iConfig.getParameter<unsigned int>("minSeed");
 	verbosity_ 		= iConfig.getParameter<int>	("verbosity");
+	writeSharedInputs_ 	= iConfig.getParameter<bool>	("writeSharedInputs");
+	sharedInputs_ 		= iConfig.getParameter<edm::InputTag>("sharedInputs");
+	shareGhosts_ 		= iConfig.getParameter<bool>	("shareGhosts");
 
 	anomalousTowerDef_ = auto_ptr<AnomalousTower>(new AnomalousTower(iConfig));
 
@@ -168,6 +172,8 @@ VirtualJetProducer::VirtualJetProducer(const edm::ParameterSet& iConfig) {
 	input_packedcandidatefwdptr_token_ = consumes<vector<edm::FwdPtr<pat::PackedCandidate> > >(iConfig.getParameter<edm::InputTag>("src"));
 	input_gencandidatefwdptr_token_ = consumes<vector<edm::FwdPtr<reco::GenParticle> > >(iConfig.getParameter<edm::InputTag>("src"));
 	input_packedgencandidatefwdptr_token_ = consumes<vector<edm::FwdPtr<pat::PackedGenParticle> > >(iConfig.getParameter<edm::InputTag>("src"));
+	if ( !sharedInputs_.label().empty() )
+		input_sharedinputs_token_ = consumes<SharedJetInputs>(sharedInputs_);
 	
 	//
 	// additional parameters to think about:
@@ -240,6 +246,21 @@ VirtualJetProducer::VirtualJetProducer(const edm::ParameterSet& iConfig) {
 		fjSelector_ =  SelectorPtr( new fastjet::Selector( fastjet::SelectorAbsRapMax(rhoEtaMax_) ) );
 	} 
 
+	// the shared inputs must not depend on per-module corrections
+	const bool readSharedInputs = !sharedInputs_.label().empty();
+	if ( writeSharedInputs_ && readSharedInputs )
+		throw cms::Exception("Configuration") << "writeSharedInputs and sharedInputs cannot be used together.\n";
+	if ( ( writeSharedInputs_ || readSharedInputs ) && ( makeCaloJet(jetTypeE) || doPUOffsetCorr_ ) )
+		throw cms::Exception("Configuration") << "writeSharedInputs and sharedInputs cannot be used for CaloJets or with doPUOffsetCorr.\n";
+
+	// shared ghosts replace the ghosts of a single active_area_explicit_ghosts repeat,
+	// and are the same as the producer would generate itself only with the
+	// deterministic seed of the event
+	if ( shareGhosts_ && !writeSharedInputs_ && !readSharedInputs )
+		throw cms::Exception("Configuration") << "shareGhosts requires writeSharedInputs or sharedInputs.\n";
+	if ( shareGhosts_ && ( fjAreaDefinition_.get() == nullptr || !useExplicitGhosts_ || activeAreaRepeats_ != 1 || !useDeterministicSeed_ ) )
+		throw cms::Exception("Configuration") << "shareGhosts requires active areas with useExplicitGhosts, Active_Area_Repeats = 1 and useDeterministicSeed.\n";
+
 	if( ( doFastJetNonUniform_ ) && ( puCenters_.empty() ) ) 
 		throw cms::Exception("doFastJetNonUniform") << "Parameter puCenters for doFastJetNonUniform is not defined." << std::endl;
   
@@ -249,6 +270,7 @@ VirtualJetProducer::VirtualJetProducer(const edm::ParameterSet& iConfig) {
 	produces<vector<double> >("sigmas");
 	produces<double>("rho");
 	produces<double>("sigma");
+	if ( writeSharedInputs_ ) produces<SharedJetInputs>();
 
   
 }
@@ -272,6 +294,7 @@ void VirtualJetProducer::produce(edm::Event& iEvent,const edm::EventSetup& iSetu
   // NOTE!!! The fastjet random number sequence is a global singleton.
   // Thus, we have to create an object and get access to the global singleton
   // in order to change it. 
+  ghostSeeds_.clear();
   if ( useDeterministicSeed_ ) {
     fastjet::GhostedAreaSpec gas;
     std::vector<int> seeds(2);
@@ -280,7 +303,9 @@ void VirtualJetProducer::produce(edm::Event& iEvent,const edm::EventSetup& iSetu
     seeds[0] = std::max(runNum_uint,minSeed_ + 3) + 3 * evNum_uint;
     seeds[1] = std::max(runNum_uint,minSeed_ + 5) + 5 * evNum_uint;
     gas.set_random_status(seeds);
+    ghostSeeds_ = seeds;
   }
+  sharedInputsInEvent_ = nullptr;
 
   LogDebug("VirtualJetProducer") << "Entered produce\n";
   //determine signal vertex2
@@ -315,6 +340,7 @@ void VirtualJetProducer::produce(edm::Event& iEvent,const edm::EventSetup& iSetu
   bool isView = iEvent.getByToken(input_candidateview_token_, inputsHandle);
   if ( isView ) {
     if ( inputsHandle->empty()) {
+      if ( writeSharedInputs_ ) writeSharedInputs( iEvent, false );
       output( iEvent, iSetup );
       return;
     }
@@ -329,6 +355,7 @@ void VirtualJetProducer::produce(edm::Event& iEvent,const edm::EventSetup& iSetu
     
     if ( isPF ) {
       if ( pfinputsHandleAsFwdPtr->empty()) {
+	if ( writeSharedInputs_ ) writeSharedInputs( iEvent, false );
 	output( iEvent, iSetup );
 	return;
       }
@@ -342,6 +369,7 @@ void VirtualJetProducer::produce(edm::Event& iEvent,const edm::EventSetup& iSetu
       }
     } else if ( isPFFwdPtr ) {
       if ( packedinputsHandleAsFwdPtr->empty()) {
+	if ( writeSharedInputs_ ) writeSharedInputs( iEvent, false );
 	output( iEvent, iSetup );
 	return;
       }
@@ -355,6 +383,7 @@ void VirtualJetProducer::produce(edm::Event& iEvent,const edm::EventSetup& iSetu
       }
     } else if ( isGen ) {
       if ( geninputsHandleAsFwdPtr->empty()) {
+	if ( writeSharedInputs_ ) writeSharedInputs( iEvent, false );
 	output( iEvent, iSetup );
 	return;
       }
@@ -368,6 +397,7 @@ void VirtualJetProducer::produce(edm::Event& iEvent,const edm::EventSetup& iSetu
       }
     } else if ( isGenFwdPtr ) {
       if ( geninputsHandleAsFwdPtr->empty()) {
+	if ( writeSharedInputs_ ) writeSharedInputs( iEvent, false );
 	output( iEvent, iSetup );
 	return;
       }
@@ -389,8 +419,14 @@ void VirtualJetProducer::produce(edm::Event& iEvent,const edm::EventSetup& iSetu
   // Convert candidates to fastjet::PseudoJets.
   // Also correct to Primary Vertex. Will modify fjInputs_
   // and use inputs_
-  fjInputs_.reserve(inputs_.size());
-  inputTowers();
+  // Or take them from another producer of the same event.
+  if ( !sharedInputs_.label().empty() ) {
+    readSharedInputs( iEvent );
+  } else {
+    fjInputs_.reserve(inputs_.size());
+    inputTowers();
+    if ( writeSharedInputs_ ) writeSharedInputs( iEvent, shareGhosts_ );
+  }
   LogDebug("VirtualJetProducer") << "Inputted towers\n";
 
   // For Pileup subtraction using offset correction:
@@ -437,6 +473,7 @@ void VirtualJetProducer::produce(edm::Event& iEvent,const edm::EventSetup& iSetu
   decltype(fjInputs_)().swap(fjInputs_);
   decltype(fjJets_)().swap(fjJets_);
   decltype(inputs_)().swap(inputs_);  
+  sharedInputsInEvent_ = nullptr;
 
   return;
 }
@@ -486,6 +523,88 @@ void VirtualJetProducer::inputTowers( )
   }
 }
 
+//______________________________________________________________________________
+SharedJetInputs::InputKey VirtualJetProducer::sharedInputKey() const
+{
+  SharedJetInputs::InputKey key;
+  key.src            = src_.encode();
+  key.jetType        = jetType_;
+  key.inputEtMin     = inputEtMin_;
+  key.inputEMin      = inputEMin_;
+  key.restrictInputs = restrictInputs_;
+  key.maxInputs      = maxInputs_;
+  return key;
+}
+
+//______________________________________________________________________________
+SharedJetInputs::GhostKey VirtualJetProducer::sharedGhostKey() const
+{
+  SharedJetInputs::GhostKey key;
+  key.ghostEtaMax = ghostEtaMax_;
+  key.ghostArea   = ghostArea_;
+  key.seeds       = ghostSeeds_;
+  return key;
+}
+
+//______________________________________________________________________________
+void VirtualJetProducer::writeSharedInputs( edm::Event & iEvent, bool withGhosts )
+{
+  auto shared = std::make_unique<SharedJetInputs>();
+  shared->inputKey = sharedInputKey();
+  shared->inputs.swap(fjInputs_);
+  if ( withGhosts ) {
+    // the ghosts active_area_explicit_ghosts would generate at clustering,
+    // the random status being already set to the seeds of the event
+    shared->hasGhosts = true;
+    shared->ghostKey = sharedGhostKey();
+    fjActiveArea_->add_ghosts(shared->ghosts);
+    shared->actualGhostArea = fjActiveArea_->actual_ghost_area();
+  }
+  sharedInputsInEvent_ = iEvent.put(std::move(shared)).product();
+}
+
+//______________________________________________________________________________
+void VirtualJetProducer::readSharedInputs( const edm::Event & iEvent )
+{
+  edm::Handle<SharedJetInputs> shared;
+  iEvent.getByToken(input_sharedinputs_token_, shared);
+  if ( !(shared->inputKey == sharedInputKey()) )
+    throw cms::Exception("Configuration") << "The SharedJetInputs " << sharedInputs_.encode()
+					  << " were converted from other inputs or with another input selection.\n";
+  if ( shareGhosts_ && !( shared->hasGhosts && shared->ghostKey == sharedGhostKey() ) )
+    throw cms::Exception("Configuration") << "The SharedJetInputs " << sharedInputs_.encode()
+					  << " have no ghosts or ghosts of another specification.\n";
+  sharedInputsInEvent_ = shared.product();
+}
+
+//______________________________________________________________________________
+void VirtualJetProducer::rejectSharedInputs( const std::string & producer ) const
+{
+  if ( writeSharedInputs_ || !sharedInputs_.label().empty() || shareGhosts_ )
+    throw cms::Exception("Configuration") << producer << " does not support writeSharedInputs, sharedInputs or shareGhosts.\n";
+}
+
+//______________________________________________________________________________
+void VirtualJetProducer::makeClusterSequence()
+{
+  auto const & inputs = clusteringInputs();
+  if ( !doAreaFastjet_ && !doRhoFastjet_) {
+    fjClusterSeq_ = ClusterSequencePtr( new fastjet::ClusterSequence( inputs, *fjJetDefinition_ ) );
+  } else if (voronoiRfact_ <= 0) {
+    if ( shareGhosts_ ) {
+      // same ghosts as active_area_explicit_ghosts would generate, but only
+      // once per event for all the producers sharing the inputs
+      fjClusterSeq_ = ClusterSequencePtr( new fastjet::ClusterSequenceActiveAreaExplicitGhosts( inputs, *fjJetDefinition_,
+												sharedInputsInEvent_->ghosts,
+												sharedInputsInEvent_->actualGhostArea ) );
+    } else {
+      fjClusterSeq_ = ClusterSequencePtr( new fastjet::ClusterSequenceArea( inputs, *fjJetDefinition_ , *fjAreaDefinition_ ) );
+    }
+  } else {
+    fjClusterSeq_ = ClusterSequencePtr( new fastjet::ClusterSequenceVoronoiArea( inputs, *fjJetDefinition_ , fastjet::VoronoiAreaSpec(voronoiRfact_) ) );
+  }
+}
+
 //______________________________________________________________________________
 bool VirtualJetProducer::isAnomalousTower(reco::CandidatePtr input)
 {
@@ -1034,6 +1153,9 @@ void VirtualJetProducer::fillDescriptionsFromVirtualJetProducer(edm::ParameterSe
 	desc.add<bool> 	("useDeterministicSeed",false 	);
 	desc.add<unsigned int> 	("minSeed", 	14327 	);
 	desc.add<int> 	("verbosity", 		0 	);
+	desc.add<bool> 	("writeSharedInputs", 	false 	);
+	desc.add<edm::InputTag>("sharedInputs", 	edm::InputTag() );
+	desc.add<bool> 	("shareGhosts", 	false 	);
 	desc.add<double>("puWidth",	 	0. 	);
 	desc.add<unsigned int>("nExclude", 	0 	);
 	desc.add<unsigned int>("maxBadEcalCells", 	9999999	);
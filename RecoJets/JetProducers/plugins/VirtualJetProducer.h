@@ -21,6 +21,7 @@
 
 #include "RecoJets/JetProducers/interface/PileUpSubtractor.h"
 #include "RecoJets/JetProducers/interface/AnomalousTower.h"
+#include "RecoJets/JetProducers/interface/SharedJetInputs.h"
 
 #include "fastjet/JetDefinition.hh"
 #include "fastjet/ClusterSequence.hh"
@@ -132,6 +133,20 @@ protected:
 					      const edm::EventSetup& iSetup,
 					      edm::OrphanHandle<reco::BasicJetCollection> & oh){};
  
+  // The inputs to cluster: fjInputs_, or those read from or written to the
+  // SharedJetInputs of the event.
+  const std::vector<fastjet::PseudoJet>& clusteringInputs() const {
+    return sharedInputsInEvent_ ? sharedInputsInEvent_->inputs : fjInputs_;
+  }
+
+  // Build fjClusterSeq_ from clusteringInputs() with the configured area
+  // definition, and with the ghosts of the SharedJetInputs if "shareGhosts".
+  void makeClusterSequence();
+
+  // For the producers that do not cluster through makeClusterSequence():
+  // throws if one of the sharing options is set.
+  void rejectSharedInputs(const std::string& producer) const;
+
   // Do the offset correction. 
   // Only runs if "doPUOffsetCorrection_" is true.  
   void offsetCorrectJets(std::vector<fastjet::PseudoJet> & orphanInput);
@@ -220,10 +235,25 @@ protected:
   bool                            useDeterministicSeed_; // If desired, use a deterministic seed to fastjet
   unsigned int                    minSeed_;              // minimum seed to use, useful for MC generation
 
+  // sharing of inputs and ghosts with other jet producers through the event
+  bool                            writeSharedInputs_;  // put fjInputs_ in the event as SharedJetInputs
+  edm::InputTag                   sharedInputs_;       // SharedJetInputs to cluster instead of converting src_
+  bool                            shareGhosts_;        // also write / read the explicit ghosts
+  const SharedJetInputs*          sharedInputsInEvent_ = nullptr;  // written or read in this event
+  std::vector<int>                ghostSeeds_;         // deterministic seeds of this event, if any
+
   int                   verbosity_;                 // flag to enable/disable debug output
   bool                  fromHTTTopJetProducer_ = false;   // for running the v2.0 HEPTopTagger
 
 private:
+  // keys of the SharedJetInputs this producer writes or can read
+  SharedJetInputs::InputKey sharedInputKey() const;
+  SharedJetInputs::GhostKey sharedGhostKey() const;
+  // move fjInputs_ (and the ghosts of the event) into the event
+  void writeSharedInputs(edm::Event& iEvent, bool withGhosts);
+  // take the inputs (and ghosts) of the event, checking their keys
+  void readSharedInputs(const edm::Event& iEvent);
+
   std::auto_ptr<AnomalousTower>   anomalousTowerDef_;  // anomalous tower definition
 
   // tokens for the data access
@@ -232,6 +262,7 @@ private:
   edm::EDGetTokenT<std::vector<edm::FwdPtr<pat::PackedCandidate> > > input_packedcandidatefwdptr_token_;
   edm::EDGetTokenT<std::vector<edm::FwdPtr<reco::GenParticle> > > input_gencandidatefwdptr_token_;
   edm::EDGetTokenT<std::vector<edm::FwdPtr<pat::PackedGenParticle> > > input_packedgencandidatefwdptr_token_;
+  edm::EDGetTokenT<SharedJetInputs> input_sharedinputs_token_;
   
  protected:
   edm::EDGetTokenT<reco::VertexCollection> input_vertex_token_;
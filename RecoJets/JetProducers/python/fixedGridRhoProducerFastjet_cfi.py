@@ -14,6 +14,8 @@ fixedGridRhoFastjetAllCalo = cms.EDProducer("FixedGridRhoProducerFastjet",
     gridSpacing = cms.double(0.55)
 )
 
-
-
-
+# Further rapidity ranges computed in the same pass over the candidates can be
+# requested with e.g.
+#   additionalRanges = cms.VPSet(cms.PSet(label = cms.string("Central"),
+#                                         maxRapidity = cms.double(2.5)))
+# each of them is put in the event with its label as instance name.
@@ -0,0 +1,9 @@
+#include "RecoJets/JetProducers/interface/SharedJetInputs.h"
+#include "DataFormats/Common/interface/Wrapper.h"
+
+namespace RecoJets_JetProducers {
+  struct dictionary {
+    SharedJetInputs sji;
+    edm::Wrapper<SharedJetInputs> wsji;
+  };
+}
@@ -10,6 +10,7 @@
 #include <vector>
 
 class PixelGeomDetUnit;
+class SiPixelGainCalibrationForHLTTable;
 
 /**
  * Abstract interface for Pixel Clusterizers
@@ -68,8 +69,14 @@ public:
     theSiPixelGainCalibrationService_=in;
   }
 
+  // Configure decoded gain calibration, used instead of the service when set
+  void setSiPixelGainCalibrationTable( const SiPixelGainCalibrationForHLTTable* in){ 
+    theSiPixelGainCalibrationTable_=in;
+  }
+
  protected:
   SiPixelGainCalibrationServiceBase* theSiPixelGainCalibrationService_;
+  const SiPixelGainCalibrationForHLTTable* theSiPixelGainCalibrationTable_ = nullptr;
 
 };
 
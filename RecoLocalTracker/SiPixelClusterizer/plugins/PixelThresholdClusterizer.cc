@@ -23,6 +23,7 @@
 #include "PixelThresholdClusterizer.h"
 #include "SiPixelArrayBuffer.h"
 #include "CondFormats/SiPixelObjects/interface/SiPixelGainCalibrationOffline.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelGainCalibrationForHLTTable.h"
 // Geometry
 #include "Geometry/TrackerGeometryBuilder/interface/PixelGeomDetUnit.h"
 #include "Geometry/CommonTopologies/interface/PixelTopology.h"
@@ -80,6 +81,7 @@ PixelThresholdClusterizer::fillDescriptions(edm::ConfigurationDescriptions& desc
   desc.add<int>("VCaltoElectronOffset", -414);
   desc.add<int>("VCaltoElectronOffset_L1", -414);
   desc.add<std::string>("payloadType", "Offline");
+  desc.add<bool>("UseCalibrationTable", false)->setComment("HLT payload only: use the SiPixelGainCalibrationForHLTTable of the SiPixelGainCalibrationForHLTTableESProducer");
   desc.add<int>("SeedThreshold", 1000);
   desc.add<int>("ClusterThreshold_L1", 4000);
   desc.add<int>("ClusterThreshold", 4000);
@@ -234,9 +236,11 @@ void PixelThresholdClusterizer::copy_to_buffer( DigiIterator begin, DigiIterator
   memset(electron, 0, sizeof(electron));
   if ( doMissCalibrate ) {
     if (layer_==1) {
-      (*theSiPixelGainCalibrationService_).calibrate(detid_,begin,end,theConversionFactor_L1, theOffset_L1,electron);
+      if (!calibrateWithTable(begin,end,theConversionFactor_L1, theOffset_L1,electron))
+	(*theSiPixelGainCalibrationService_).calibrate(detid_,begin,end,theConversionFactor_L1, theOffset_L1,electron);
     } else {
-      (*theSiPixelGainCalibrationService_).calibrate(detid_,begin,end,theConversionFactor,    theOffset,  electron);
+      if (!calibrateWithTable(begin,end,theConversionFactor,    theOffset,  electron))
+	(*theSiPixelGainCalibrationService_).calibrate(detid_,begin,end,theConversionFactor,    theOffset,  electron);
     }
   } else {
     int i=0;
@@ -307,6 +311,20 @@ void PixelThresholdClusterizer::copy_to_buffer( ClusterIterator begin, ClusterIt
   }
 }
 
+//----------------------------------------------------------------------------
+//! \brief Calibrate the digis of the module with the decoded gains and pedestals.
+//!  Returns false if the module has no table.
+//----------------------------------------------------------------------------
+bool PixelThresholdClusterizer::calibrateWithTable( DigiIterator begin, DigiIterator end, 
+						    float conversionFactor, float offset, int * electron ) const
+{
+  if (!theSiPixelGainCalibrationTable_) return false;
+  auto const module = theSiPixelGainCalibrationTable_->module(detid_);
+  if (!module.valid()) return false;
+  SiPixelGainCalibrationForHLTTable::calibrate(module, begin, end, conversionFactor, offset, electron);
+  return true;
+}
+
 //----------------------------------------------------------------------------
 // Calibrate adc counts to electrons
 //-----------------------------------------------------------------
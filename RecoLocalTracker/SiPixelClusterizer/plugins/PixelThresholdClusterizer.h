@@ -126,6 +126,8 @@ class dso_hidden PixelThresholdClusterizer final : public PixelClusterizerBase {
   SiPixelCluster make_cluster( const SiPixelCluster::PixelPos& pix, edmNew::DetSetVector<SiPixelCluster>::FastFiller& output);
   // Calibrate the ADC charge to electrons 
   int calibrate(int adc, int col, int row);
+  // Calibrate all the digis of the module with the decoded gain calibration
+  bool calibrateWithTable( DigiIterator begin, DigiIterator end, float conversionFactor, float offset, int * electron ) const;
 
 };
 
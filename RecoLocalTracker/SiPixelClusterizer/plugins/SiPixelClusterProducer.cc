@@ -28,6 +28,8 @@
 #include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationService.h"
 #include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationOfflineService.h"
 #include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationForHLTService.h"
+#include "CondFormats/DataRecord/interface/SiPixelGainCalibrationForHLTRcd.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelGainCalibrationForHLTTable.h"
 
 // Framework
 #include "DataFormats/Common/interface/Handle.h"
@@ -53,7 +55,8 @@
     clusterizer_(nullptr),          // the default, in case we fail to make one
     readyToCluster_(false),   // since we obviously aren't
     maxTotalClusters_( conf.getParameter<int32_t>( "maxNumberOfClusters" ) ),
-    payloadType_( conf.getParameter<std::string>( "payloadType" ) )
+    payloadType_( conf.getParameter<std::string>( "payloadType" ) ),
+    useCalibrationTable_( conf.getParameter<bool>("UseCalibrationTable") )
   {
     if ( clusterMode_ == "PixelThresholdReclusterizer" )
       tPixelClusters = consumes<SiPixelClusterCollectionNew>( conf.getParameter<edm::InputTag>("src") );
@@ -69,6 +72,9 @@
     else if (strcmp(payloadType_.c_str(), "Full") == 0)
        theSiPixelGainCalibration_ = new SiPixelGainCalibrationService(conf);
 
+    if (useCalibrationTable_ && payloadType_ != "HLT")
+      throw cms::Exception("Configuration") << "[SiPixelClusterProducer]: UseCalibrationTable requires the HLT payloadType, not " << payloadType_;
+
     //--- Make the algorithm(s) according to what the user specified
     //--- in the ParameterSet.
     setupClusterizer(conf);
@@ -90,6 +96,11 @@
 
     //Setup gain calibration service
     theSiPixelGainCalibration_->setESObjects( es );
+    if (useCalibrationTable_) {
+      edm::ESHandle<SiPixelGainCalibrationForHLTTable> calibrationTable;
+      es.get<SiPixelGainCalibrationForHLTRcd>().get( calibrationTable );
+      clusterizer_->setSiPixelGainCalibrationTable( calibrationTable.product() );
+    }
 
     // Step A.1: get input data
     edm::Handle< SiPixelClusterCollectionNew >   inputClusters;
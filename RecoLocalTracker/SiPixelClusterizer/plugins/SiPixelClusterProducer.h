@@ -80,6 +80,7 @@
     const int32_t maxTotalClusters_;
 
     const std::string payloadType_;
+    const bool useCalibrationTable_;        // decoded gains from the SiPixelGainCalibrationForHLTTableESProducer
   };
 
 
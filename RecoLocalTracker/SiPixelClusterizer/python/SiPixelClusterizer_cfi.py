@@ -20,6 +20,8 @@ siPixelClusters = cms.EDProducer("SiPixelClusterProducer",
     # **************************************
     payloadType = cms.string('Offline'),
     #payloadType = cms.string('Full'),
+    # HLT payload only: decoded gains from the siPixelGainCalibrationForHLTTableESProducer
+    UseCalibrationTable = cms.bool(False),
     SeedThreshold = cms.int32(1000),
     ClusterThreshold    = cms.int32(4000),
     ClusterThreshold_L1 = cms.int32(4000),
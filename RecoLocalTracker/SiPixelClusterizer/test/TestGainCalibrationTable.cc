@@ -0,0 +1,139 @@
+// Checks the calibration of the pixel digis with the decoded SiPixelGainCalibrationForHLTTable
+// against SiPixelGainCalibrationForHLTService::calibrate, on a payload with gains and pedestals
+// varying by column and block of rows, and with dead and noisy columns.
+//
+// TestGainForHLTESSource produces the payload for a few modules of one and two blocks of rows,
+// TestGainCalibrationTable calibrates digis on every pixel of each module, in column order and
+// in a shuffled order, with both and throws on any difference.
+
+#include "FWCore/Framework/interface/ESProducer.h"
+#include "FWCore/Framework/interface/EventSetupRecordIntervalFinder.h"
+#include "FWCore/Framework/interface/SourceFactory.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "CondFormats/SiPixelObjects/interface/SiPixelGainCalibrationForHLT.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelGainCalibrationForHLTTable.h"
+#include "CondFormats/DataRecord/interface/SiPixelGainCalibrationForHLTRcd.h"
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationForHLTService.h"
+#include "DataFormats/Common/interface/DetSet.h"
+#include "DataFormats/SiPixelDigi/interface/PixelDigi.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+  // detId, columns and rows of the test modules
+  struct TestModule { uint32_t detId; int nCols; int nRows; };
+  const TestModule testModules[] = { {302055684, 416, 160}, {302055940, 416, 160}, {344064004, 104, 80}, {344064260, 156, 160} };
+}
+
+class TestGainForHLTESSource : public edm::ESProducer, public edm::EventSetupRecordIntervalFinder {
+public:
+  explicit TestGainForHLTESSource(const edm::ParameterSet &) {
+    setWhatProduced(this);
+    findingRecord<SiPixelGainCalibrationForHLTRcd>();
+  }
+
+  std::unique_ptr<SiPixelGainCalibrationForHLT> produce(const SiPixelGainCalibrationForHLTRcd &) {
+    auto obj = std::make_unique<SiPixelGainCalibrationForHLT>(20.,40., 1.5,4.5);
+    std::mt19937 eng(42);
+    std::uniform_real_distribution<float> ped(20.,40.), gain(1.5,4.5);
+    for (auto const & m : testModules) {
+      std::vector<char> data;
+      for (int col=0; col<m.nCols; ++col) {
+        // one column in 37 dead and one in 53 noisy, the others varying by block of 80 rows
+        for (int block=0; block<m.nRows/80; ++block) {
+          if (col%37==5) obj->setDeadColumn(80, data);
+          else if (col%53==11) obj->setNoisyColumn(80, data);
+          else obj->setData(ped(eng), gain(eng), data);
+        }
+      }
+      SiPixelGainCalibrationForHLT::Range range(data.begin(), data.end());
+      if (!obj->put(m.detId, range, m.nCols))
+        throw cms::Exception("TestGainForHLTESSource") << "detid " << m.detId << " already exists";
+    }
+    return obj;
+  }
+
+protected:
+  void setIntervalFor(const edm::eventsetup::EventSetupRecordKey&, const edm::IOVSyncValue& iosv,
+                      edm::ValidityInterval& oValidity) override {
+    oValidity = edm::ValidityInterval(iosv.beginOfTime(), iosv.endOfTime());
+  }
+};
+
+
+class TestGainCalibrationTable : public edm::one::EDAnalyzer<> {
+public:
+  explicit TestGainCalibrationTable(const edm::ParameterSet& conf) :
+    service_(conf),
+    conversionFactor_(conf.getParameter<int>("VCaltoElectronGain")),
+    offset_(conf.getParameter<int>("VCaltoElectronOffset"))
+  {}
+
+  void analyze(const edm::Event&, const edm::EventSetup& es) override;
+
+private:
+  void compare(uint32_t detId, const SiPixelGainCalibrationForHLTTable::Module & module,
+               const edm::DetSet<PixelDigi> & digis);
+
+  SiPixelGainCalibrationForHLTService service_;
+  const float conversionFactor_;
+  const float offset_;
+};
+
+void TestGainCalibrationTable::analyze(const edm::Event&, const edm::EventSetup& es) {
+  service_.setESObjects(es);
+  edm::ESHandle<SiPixelGainCalibrationForHLTTable> table;
+  es.get<SiPixelGainCalibrationForHLTRcd>().get(table);
+
+  if (table->nModules() != sizeof(testModules)/sizeof(testModules[0]))
+    throw cms::Exception("TestGainCalibrationTable") << table->nModules() << " modules in the table";
+  if (table->module(1).valid())
+    throw cms::Exception("TestGainCalibrationTable") << "valid table for a module not in the payload";
+
+  std::mt19937 eng(7);
+  std::uniform_int_distribution<int> adc(0, 255);
+  for (auto const & m : testModules) {
+    auto const module = table->module(m.detId);
+    if (!module.valid())
+      throw cms::Exception("TestGainCalibrationTable") << "no table for detid " << m.detId;
+
+    edm::DetSet<PixelDigi> digis(m.detId);
+    for (int col=0; col<m.nCols; ++col)
+      for (int row=0; row<m.nRows; ++row)
+        digis.push_back(PixelDigi(row, col, adc(eng)));
+    compare(m.detId, module, digis);
+
+    std::shuffle(digis.begin(), digis.end(), eng);
+    compare(m.detId, module, digis);
+  }
+  edm::LogPrint("TestGainCalibrationTable") << "table calibration equal to the service for "
+                                            << table->nModules() << " modules";
+}
+
+void TestGainCalibrationTable::compare(uint32_t detId, const SiPixelGainCalibrationForHLTTable::Module & module,
+                                       const edm::DetSet<PixelDigi> & digis) {
+  std::vector<int> expected(digis.size()), electron(digis.size());
+  service_.calibrate(detId, digis.begin(), digis.end(), conversionFactor_, offset_, expected.data());
+  SiPixelGainCalibrationForHLTTable::calibrate(module, digis.begin(), digis.end(), conversionFactor_, offset_, electron.data());
+  for (unsigned int i=0; i<digis.size(); ++i) {
+    if (electron[i] != expected[i])
+      throw cms::Exception("TestGainCalibrationTable") << "detid " << detId << " col " << digis.data[i].column()
+                                                       << " row " << digis.data[i].row() << " adc " << digis.data[i].adc()
+                                                       << ": " << electron[i] << " electrons from the table, "
+                                                       << expected[i] << " from the service";
+  }
+}
+
+DEFINE_FWK_EVENTSETUP_SOURCE(TestGainForHLTESSource);
+DEFINE_FWK_MODULE(TestGainCalibrationTable);
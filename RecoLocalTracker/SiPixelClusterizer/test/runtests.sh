@@ -0,0 +1,5 @@
+#!/bin/bash
+
+function die { echo $1: status $2 ;  exit $2; }
+
+cmsRun ${LOCAL_TEST_DIR}/testGainCalibrationTable_cfg.py || die "Failure using testGainCalibrationTable_cfg.py" $?
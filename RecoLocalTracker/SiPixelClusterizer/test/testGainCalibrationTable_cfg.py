@@ -0,0 +1,20 @@
+# Compares the pixel digi calibration with the decoded gain table to the
+# SiPixelGainCalibrationForHLTService on a generated HLT gain payload.
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TESTTABLE")
+process.load("FWCore.MessageService.MessageLogger_cfi")
+
+process.source = cms.Source("EmptySource")
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(1))
+
+process.testGainForHLT = cms.ESSource("TestGainForHLTESSource")
+process.load("CalibTracker.SiPixelESProducers.siPixelGainCalibrationForHLTTableESProducer_cfi")
+
+process.testGainCalibrationTable = cms.EDAnalyzer("TestGainCalibrationTable",
+    VCaltoElectronGain = cms.int32(65),
+    VCaltoElectronOffset = cms.int32(-414)
+)
+
+process.p = cms.Path(process.testGainCalibrationTable)
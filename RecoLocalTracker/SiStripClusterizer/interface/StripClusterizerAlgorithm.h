@@ -10,6 +10,7 @@ class SiStripDigi;
 #include "CalibFormats/SiStripObjects/interface/SiStripGain.h"
 #include "CondFormats/SiStripObjects/interface/SiStripNoises.h"
 #include "CalibFormats/SiStripObjects/interface/SiStripQuality.h"
+#include "CalibFormats/SiStripObjects/interface/SiStripClusterizerConditions.h"
 #include "EventFilter/SiStripRawToDigi/interface/SiStripFEDBuffer.h"
 #include <limits>
 
@@ -21,17 +22,28 @@ class StripClusterizerAlgorithm {
  public:
   static constexpr unsigned short invalidI = std::numeric_limits<unsigned short>::max();
   
+  // flattened strip conditions: noise in units of 0.1 ADC (as stored in SiStripNoises) and bad-strip flag
+  static constexpr uint16_t noiseMask = SiStripClusterizerConditions::noiseMask;
+  static constexpr uint16_t badStripBit = SiStripClusterizerConditions::badStripBit;
+
   // state of detID
   struct Det {
     bool valid() const { return ind!=invalidI; }
-    float noise(const uint16_t& strip) const { return SiStripNoises::getNoise( strip, noiseRange ); }
-    float gain(const uint16_t& strip)  const { return SiStripGain::getStripGain( strip, gainRange ); }
-    bool bad(const uint16_t& strip)    const { return quality->IsStripBad( qualityRange, strip ); }
+    bool flat() const { return stripConditions!=nullptr; }
+    float noise(const uint16_t& strip) const {
+      return strip<nStrips ? 0.1f*float(stripConditions[strip]&noiseMask) : SiStripNoises::getNoise( strip, noiseRange ); }
+    float gain(const uint16_t& strip)  const {
+      return strip<nStrips ? apvGains[strip/128] : SiStripGain::getStripGain( strip, gainRange ); }
+    bool bad(const uint16_t& strip)    const {
+      return flat() ? (strip<nStrips && (stripConditions[strip]&badStripBit)) : quality->IsStripBad( qualityRange, strip ); }
     bool allBadBetween(uint16_t L, const uint16_t& R) const { while( ++L < R  &&  bad(L)) {}; return L == R; }
     SiStripQuality const * quality;
     SiStripApvGain::Range gainRange;
     SiStripNoises::Range  noiseRange;
     SiStripQuality::Range qualityRange;
+    uint16_t const * stripConditions=nullptr;
+    float const * apvGains=nullptr;
+    uint16_t nStrips=0; // strips with flattened conditions
     uint32_t detId=0;
     unsigned short ind=invalidI;
   };
@@ -82,16 +94,19 @@ class StripClusterizerAlgorithm {
 
  protected:
 
-  StripClusterizerAlgorithm() : qualityLabel(""), noise_cache_id(0), gain_cache_id(0), quality_cache_id(0) {}
+  StripClusterizerAlgorithm() : qualityLabel(""), noise_cache_id(0), gain_cache_id(0), quality_cache_id(0), conditions_cache_id(0) {}
 
   Det findDetId(const uint32_t) const;
   bool isModuleBad(const uint32_t& id)  const { return qualityHandle->IsModuleBad( id ); }
   bool isModuleUsable(const uint32_t& id)  const { return qualityHandle->IsModuleUsable( id ); }
 
   std::string qualityLabel;
+  bool flattenConditions = false;
 
  private:
 
+  void indexFlattenedConditions();
+
   template<class T> void clusterize_(const T& input, output_t& output) const {
     for(typename T::const_iterator it = input.begin(); it!=input.end(); it++) {
       output_t::TSFastFiller ff(output, it->detId());	
@@ -105,6 +120,7 @@ class StripClusterizerAlgorithm {
     gi=invalidI,
       ni=invalidI,
       qi=invalidI;
+    SiStripClusterizerConditions::Module flat; // no strips if not flattened
   };
   std::vector<uint32_t> detIds; // from cabling (connected and not bad)
   std::vector<std::vector<const FedChannelConnection *> > connections;
@@ -112,8 +128,9 @@ class StripClusterizerAlgorithm {
   edm::ESHandle<SiStripGain> gainHandle;
   edm::ESHandle<SiStripNoises> noiseHandle;
   edm::ESHandle<SiStripQuality> qualityHandle;
+  edm::ESHandle<SiStripClusterizerConditions> conditionsHandle; // shared by all the clusterizers
   SiStripDetCabling const * theCabling = nullptr;
-  uint32_t noise_cache_id, gain_cache_id, quality_cache_id;
+  uint32_t noise_cache_id, gain_cache_id, quality_cache_id, conditions_cache_id;
     
 
 };
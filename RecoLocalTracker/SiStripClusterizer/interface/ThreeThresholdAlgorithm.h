@@ -21,6 +21,7 @@ class ThreeThresholdAlgorithm final : public StripClusterizerAlgorithm {
   void stripByStripEnd(State & state, std::vector<SiStripCluster>& out) const override;
 
   void addFed(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, std::vector<SiStripCluster>& out) const {
+    if (state.det().flat()) { addChannel(state,unpacker,ipair,out); return; }
     while (unpacker.hasData()) {
       stripByStripAdd(state,unpacker.sampleNumber()+ipair*256,unpacker.adc(),out);
       unpacker++;
@@ -29,6 +30,7 @@ class ThreeThresholdAlgorithm final : public StripClusterizerAlgorithm {
   using StripClusterizerAlgorithm::addFed;
   // detset interface
   void addFed(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, output_t::TSFastFiller & out) const override {
+    if (state.det().flat()) { addChannel(state,unpacker,ipair,out); return; }
     while (unpacker.hasData()) {
       stripByStripAdd(state, unpacker.sampleNumber()+ipair*256,unpacker.adc(),out);
       unpacker++;
@@ -47,8 +49,11 @@ class ThreeThresholdAlgorithm final : public StripClusterizerAlgorithm {
 
   template<class T> void clusterizeDetUnit_(const T&, output_t::TSFastFiller&) const;
 
+  // whole fibre channel at a time, with the flattened conditions of the det
+  template<class T> void addChannel(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, T& out) const;
+
   ThreeThresholdAlgorithm(float, float, float, unsigned, unsigned, unsigned, std::string qualityLabel,
-			  bool removeApvShots, float minGoodCharge);
+			  bool removeApvShots, float minGoodCharge, bool flattenConditions=false);
 
 
     //constant methods with state information
@@ -61,6 +66,7 @@ class ThreeThresholdAlgorithm final : public StripClusterizerAlgorithm {
     void clearCandidate(State & state) const { state.candidateLacksSeed = true;  state.noiseSquared = 0;  state.ADCs.clear();}
     void addToCandidate(State & state, const SiStripDigi& digi) const { addToCandidate(state, digi.strip(),digi.adc());}
     void addToCandidate(State & state, uint16_t strip, uint8_t adc) const;
+    void appendToCandidate(State & state, uint16_t strip, uint8_t adc, float noise, bool seed) const;
     void appendBadNeighbors(State & state) const;
     void applyGains(State & state) const;
 
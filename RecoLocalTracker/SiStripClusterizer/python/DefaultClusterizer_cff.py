@@ -12,5 +12,6 @@ DefaultClusterizer = cms.PSet(
     MaxAdjacentBad = cms.uint32(0),
     QualityLabel = cms.string(""),
     RemoveApvShots     = cms.bool(True),
+    FlattenConditions  = cms.bool(False),  # per-strip noise/gain/bad-strip arrays from SiStripClusterizerConditionsESProducer
     clusterChargeCut = cms.PSet(refToPSet_ = cms.string('SiStripClusterChargeCutNone')),
     )
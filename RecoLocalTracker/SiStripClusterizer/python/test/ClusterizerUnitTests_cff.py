@@ -241,3 +241,6 @@ clusterizerTests = ClusterizerTest( "Default Clusterizer Settings",
                ] )
     ]
                                            )
+
+flattenedClusterizerTests = clusterizerTests.clone( Label = "Default Clusterizer Settings, flattened conditions" )
+flattenedClusterizerTests.ClusterizerParameters.FlattenConditions = cms.bool(True)
@@ -23,9 +23,10 @@ process.SiStripQualityRcdSource = cms.ESSource( "EmptyESSource",
 
 process.load("RecoLocalTracker.SiStripClusterizer.test.ClusterizerUnitTestFunctions_cff")
 process.load("RecoLocalTracker.SiStripClusterizer.test.ClusterizerUnitTests_cff")
-testDefinition = cms.VPSet() + [ process.clusterizerTests ]
+testDefinition = cms.VPSet() + [ process.clusterizerTests, process.flattenedClusterizerTests ]
 
 process.es           = cms.ESProducer("ClusterizerUnitTesterESProducer", ClusterizerTestGroups = testDefinition  )
+process.load("CalibTracker.SiStripESProducers.siStripClusterizerConditionsESProducer_cfi")
 process.runUnitTests = cms.EDAnalyzer("ClusterizerUnitTester",           ClusterizerTestGroups = testDefinition  )
 
 process.path = cms.Path( process.runUnitTests )
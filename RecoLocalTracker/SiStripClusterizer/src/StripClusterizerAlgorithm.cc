@@ -4,6 +4,7 @@
 #include "CondFormats/DataRecord/interface/SiStripNoisesRcd.h"
 #include "CalibTracker/Records/interface/SiStripGainRcd.h"
 #include "CalibTracker/Records/interface/SiStripQualityRcd.h"
+#include "CalibTracker/Records/interface/SiStripClusterizerConditionsRcd.h"
 #include "DataFormats/SiStripDigi/interface/SiStripDigi.h"
 #include "DataFormats/SiStripCluster/interface/SiStripCluster.h"
 #include "CalibFormats/SiStripObjects/interface/SiStripDetCabling.h"
@@ -121,9 +122,28 @@ initialize(const edm::EventSetup& es) {
       assert(nn<=dum.size());
       COUT << "gain " << dum.size() << " " <<nn<< std::endl;
     }
+
+  }
+
+  if (flattenConditions) {
+    uint32_t c_cache_id = es.get<SiStripClusterizerConditionsRcd>().cacheIdentifier();
+    if (c_cache_id != conditions_cache_id) {
+      es.get<SiStripClusterizerConditionsRcd>().get( qualityLabel, conditionsHandle );
+      conditions_cache_id = c_cache_id;
+      mod=true;
+    }
+    if (mod) indexFlattenedConditions();
   }
   
 }
+
+void StripClusterizerAlgorithm::
+indexFlattenedConditions() {
+  // the conditions are decoded once per IOV by SiStripClusterizerConditionsESProducer
+  for (auto i=0U; i<detIds.size(); ++i)
+    indices[i].flat = conditionsHandle->module(detIds[i]);
+  COUT << "flattened conditions " << conditionsHandle->nModules() << " modules " << conditionsHandle->nStrips() << " strips" << std::endl;
+}
   
 StripClusterizerAlgorithm::Det
 StripClusterizerAlgorithm::
@@ -147,6 +167,11 @@ findDetId(const uint32_t id) const {
   det.gainRange = gainHandle->getRangeByPos(indices[det.ind].gi);
   det.qualityRange = qualityHandle->getRangeByPos(indices[det.ind].qi);
   det.quality =   qualityHandle.product();
+  if (indices[det.ind].flat.nStrips>0) {
+    det.stripConditions = indices[det.ind].flat.strips;
+    det.apvGains = indices[det.ind].flat.apvGains;
+    det.nStrips = indices[det.ind].flat.nStrips;
+  }
 
 #ifdef EDM_ML_DEBUG
   assert(detIds[det.ind]==det.detId); 
@@ -20,7 +20,8 @@ create(const edm::ParameterSet& conf) {
 	       conf.getParameter<unsigned>("MaxAdjacentBad"),
 	       conf.getParameter<std::string>("QualityLabel"),
 	       conf.getParameter<bool>("RemoveApvShots"),
-               clusterChargeCut(conf)
+               clusterChargeCut(conf),
+	       conf.existsAs<bool>("FlattenConditions") ? conf.getParameter<bool>("FlattenConditions") : false
            ));
   }
 
@@ -9,10 +9,11 @@
 
 ThreeThresholdAlgorithm::
 ThreeThresholdAlgorithm(float chan, float seed, float cluster, unsigned holes, unsigned bad, unsigned adj, std::string qL, 
-			bool removeApvShots, float minGoodCharge) 
+			bool removeApvShots, float minGoodCharge, bool flatten) 
   : ChannelThreshold( chan ), SeedThreshold( seed ), ClusterThresholdSquared( cluster*cluster ),
     MaxSequentialHoles( holes ), MaxSequentialBad( bad ), MaxAdjacentBad( adj ), RemoveApvShots(removeApvShots), minGoodCharge(minGoodCharge) {
   qualityLabel = (qL);
+  flattenConditions = flatten;
 }
 
 template<class digiDetSet>
@@ -67,12 +68,55 @@ addToCandidate(State & state, uint16_t strip, uint8_t adc) const {
   if(  adc < static_cast<uint8_t>( Noise * ChannelThreshold) || state.det().bad(strip) )
     return;
 
-  if(state.candidateLacksSeed) state.candidateLacksSeed  =  adc < static_cast<uint8_t>( Noise * SeedThreshold);
+  appendToCandidate(state, strip, adc, Noise, adc >= static_cast<uint8_t>( Noise * SeedThreshold));
+}
+
+inline 
+void ThreeThresholdAlgorithm::
+appendToCandidate(State & state, uint16_t strip, uint8_t adc, float noise, bool seed) const { 
+  if(state.candidateLacksSeed) state.candidateLacksSeed  =  !seed;
   if(state.ADCs.empty()) state.lastStrip = strip - 1; // begin candidate
   while( ++state.lastStrip < strip ) state.ADCs.push_back(0); // pad holes
 
   state.ADCs.push_back( adc );
-  state.noiseSquared += Noise*Noise;
+  state.noiseSquared += noise*noise;
+}
+
+template <class T>
+void ThreeThresholdAlgorithm::
+addChannel(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, T& out) const {
+  // a channel reads out two APVs
+  constexpr unsigned int maxStrips = 256;
+  uint16_t strips[maxStrips];
+  uint8_t adcs[maxStrips];
+  uint16_t conditions[maxStrips];
+  float noises[maxStrips];
+  bool good[maxStrips], seed[maxStrips];
+
+  auto const & det = state.det();
+  while (unpacker.hasData()) {
+    // unpack
+    unsigned int n = 0;
+    for (; n<maxStrips && unpacker.hasData(); ++n, unpacker++) {
+      strips[n] = unpacker.sampleNumber()+ipair*256;
+      adcs[n] = unpacker.adc();
+      conditions[n] = strips[n]<det.nStrips ? det.stripConditions[strips[n]] : badStripBit;
+    }
+
+    // thresholds, independent from strip to strip
+    for (unsigned int i=0; i<n; ++i) {
+      noises[i] = 0.1f*float(conditions[i]&noiseMask);
+      good[i] = (adcs[i] >= static_cast<uint8_t>( noises[i] * ChannelThreshold)) & !(conditions[i]&badStripBit);
+      seed[i] = adcs[i] >= static_cast<uint8_t>( noises[i] * SeedThreshold);
+    }
+
+    // candidates; a strip below threshold cannot end a candidate that the next strip above threshold would not end
+    for (unsigned int i=0; i<n; ++i) {
+      if (!good[i]) continue;
+      if(candidateEnded(state, strips[i])) endCandidate(state, out);
+      appendToCandidate(state, strips[i], adcs[i], noises[i], seed[i]);
+    }
+  }
 }
 
 template <class T>
@@ -143,3 +187,6 @@ void ThreeThresholdAlgorithm::
 stripByStripEnd(State & state, std::vector<SiStripCluster>& out) const { 
   endCandidate(state, out);
 }
+
+template void ThreeThresholdAlgorithm::addChannel(State &, sistrip::FEDZSChannelUnpacker &, uint16_t, output_t::TSFastFiller &) const;
+template void ThreeThresholdAlgorithm::addChannel(State &, sistrip::FEDZSChannelUnpacker &, uint16_t, std::vector<SiStripCluster> &) const;
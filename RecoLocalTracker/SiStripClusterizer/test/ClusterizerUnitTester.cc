@@ -2,6 +2,8 @@
 
 #include "DataFormats/SiStripDigi/interface/SiStripDigi.h"
 #include "DataFormats/SiStripCluster/interface/SiStripCluster.h"
+#include "EventFilter/SiStripRawToDigi/interface/SiStripFEDBuffer.h"
+#include <algorithm>
 #include <functional>
 #include <numeric>
 #include <vector>
@@ -50,6 +52,7 @@ runTheTest(const PSet& test) {
   try { 
     clusterizer->clusterize(digis, result); 
     assertIdentical(expected, result);
+    runTheRawTest(digiset, expected);
     if(test.getParameter<bool>("InvalidCharge")) throw cms::Exception("Failed") << "Charges are valid, contrary to expectation.\n";
   }
   catch(StripClusterizerAlgorithm::InvalidChargeException e) {
@@ -60,6 +63,66 @@ runTheTest(const PSet& test) {
   }
 }
 
+// clusters the same digis from zero suppressed lite FED channels, as the clusterizer
+// from raw data does: strip by strip, or a channel at a time with flattened conditions
+void ClusterizerUnitTester::
+runTheRawTest(const VPSet& digiset, const output_t& expected) {
+  uint16_t npairs = 0;
+  for(iter_t strip = digiset.begin(); strip < digiset.end(); strip++) {
+    // the raw data have 8 bit ADCs
+    if(strip->getParameter<unsigned>("ADC") > 255) return;
+    npairs = std::max<uint16_t>(npairs, strip->getParameter<unsigned>("Strip")/256 + 1);
+  }
+
+  output_t result;
+  result.reserve(1, digiset.size()+1);
+  {
+    output_t::TSFastFiller clustersFF(result, detId);
+    auto const & det = clusterizer->stripByStripBegin(detId);
+    if(det.valid()) {
+      StripClusterizerAlgorithm::State state(det);
+      std::vector<uint8_t> channel;
+      for(uint16_t ipair = 0; ipair < npairs; ipair++) {
+        uint16_t length = constructZSLiteChannel(digiset, ipair, channel);
+        sistrip::FEDZSChannelUnpacker unpacker =
+          sistrip::FEDZSChannelUnpacker::zeroSuppressedLiteModeUnpacker(sistrip::FEDChannel(channel.data(), 0, length));
+        clusterizer->addFed(state, unpacker, ipair, clustersFF);
+      }
+      clusterizer->stripByStripEnd(state, clustersFF);
+    }
+    if(clustersFF.empty()) clustersFF.abort();
+  }
+  try { assertIdentical(expected, result); }
+  catch(cms::Exception& e) { throw e << "From raw data.\n"; }
+}
+
+// the channel of an APV pair: two bytes of length, then for each group of adjacent
+// strips its first strip, its width and the ADCs, in 64 bit words of swapped bytes
+uint16_t ClusterizerUnitTester::
+constructZSLiteChannel(const VPSet& stripset, uint16_t ipair, std::vector<uint8_t>& channel) {
+  std::vector<std::pair<unsigned,uint8_t> > strips;
+  for(iter_t strip = stripset.begin(); strip < stripset.end(); strip++) {
+    unsigned s = strip->getParameter<unsigned>("Strip");
+    if(s/256 == ipair) strips.emplace_back(s%256, strip->getParameter<unsigned>("ADC"));
+  }
+  std::sort(strips.begin(), strips.end());
+
+  std::vector<uint8_t> bytes(2);
+  for(unsigned i = 0; i < strips.size(); ) {
+    unsigned j = i+1;
+    while(j < strips.size() && strips[j].first == strips[j-1].first+1) j++;
+    bytes.push_back(strips[i].first);
+    bytes.push_back(j-i);
+    for(; i < j; i++) bytes.push_back(strips[i].second);
+  }
+  bytes[0] = bytes.size() & 0xFF;
+  bytes[1] = bytes.size() >> 8;
+
+  channel.assign((bytes.size()+7)/8*8, 0);
+  for(unsigned k = 0; k < bytes.size(); k++) channel[k^7] = bytes[k];
+  return bytes.size();
+}
+
 void ClusterizerUnitTester::
 constructDigis(const VPSet& stripset, edmNew::DetSetVector<SiStripDigi>& digis) {
   edmNew::DetSetVector<SiStripDigi>::TSFastFiller digisFF(digis, detId);
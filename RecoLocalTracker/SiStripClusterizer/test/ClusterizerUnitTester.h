@@ -29,9 +29,11 @@ class ClusterizerUnitTester : public edm::EDAnalyzer {
   void initializeTheGroup(const PSet&, const edm::EventSetup&);
   void testTheGroup(const PSet&);
   void runTheTest(const PSet&);
+  void runTheRawTest(const VPSet&, const output_t&);
   
   void constructClusters(const VPSet&, output_t&);
   void constructDigis(const VPSet&, edmNew::DetSetVector<SiStripDigi>&);
+  static uint16_t constructZSLiteChannel(const VPSet&, uint16_t ipair, std::vector<uint8_t>&);
 
   static std::string printDigis(const VPSet&);
   static void assertIdentical(const output_t&, const output_t&);
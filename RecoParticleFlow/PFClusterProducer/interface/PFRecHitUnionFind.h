@@ -0,0 +1,39 @@
+#ifndef __PFRecHitUnionFind_H__
+#define __PFRecHitUnionFind_H__
+
+#include <vector>
+
+/**\class PFRecHitUnionFind
+   \brief Disjoint sets of rechit indices, for the topological clustering.
+
+   merge() always attaches the root with the larger index to the one with
+   the smaller index, so the root of a connected component is its smallest
+   rechit index whatever the order of the merges. find() halves the paths
+   it walks. The buffer is meant to be kept and reset each event.
+*/
+class PFRecHitUnionFind {
+ public:
+  void reset(unsigned int n) {
+    _parent.resize(n);
+    for( unsigned int i = 0; i < n; ++i ) _parent[i] = i;
+  }
+
+  unsigned int find(unsigned int i) {
+    while( _parent[i] != i ) {
+      _parent[i] = _parent[_parent[i]];
+      i = _parent[i];
+    }
+    return i;
+  }
+
+  void merge(unsigned int i, unsigned int j) {
+    const unsigned int ri = find(i), rj = find(j);
+    if( ri < rj ) _parent[rj] = ri;
+    else if( rj < ri ) _parent[ri] = rj;
+  }
+
+ private:
+  std::vector<unsigned int> _parent;
+};
+
+#endif
@@ -99,12 +99,14 @@ buildClusters(const reco::PFClusterCollection& input,
 	      const std::vector<bool>& seedable,
 	      reco::PFClusterCollection& output) {
   reco::PFClusterCollection clustersInTopo;
+  TopoBuffers buffers;
   for( const auto& topocluster : input ) {
     clustersInTopo.clear();
     seedPFClustersFromTopo(topocluster,seedable,clustersInTopo);
     const unsigned tolScal = 
       std::pow(std::max(1.0,clustersInTopo.size()-1.0),2.0);
-    growPFClusters(topocluster,seedable,tolScal,0,tolScal,clustersInTopo);
+    buffers.fill(topocluster,seedable,_recHitEnergyNorms);
+    growPFClusters(buffers,tolScal,0,tolScal,clustersInTopo);
     // step added by Josh Bendavid, removes low-fraction clusters
     // did not impact position resolution with fraction cut of 1e-7
     // decreases the size of each pf cluster considerably
@@ -145,9 +147,48 @@ seedPFClustersFromTopo(const reco::PFCluster& topo,
   }
 }
 
+void Basic2DGenericPFlowClusterizer::TopoBuffers::
+fill(const reco::PFCluster& topo,
+     const std::vector<bool>& seedableHits,
+     const std::unordered_map<int,std::pair<std::vector<int>,std::vector<double> > >& recHitEnergyNorms) {
+  const auto& recHitFractions = topo.recHitFractions();
+  const unsigned nhits = recHitFractions.size();
+  refs.clear(); 
+  x.resize(nhits); y.resize(nhits); z.resize(nhits); norm.resize(nhits);
+  detId.resize(nhits); seedable.resize(nhits);
+  for( unsigned ihit = 0; ihit < nhits; ++ihit ) {
+    const reco::PFRecHitRef& refhit = recHitFractions[ihit].recHitRef();
+    refs.push_back(refhit);
+    int cell_layer = (int)refhit->layer();
+    if( cell_layer == PFLayer::HCAL_BARREL2 && 
+	std::abs(refhit->positionREP().eta()) > 0.34 ) {
+      cell_layer *= 100;
+    }  
+
+    const math::XYZPoint topocellpos_xyz(refhit->position());
+    x[ihit] = topocellpos_xyz.x();
+    y[ihit] = topocellpos_xyz.y();
+    z[ihit] = topocellpos_xyz.z();
+    detId[ihit] = refhit->detId();
+    seedable[ihit] = seedableHits[refhit.key()];
+
+    double recHitEnergyNorm=0.;
+    auto const& recHitEnergyNormDepthPair = recHitEnergyNorms.find(cell_layer)->second;
+
+    for (unsigned int j=0; j<recHitEnergyNormDepthPair.second.size(); ++j) {
+      int depth=recHitEnergyNormDepthPair.first[j];
+
+      if( ( cell_layer == PFLayer::HCAL_BARREL1 && refhit->depth()== depth)
+	  || ( cell_layer == PFLayer::HCAL_ENDCAP && refhit->depth()== depth)
+	  || ( cell_layer != PFLayer::HCAL_ENDCAP && cell_layer != PFLayer::HCAL_BARREL1)
+	  ) recHitEnergyNorm = recHitEnergyNormDepthPair.second[j];
+    }
+    norm[ihit] = recHitEnergyNorm;
+  }
+}
+
 void Basic2DGenericPFlowClusterizer::
-growPFClusters(const reco::PFCluster& topo,
-	       const std::vector<bool>& seedable,
+growPFClusters(TopoBuffers& topo,
 	       const unsigned toleranceScaling,
 	       const unsigned iter,
 	       double diff,
@@ -171,62 +212,60 @@ growPFClusters(const reco::PFCluster& topo,
 	_positionCalc->calculateAndSetPosition(cluster);
       }
     }
-    cluster.resetHitsAndFractions();
   }
-  // loop over topo cluster and grow current PFCluster hypothesis 
-  std::vector<double> dist2, frac;
-  double fractot = 0;
-  for( const reco::PFRecHitFraction& rhf : topo.recHitFractions() ) {
-    const reco::PFRecHitRef& refhit = rhf.recHitRef();
-    int cell_layer = (int)refhit->layer();
-    if( cell_layer == PFLayer::HCAL_BARREL2 && 
-	std::abs(refhit->positionREP().eta()) > 0.34 ) {
-      cell_layer *= 100;
-    }  
-
-    math::XYZPoint topocellpos_xyz(refhit->position());
-    dist2.clear(); frac.clear(); fractot = 0;
-
-    double recHitEnergyNorm=0.;
-    auto const& recHitEnergyNormDepthPair = _recHitEnergyNorms.find(cell_layer)->second;
-
-    for (unsigned int j=0; j<recHitEnergyNormDepthPair.second.size(); ++j) {
-      int depth=recHitEnergyNormDepthPair.first[j];
-
-      if( ( cell_layer == PFLayer::HCAL_BARREL1 && refhit->depth()== depth)
-	  || ( cell_layer == PFLayer::HCAL_ENDCAP && refhit->depth()== depth)
-	  || ( cell_layer != PFLayer::HCAL_ENDCAP && cell_layer != PFLayer::HCAL_BARREL1)
-	  ) recHitEnergyNorm = recHitEnergyNormDepthPair.second[j];
+  // compute the rechit-cluster distances and fractions for the whole 
+  // topocluster, one cluster at a time over the contiguous rechit arrays
+  const unsigned nhits = topo.refs.size();
+  const unsigned nclus = clusters.size();
+  topo.dist2.resize(nhits*nclus);
+  topo.frac.resize(nhits*nclus);
+  topo.fractot.assign(nhits,0.0);
+  for( unsigned i = 0; i < nclus; ++i ) {
+    const math::XYZPoint& clusterpos_xyz = clusters[i].position();
+    const double cx = clusterpos_xyz.x();
+    const double cy = clusterpos_xyz.y();
+    const double cz = clusterpos_xyz.z();
+    const double cenergy = clusters[i].energy();
+    const unsigned cseed = clusters[i].seed();
+    double* __restrict__ dist2 = &topo.dist2[i*nhits];
+    double* __restrict__ frac = &topo.frac[i*nhits];
+    for( unsigned ihit = 0; ihit < nhits; ++ihit ) {
+      const double dx = cx - topo.x[ihit];
+      const double dy = cy - topo.y[ihit];
+      const double dz = cz - topo.z[ihit];
+      dist2[ihit] = (dx*dx + dy*dy + dz*dz)/_showerSigma2;
+    }
+    for( unsigned ihit = 0; ihit < nhits; ++ihit ) {
+      frac[ihit] = cenergy/topo.norm[ihit] * vdt::fast_expf( -0.5*dist2[ihit] );
+    }
+    // fraction assignment logic
+    if( _excludeOtherSeeds ) {
+      for( unsigned ihit = 0; ihit < nhits; ++ihit ) {
+	if( topo.detId[ihit] == cseed ) frac[ihit] = 1.0;
+	else if( topo.seedable[ihit] ) frac[ihit] = 0.0;
+      }
+    }
+    for( unsigned ihit = 0; ihit < nhits; ++ihit ) {
+      topo.fractot[ihit] += frac[ihit];
     }
+  }
+
+  for( auto& cluster : clusters) cluster.resetHitsAndFractions();
 
-    // add rechits to clusters, calculating fraction based on distance
-    for( auto& cluster : clusters ) {      
-      const math::XYZPoint& clusterpos_xyz = cluster.position();
-      const math::XYZVector deltav = clusterpos_xyz - topocellpos_xyz;
-      const double d2 = deltav.Mag2()/_showerSigma2;
-      dist2.emplace_back( d2 );
+  // loop over topo cluster and grow current PFCluster hypothesis 
+  for( unsigned ihit = 0; ihit < nhits; ++ihit ) {
+    const double fractot = topo.fractot[ihit];
+    for( unsigned i = 0; i < nclus; ++i ) {      
+      const double d2 = topo.dist2[i*nhits+ihit];
+      double fraction = topo.frac[i*nhits+ihit];
       if( d2 > 100 ) {
 	LOGDRESSED("Basic2DGenericPFlowClusterizer:growAndStabilizePFClusters")
 	  << "Warning! :: pfcluster-topocell distance is too large! d= "
 	  << d2;
       }
-
-      // fraction assignment logic
-      double fraction;
-      if( refhit->detId() == cluster.seed() && _excludeOtherSeeds ) {
-	fraction = 1.0;	
-      } else if ( seedable[refhit.key()] && _excludeOtherSeeds ) {
-	fraction = 0.0;
-      } else {
-	fraction = cluster.energy()/recHitEnergyNorm * vdt::fast_expf( -0.5*d2 );
-      }      
-      fractot += fraction;
-      frac.emplace_back(fraction);
-    }
-    for( unsigned i = 0; i < clusters.size(); ++i ) {      
       if( fractot > _minFracTot || 
-	  ( refhit->detId() == clusters[i].seed() && fractot > 0.0 ) ) {
-	frac[i]/=fractot;
+	  ( topo.detId[ihit] == clusters[i].seed() && fractot > 0.0 ) ) {
+	fraction/=fractot;
       } else {
 	continue;
       }
@@ -241,8 +280,8 @@ growPFClusters(const reco::PFCluster& topo,
       // (about 1% of the clusters) need to be studied, as 
       // they create fake photons, in general.
       // (PJ, 16/09/08) 
-      if( dist2[i] < 100.0 || frac[i] > 0.9999 ) {	
-	clusters[i].addRecHitFraction(reco::PFRecHitFraction(refhit,frac[i]));
+      if( d2 < 100.0 || fraction > 0.9999 ) {	
+	clusters[i].addRecHitFraction(reco::PFRecHitFraction(topo.refs[ihit],fraction));
       }
     }
   }
@@ -263,8 +302,8 @@ growPFClusters(const reco::PFCluster& topo,
     if( delta2 > diff2 ) diff2 = delta2;
   }
   diff = std::sqrt(diff2);
-  dist2.clear(); frac.clear(); clus_prev_pos.clear();// avoid badness
-  growPFClusters(topo,seedable,toleranceScaling,iter+1,diff,clusters);
+  clus_prev_pos.clear();// avoid badness
+  growPFClusters(topo,toleranceScaling,iter+1,diff,clusters);
 }
 
 void Basic2DGenericPFlowClusterizer::
@@ -37,12 +37,24 @@ class Basic2DGenericPFlowClusterizer : public PFClusterBuilderBase {
   std::unique_ptr<PFCPositionCalculatorBase> _allCellsPosCalc;
   std::unique_ptr<PFCPositionCalculatorBase> _convergencePosCalc;
   
+  // flat copy of the topocluster rechits and of the per-iteration
+  // rechit-cluster distances and fractions, laid out cluster-major so that
+  // the fraction computation runs over contiguous rechit arrays
+  struct TopoBuffers {
+    std::vector<reco::PFRecHitRef> refs;
+    std::vector<double> x, y, z, norm;
+    std::vector<unsigned> detId;
+    std::vector<char> seedable;
+    std::vector<double> dist2, frac, fractot;
+    void fill(const reco::PFCluster&, const std::vector<bool>&,
+	      const std::unordered_map<int,std::pair<std::vector<int>,std::vector<double> > >&);
+  };
+
   void seedPFClustersFromTopo(const reco::PFCluster&,
 			      const std::vector<bool>&,
 			      reco::PFClusterCollection&) const;
 
-  void growPFClusters(const reco::PFCluster&,
-		      const std::vector<bool>&,
+  void growPFClusters(TopoBuffers&,
 		      const unsigned toleranceScaling,
 		      const unsigned iter,
 		      double dist,
@@ -1,5 +1,7 @@
 #include "Basic2DGenericTopoClusterizer.h"
+#include "FWCore/Framework/interface/Event.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #ifdef PFLOW_DEBUG
 #define LOGVERB(x) edm::LogVerbatim(x)
@@ -13,6 +15,11 @@
 #define LOGDRESSED(x) LogDebug(x)
 #endif
 
+void Basic2DGenericTopoClusterizer::
+updateEvent(const edm::Event& event) {
+  if( _useUnionFind ) _soa = &event.get(_soaToken);
+}
+
 void Basic2DGenericTopoClusterizer::
 buildClusters(const edm::Handle<reco::PFRecHitCollection>& input,
 	      const std::vector<bool>& rechitMask,
@@ -32,6 +39,11 @@ buildClusters(const edm::Handle<reco::PFRecHitCollection>& input,
   std::sort(seeds.begin(),seeds.end(),
             [&](unsigned int i, unsigned int j) { return hits[i].energy()>hits[j].energy();});  
   
+  if( _useUnionFind ) {
+    buildClustersUnionFind(input,rechitMask,seeds,output);
+    return;
+  }
+
   reco::PFCluster temp;
   for( auto seed : seeds ) {    
     if( !rechitMask[seed] || !seedable[seed] || used[seed] ) continue;    
@@ -54,22 +66,8 @@ buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>& input,
       cell_layer *= 100;
     }    
 
-  auto const& thresholds = _thresholds.find(cell_layer)->second;
-  double thresholdE=0.;
-  double thresholdPT2=0.;
-
-  for (unsigned int j=0; j<(std::get<1>(thresholds)).size(); ++j) {
-    int depth=std::get<0>(thresholds)[j];
-
-    if( ( cell_layer == PFLayer::HCAL_BARREL1 && cell.depth()== depth)
-	|| ( cell_layer == PFLayer::HCAL_ENDCAP && cell.depth()== depth)
-	|| ( cell_layer != PFLayer::HCAL_BARREL1 && cell_layer != PFLayer::HCAL_ENDCAP )
-	) { thresholdE=std::get<1>(thresholds)[j]; thresholdPT2=std::get<2>(thresholds)[j]; }
-
-  }
-
-  if( cell.energy() < thresholdE ||
-      cell.pt2() < thresholdPT2  ) {
+  if( !passesGatheringThreshold(cell_layer,cell.depth(),
+				cell.energy(),cell.pt2()) ) {
     LOGDRESSED("GenericTopoCluster::buildTopoCluster()")
       << "RecHit " << cell.detId() << " with enegy "
       << cell.energy() << " GeV was rejected!." << std::endl;
@@ -99,3 +97,88 @@ buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>& input,
     buildTopoCluster(input,rechitMask,nb,used,topocluster);
   }
 }
+
+bool Basic2DGenericTopoClusterizer::
+passesGatheringThreshold(int cell_layer, int cell_depth,
+			 double energy, double pt2) const {
+  auto const& thresholds = _thresholds.find(cell_layer)->second;
+  double thresholdE=0.;
+  double thresholdPT2=0.;
+
+  for (unsigned int j=0; j<(std::get<1>(thresholds)).size(); ++j) {
+    int depth=std::get<0>(thresholds)[j];
+
+    if( ( cell_layer == PFLayer::HCAL_BARREL1 && cell_depth == depth)
+	|| ( cell_layer == PFLayer::HCAL_ENDCAP && cell_depth == depth)
+	|| ( cell_layer != PFLayer::HCAL_BARREL1 && cell_layer != PFLayer::HCAL_ENDCAP )
+	) { thresholdE=std::get<1>(thresholds)[j]; thresholdPT2=std::get<2>(thresholds)[j]; }
+
+  }
+
+  return !( energy < thresholdE || pt2 < thresholdPT2 );
+}
+
+// Non-recursive variant of the topological clustering: the rechits that
+// pass the gathering thresholds are merged with their (unmasked, passing)
+// neighbours through a union-find over the flat neighbour arrays of the
+// PFRecHitSoA, and one topocluster is emitted per connected component
+// containing a seed, in order of decreasing seed energy. The clusters
+// contain the same rechits as the recursive version for symmetric
+// neighbour lists, listed in rechit index order rather than in depth-first
+// order.
+void Basic2DGenericTopoClusterizer::
+buildClustersUnionFind(const edm::Handle<reco::PFRecHitCollection>& input,
+		       const std::vector<bool>& rechitMask,
+		       const std::vector<unsigned int>& seeds,
+		       reco::PFClusterCollection& output) {
+  auto const & soa = *_soa;
+  const unsigned int nhits = soa.size();
+  if( nhits != input->size() ) {
+    throw cms::Exception("InvalidPFRecHitSoA")
+      << "the PFRecHitSoA has " << nhits << " rechits but the clustered"
+      << " collection " << input->size();
+  }
+  auto const & neighboursEnd = 
+    ( _useCornerCells ? soa.neighbours8End : soa.neighbours4End );
+
+  _passes.assign(nhits,false);
+  for( unsigned int i = 0; i < nhits; ++i ) {
+    _passes[i] = rechitMask[i] && 
+      passesGatheringThreshold(soa.layer[i],soa.depth[i],
+			       soa.energy[i],soa.pt2[i]);
+  }
+
+  _components.reset(nhits);
+  for( unsigned int i = 0; i < nhits; ++i ) {
+    if( !_passes[i] ) continue;
+    for( unsigned int k = soa.neighbourOffsets[i]; 
+	 k < neighboursEnd[i]; ++k ) {
+      const unsigned int nb = soa.neighbours[k];
+      if( _passes[nb] ) _components.merge(i,nb);
+    }
+  }
+
+  // one topocluster per component, ordered by the most energetic seed
+  _clusterOfRoot.assign(nhits,-1);
+  const unsigned int firstCluster = output.size();
+  for( auto seed : seeds ) {
+    if( !_passes[seed] ) {
+      LOGDRESSED("GenericTopoCluster::buildClustersUnionFind()")
+	<< "RecHit " << (*input)[seed].detId() << " with enegy "
+	<< soa.energy[seed] << " GeV was rejected!." << std::endl;
+      continue;
+    }
+    const unsigned int root = _components.find(seed);
+    if( _clusterOfRoot[root] >= 0 ) continue;
+    _clusterOfRoot[root] = output.size() - firstCluster;
+    output.emplace_back();
+  }
+
+  for( unsigned int i = 0; i < nhits; ++i ) {
+    if( !_passes[i] ) continue;
+    const int iclus = _clusterOfRoot[_components.find(i)];
+    if( iclus < 0 ) continue;
+    output[firstCluster+iclus].addRecHitFraction(
+      reco::PFRecHitFraction(makeRefhit(input,i), 1.0));
+  }
+}
@@ -2,7 +2,11 @@
 #define __Basic2DGenericTopoClusterizer_H__
 
 #include "RecoParticleFlow/PFClusterProducer/interface/InitialClusteringStepBase.h"
+#include "RecoParticleFlow/PFClusterProducer/interface/PFRecHitUnionFind.h"
 #include "DataFormats/ParticleFlowReco/interface/PFRecHitFraction.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHitSoA.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Utilities/interface/InputTag.h"
 
 class Basic2DGenericTopoClusterizer : public InitialClusteringStepBase {
   typedef Basic2DGenericTopoClusterizer B2DGT;
@@ -10,11 +14,19 @@ class Basic2DGenericTopoClusterizer : public InitialClusteringStepBase {
   Basic2DGenericTopoClusterizer(const edm::ParameterSet& conf,
 				edm::ConsumesCollector& sumes) :
     InitialClusteringStepBase(conf,sumes),
-    _useCornerCells(conf.getParameter<bool>("useCornerCells")) { }
+    _useCornerCells(conf.getParameter<bool>("useCornerCells")),
+    _useUnionFind(conf.getParameter<bool>("useUnionFind")) { 
+    // the union-find mode reads the flat copy of the rechits put by the
+    // PFRecHitProducer with produceSoA
+    const auto& soaTag = conf.getParameter<edm::InputTag>("recHitSoA");
+    if( _useUnionFind ) _soaToken = sumes.consumes<reco::PFRecHitSoA>(soaTag);
+  }
   ~Basic2DGenericTopoClusterizer() override = default;
   Basic2DGenericTopoClusterizer(const B2DGT&) = delete;
   B2DGT& operator=(const B2DGT&) = delete;
 
+  void updateEvent(const edm::Event&) override;
+
   void buildClusters(const edm::Handle<reco::PFRecHitCollection>&,
 		     const std::vector<bool>&,
 		     const std::vector<bool>&, 
@@ -22,11 +34,28 @@ class Basic2DGenericTopoClusterizer : public InitialClusteringStepBase {
   
  private:  
   const bool _useCornerCells;
+  const bool _useUnionFind;
+  edm::EDGetTokenT<reco::PFRecHitSoA> _soaToken;
+  const reco::PFRecHitSoA* _soa = nullptr;
+
+  // per-event buffers of the union-find mode, kept to reuse their capacity
+  PFRecHitUnionFind _components;
+  std::vector<int> _clusterOfRoot;
+  std::vector<bool> _passes;
+
+  bool passesGatheringThreshold(int layer, int depth, 
+				double energy, double pt2) const;
+
   void buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>&,
 			const std::vector<bool>&, // masked rechits
 			unsigned int, //present rechit
 			std::vector<bool>&, // hit usage state
 			reco::PFCluster&); // the topocluster
+
+  void buildClustersUnionFind(const edm::Handle<reco::PFRecHitCollection>&,
+			      const std::vector<bool>&, // masked rechits
+			      const std::vector<unsigned int>&, // sorted seeds
+			      reco::PFClusterCollection&);
   
 };
 
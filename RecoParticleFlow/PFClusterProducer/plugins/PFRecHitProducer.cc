@@ -1,4 +1,5 @@
 #include "RecoParticleFlow/PFClusterProducer/plugins/PFRecHitProducer.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHitSoA.h"
 #include "FWCore/Utilities/interface/RunningAverage.h"
 
 namespace {
@@ -11,11 +12,13 @@ namespace {
  edm::RunningAverage localRA2;
 }
 
- PFRecHitProducer:: PFRecHitProducer(const edm::ParameterSet& iConfig)
+ PFRecHitProducer:: PFRecHitProducer(const edm::ParameterSet& iConfig):
+  produceSoA_(iConfig.getParameter<bool>("produceSoA"))
 {
 
   produces<reco::PFRecHitCollection>();
   produces<reco::PFRecHitCollection>("Cleaned");
+  if( produceSoA_ ) produces<reco::PFRecHitSoA>();
 
   edm::ConsumesCollector iC = consumesCollector();
 
@@ -81,6 +84,12 @@ void
      navigator_->associateNeighbours(pfrechit,out,refProd);
    }
 
+   if( produceSoA_ ) {
+     auto soa = std::make_unique<reco::PFRecHitSoA>();
+     soa->fill(*out);
+     iEvent.put(std::move(soa));
+   }
+
    iEvent.put(std::move(out),"");
    iEvent.put(std::move(cleaned),"Cleaned");
 
@@ -88,10 +97,13 @@ void
 
 void
  PFRecHitProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
-  //The following says we do not know what parameters are allowed so do no validation
-  // Please change this to state exactly what you do use, even if it is no parameters
+  // the creators and the navigator are plugins with their own parameters,
+  // so only the parameters of the producer itself are validated
   edm::ParameterSetDescription desc;
-  desc.setUnknown();
+  // also put a reco::PFRecHitSoA copy of the rechits with the same indexing,
+  // for the union-find topological clustering
+  desc.add<bool>("produceSoA", false);
+  desc.setAllowAnything();
   descriptions.addDefault(desc);
 }
 
@@ -31,6 +31,7 @@ class PFRecHitProducer final : public edm::stream::EDProducer<> {
       void endLuminosityBlock(edm::LuminosityBlock const&, const edm::EventSetup &) override;
       std::vector<std::unique_ptr<PFRecHitCreatorBase> > creators_;
       std::unique_ptr<PFRecHitNavigatorBase> navigator_;
+      const bool produceSoA_;
       bool init_;
 };
 
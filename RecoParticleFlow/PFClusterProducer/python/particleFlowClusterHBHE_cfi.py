@@ -41,7 +41,10 @@ particleFlowClusterHBHE = cms.EDProducer(
                   gatheringThresholdPt = cms.vdouble(0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0)
                   )
         ),
-        useCornerCells = cms.bool(True)
+        useCornerCells = cms.bool(True),
+        # needs produceSoA in the rechit producer
+        useUnionFind = cms.bool(False),
+        recHitSoA = cms.InputTag("particleFlowRecHitHBHE")
     ),
     
     pfClusterBuilder = cms.PSet(
@@ -36,7 +36,10 @@ _topoClusterizer_HCAL = cms.PSet(
               gatheringThresholdPt = cms.double(0.0)
               )
     ),
-    useCornerCells = cms.bool(True)
+    useCornerCells = cms.bool(True),
+    # not available with the PFCTRecHitProducer rechits
+    useUnionFind = cms.bool(False),
+    recHitSoA = cms.InputTag("")
 )
 
 #position calc
@@ -41,7 +41,10 @@ _topoClusterizer_HFHAD = cms.PSet(
                  gatheringThresholdPt = cms.double(0.0)
                  )
        ),
-    useCornerCells = cms.bool(False)
+    useCornerCells = cms.bool(False),
+    # not available with the PFCTRecHitProducer rechits
+    useUnionFind = cms.bool(False),
+    recHitSoA = cms.InputTag("")
 )
 
 #position calc
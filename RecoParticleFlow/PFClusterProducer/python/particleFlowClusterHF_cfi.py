@@ -62,7 +62,10 @@ _topoClusterizer_HF = cms.PSet(
               )
 
     ),
-    useCornerCells = cms.bool(False)
+    useCornerCells = cms.bool(False),
+    # needs produceSoA in the rechit producer
+    useUnionFind = cms.bool(False),
+    recHitSoA = cms.InputTag("particleFlowRecHitHF")
 )
 
 #position calc
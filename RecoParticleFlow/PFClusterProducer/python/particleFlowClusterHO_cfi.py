@@ -35,7 +35,10 @@ _topoClusterizer_HO = cms.PSet(
               gatheringThresholdPt = cms.double(0.0)
               )
     ),
-    useCornerCells = cms.bool(True)
+    useCornerCells = cms.bool(True),
+    # needs produceSoA in the rechit producer
+    useUnionFind = cms.bool(False),
+    recHitSoA = cms.InputTag("particleFlowRecHitHO")
 )
 
 #position calc
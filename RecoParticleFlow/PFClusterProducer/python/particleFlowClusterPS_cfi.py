@@ -34,7 +34,10 @@ _topoClusterizer_PS = cms.PSet(
               gatheringThresholdPt = cms.double(0.0)
               )
     ),    
-    useCornerCells = cms.bool(False)
+    useCornerCells = cms.bool(False),
+    # needs produceSoA in the rechit producer
+    useUnionFind = cms.bool(False),
+    recHitSoA = cms.InputTag("particleFlowRecHitPS")
 )
 
 #position calc
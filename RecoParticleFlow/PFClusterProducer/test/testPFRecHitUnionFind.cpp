@@ -0,0 +1,75 @@
+#include "RecoParticleFlow/PFClusterProducer/interface/PFRecHitUnionFind.h"
+
+#include <cassert>
+#include <random>
+#include <vector>
+
+namespace {
+
+  // depth-first labelling, as in the recursive topological clustering
+  void visit(unsigned int i, int label,
+             const std::vector<unsigned int>& offsets,
+             const std::vector<unsigned int>& neighbours,
+             const std::vector<bool>& passes,
+             std::vector<int>& labels) {
+    labels[i] = label;
+    for (unsigned int k=offsets[i]; k<offsets[i+1]; ++k) {
+      const unsigned int nb = neighbours[k];
+      if (passes[nb] && labels[nb]<0) visit(nb, label, offsets, neighbours, passes, labels);
+    }
+  }
+
+}
+
+int main() {
+
+  // 8-connected cells of a nx*ny grid, listed in CSR form
+  constexpr int nx = 40, ny = 30;
+  constexpr unsigned int n = nx*ny;
+  std::vector<unsigned int> offsets(1,0), neighbours;
+  for (int iy=0; iy<ny; ++iy) {
+    for (int ix=0; ix<nx; ++ix) {
+      for (int dy=-1; dy<=1; ++dy)
+        for (int dx=-1; dx<=1; ++dx) {
+          const int jx = ix+dx, jy = iy+dy;
+          if ((dx||dy) && jx>=0 && jx<nx && jy>=0 && jy<ny) neighbours.push_back(jy*nx+jx);
+        }
+      offsets.push_back(neighbours.size());
+    }
+  }
+
+  std::mt19937 eng;
+  PFRecHitUnionFind components;
+  for (double occupancy : {0.1, 0.3, 0.5, 0.7}) {
+    std::bernoulli_distribution pass(occupancy);
+    std::vector<bool> passes(n);
+    for (unsigned int i=0; i<n; ++i) passes[i] = pass(eng);
+
+    std::vector<int> labels(n,-1);
+    int nlabels = 0;
+    for (unsigned int i=0; i<n; ++i)
+      if (passes[i] && labels[i]<0) visit(i, nlabels++, offsets, neighbours, passes, labels);
+
+    // merge in reverse order, the roots must not depend on it
+    components.reset(n);
+    for (unsigned int i=n; i-->0; ) {
+      if (!passes[i]) continue;
+      for (unsigned int k=offsets[i]; k<offsets[i+1]; ++k)
+        if (passes[neighbours[k]]) components.merge(i, neighbours[k]);
+    }
+
+    // same partition, and the root is the first cell of its component
+    std::vector<int> rootOfLabel(nlabels,-1);
+    for (unsigned int i=0; i<n; ++i) {
+      if (!passes[i]) continue;
+      const unsigned int root = components.find(i);
+      if (rootOfLabel[labels[i]]<0) {
+        rootOfLabel[labels[i]] = root;
+        assert(root==i);
+      }
+      assert(int(root)==rootOfLabel[labels[i]]);
+    }
+  }
+
+  return 0;
+}
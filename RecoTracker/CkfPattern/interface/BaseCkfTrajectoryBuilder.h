@@ -82,6 +82,18 @@ public:
   virtual void  rebuildTrajectories(TempTrajectory const& startingTraj, const TrajectorySeed& seed,
 				    TrajectoryContainer& result) const { assert(0==1);}
 
+  /** Number of seeds the builder wants to be given at once through
+   *  buildTrajectoriesForSeeds; 1 for builders working seed by seed. */
+  virtual unsigned int seedBatchSize() const { return 1; }
+
+  /** Build from n seeds at once: for each seed i fills startingTrajs[i],
+   *  result[i] and nCandPerSeed[i] as buildTrajectories would.
+   *  The default just loops over the seeds. */
+  virtual void buildTrajectoriesForSeeds(const TrajectorySeed* const* seeds, unsigned int n,
+					 TempTrajectory* startingTrajs,
+					 TrajectoryContainer* result,
+					 unsigned int* nCandPerSeed) const;
+
 
   void setNavigationSchool(NavigationSchool const * nv) { theNavigationSchool=nv;}
 
@@ -0,0 +1,226 @@
+#include "BatchedCkfTrajectoryBuilder.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "TrackingTools/GeomPropagators/interface/Propagator.h"
+#include "TrackingTools/PatternTools/interface/TrajectoryStateUpdator.h"
+#include "TrackingTools/KalmanUpdators/interface/KFUpdator.h"
+#include "TrackingTools/KalmanUpdators/interface/Chi2MeasurementEstimatorBase.h"
+#include "TrackingTools/PatternTools/interface/TrajMeasLessEstim.h"
+#include "TrackingTools/PatternTools/interface/TransverseImpactPointExtrapolator.h"
+#include "TrackingTools/MeasurementDet/interface/LayerMeasurements.h"
+#include "RecoTracker/MeasurementDet/interface/MeasurementTracker.h"
+#include "RecoTracker/MeasurementDet/interface/MeasurementTrackerEvent.h"
+
+#include "RecoTracker/CkfPattern/src/RecHitIsInvalid.h"
+#include "RecoTracker/CkfPattern/interface/IntermediateTrajectoryCleaner.h"
+
+#include <algorithm>
+#include <numeric>
+
+
+BatchedCkfTrajectoryBuilder::BatchedCkfTrajectoryBuilder(const edm::ParameterSet& conf, edm::ConsumesCollector& iC):
+  CkfTrajectoryBuilder(conf, iC),
+  theSeedBatchSize(std::max(1U, conf.getParameter<unsigned int>("seedBatchSize")))
+{}
+
+
+void BatchedCkfTrajectoryBuilder::measureAll(const TrajectorySeed* const* seeds,
+					     std::vector<Candidate>& cands,
+					     std::vector<LayerItem>& items) const
+{
+  // navigation: the (candidate, layer) pairs of this step
+  for (unsigned int ic=0; ic<cands.size(); ++ic) {
+    auto & cand = cands[ic];
+    auto const & seed = *seeds[cand.seed];
+    auto const & traj = *cand.traj;
+    cand.firstLayer = items.size();
+    StateAndLayers && stateAndLayers = findStateAndLayers(seed,traj);
+    for (auto layer : stateAndLayers.second) {
+      TSOS stateToUse = stateAndLayers.first;
+      if unlikely (!traj.empty() && layer==traj.lastLayer()) {
+	  // self navigation case: go to a middle point first
+	  TransverseImpactPointExtrapolator middle;
+	  GlobalPoint center(0,0,0);
+	  stateToUse = middle.extrapolate(stateToUse, center, *forwardPropagator(seed));
+	  if (!stateToUse.isValid()) continue;
+	}
+      items.push_back(LayerItem{layer, ic, std::move(stateToUse), std::vector<TM>()});
+    }
+    cand.nLayers = items.size() - cand.firstLayer;
+  }
+
+  // measurements: all candidates going to the same layer one after the other
+  std::vector<unsigned int> order(items.size());
+  std::iota(order.begin(), order.end(), 0U);
+  std::stable_sort(order.begin(), order.end(),
+		   [&](unsigned int i, unsigned int j) { return items[i].layer < items[j].layer; });
+  LayerMeasurements layerMeasurements(theMeasurementTracker->measurementTracker(), *theMeasurementTracker);
+  for (auto i : order) {
+    auto & item = items[i];
+    auto const & seed = *seeds[cands[item.cand].seed];
+    item.meas = layerMeasurements.measurements(*item.layer, item.state, *forwardPropagator(seed), *theEstimator);
+  }
+
+  // merge per candidate in navigation order, as findCompatibleMeasurements does
+  for (auto & cand : cands) {
+    auto & result = cand.meas;
+    int invalidHits = 0;
+    for (unsigned int il=cand.firstLayer; il<cand.firstLayer+cand.nLayers; ++il) {
+      auto & tmp = items[il].meas;
+      if (tmp.empty()) continue;
+      if (result.empty()) result.swap(tmp);
+      else {
+	// keep one dummy TM at the end, skip the others
+	result.insert( result.end()-invalidHits,
+		       std::make_move_iterator(tmp.begin()), std::make_move_iterator(tmp.end()));
+      }
+      invalidHits++;
+    }
+    // sort the final result, keep dummy measurements at the end
+    if ( result.size() > 1) {
+      std::sort( result.begin(), result.end()-invalidHits, TrajMeasLessEstim());
+    }
+
+    // measurements to continue with
+    auto last = result.end();
+    if ( !theAlwaysUseInvalidHits && !result.empty() && result.front().recHit()->isValid())
+      last = std::find_if( result.begin(), result.end(), RecHitIsInvalid());
+    cand.nUsed = last - result.begin();
+  }
+}
+
+
+void BatchedCkfTrajectoryBuilder::updateAll(std::vector<Candidate>& cands,
+					    std::vector<TSOS>& updated) const
+{
+  std::vector<TSOS> predicted;
+  std::vector<const TrackingRecHit*> hits;
+  for (auto const & cand : cands)
+    for (unsigned int im=0; im<cand.nUsed; ++im) {
+      auto const & tm = cand.meas[im];
+      if (!tm.recHit()->isValid()) continue;
+      predicted.push_back(tm.predictedState());
+      hits.push_back(tm.recHit().get());
+    }
+
+  updated.resize(predicted.size());
+  auto kfUpdator = dynamic_cast<const KFUpdator*>(theUpdator);
+  if (kfUpdator) kfUpdator->update(predicted.data(), hits.data(), predicted.size(), updated.data());
+  else
+    for (unsigned int i=0; i<predicted.size(); ++i)
+      updated[i] = theUpdator->update(predicted[i], *hits[i]);
+}
+
+
+void BatchedCkfTrajectoryBuilder::buildTrajectoriesForSeeds(const TrajectorySeed* const* seeds, unsigned int n,
+							    TempTrajectory* startingTrajs,
+							    TrajectoryContainer* result,
+							    unsigned int* nCandPerSeed) const
+{
+  if (theMeasurementTracker == nullptr) {
+      throw cms::Exception("LogicError") << "Asking to create trajectories to an un-initialized CkfTrajectoryBuilder.\nYou have to call clone(const MeasurementTrackerEvent *data) and then call trajectories on it instead.\n";
+  }
+
+  auto trajCandLess = [&](TempTrajectory const & a, TempTrajectory const & b) {
+    return  (a.chiSquared() + a.lostHits()*theLostHitPenalty)  <
+    (b.chiSquared() + b.lostHits()*theLostHitPenalty);
+  };
+
+  std::vector<boost::shared_ptr<const TrajectorySeed> > sharedSeeds(n);
+  std::vector<TempTrajectoryContainer> candidates(n);
+  std::vector<unsigned int> prevNewCandSize(n,0);
+  for (unsigned int is=0; is<n; ++is) {
+    startingTrajs[is] = createStartingTrajectory(*seeds[is]);
+    candidates[is].push_back(startingTrajs[is]);
+    sharedSeeds[is].reset(new TrajectorySeed(*seeds[is]));
+    nCandPerSeed[is] = 0;
+  }
+
+  std::vector<Candidate> cands;
+  std::vector<LayerItem> items;
+  std::vector<TSOS> updated;
+  TempTrajectoryContainer newCand;
+  newCand.reserve(2*theMaxCand);
+
+  unsigned int nIter=1;
+  while (true) {
+    cands.clear();
+    items.clear();
+    for (unsigned int is=0; is<n; ++is)
+      for (auto & traj : candidates[is])
+	cands.push_back(Candidate{is, &traj, std::vector<TM>(), 0, 0, 0});
+    if (cands.empty()) break;
+
+    measureAll(seeds, cands, items);
+    updateAll(cands, updated);
+
+    // new candidates, seed by seed, exactly as in limitedCandidates
+    auto nextUpdate = updated.begin();
+    auto cand = cands.begin();
+    for (unsigned int is=0; is<n; ++is) {
+      if (cand==cands.end() || cand->seed!=is) continue;
+      newCand.clear();
+      bool aborted = false;
+      for (; cand!=cands.end() && cand->seed==is; ++cand) {
+	auto & traj = *cand->traj;
+	auto & meas = cand->meas;
+
+	// --- method for debugging
+	if(aborted || !analyzeMeasurementsDebugger(traj,meas,
+						   theMeasurementTracker,
+						   forwardPropagator(*seeds[is]),theEstimator,
+						   theTTRHBuilder)) {
+	  // building of this seed stops here: skip the updates done for it
+	  aborted = true;
+	  for (unsigned int im=0; im<cand->nUsed; ++im) if (meas[im].recHit()->isValid()) ++nextUpdate;
+	  continue;
+	}
+	// ---
+
+	if ( meas.empty()) {
+	  addToResult(sharedSeeds[is], traj, result[is]);
+	}
+	else {
+	  for (unsigned int im=0; im<cand->nUsed; ++im) {
+	    auto & tm = meas[im];
+	    TempTrajectory newTraj = traj;
+	    if ( tm.recHit()->isValid()) {
+	      newTraj.emplace( std::move(tm.predictedState()), std::move(*nextUpdate++),
+			       std::move(tm.recHit()), tm.estimate(), tm.layer());
+	    }
+	    else {
+	      newTraj.emplace( std::move(tm.predictedState()), std::move(tm.recHit()), 0, tm.layer());
+	    }
+
+	    if ( toBeContinued(newTraj)) {
+	      newCand.push_back(std::move(newTraj));  std::push_heap(newCand.begin(),newCand.end(),trajCandLess);
+	    }
+	    else {
+	      addToResult(sharedSeeds[is], newTraj, result[is]);
+	    }
+	  }
+	}
+
+	nCandPerSeed[is] += newCand.size() - prevNewCandSize[is];
+	prevNewCandSize[is] = newCand.size();
+
+	while ((int)newCand.size() > theMaxCand) {
+	  std::pop_heap(newCand.begin(),newCand.end(),trajCandLess);
+	  newCand.pop_back();
+	}
+      }
+
+      if (aborted) {
+	candidates[is].clear();
+	continue;
+      }
+      std::sort_heap(newCand.begin(),newCand.end(),trajCandLess);
+      if (theIntermediateCleaning) IntermediateTrajectoryCleaner::clean(newCand);
+      candidates[is].swap(newCand);
+    }
+
+    LogDebug("CkfPattern") << cands.size() << " candidates of " << n << " seeds on "
+			   << items.size() << " layers after " << nIter++ << " batched CKF iteration";
+  }
+}
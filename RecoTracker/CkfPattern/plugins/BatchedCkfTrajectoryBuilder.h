@@ -0,0 +1,71 @@
+#ifndef BatchedCkfTrajectoryBuilder_H
+#define BatchedCkfTrajectoryBuilder_H
+
+#include "RecoTracker/CkfPattern/interface/CkfTrajectoryBuilder.h"
+
+#include "FWCore/Utilities/interface/Visibility.h"
+
+#include <vector>
+
+
+/** CkfTrajectoryBuilder working on many seeds at once.
+ *  The candidates of all seeds are advanced together, one CKF step at a
+ *  time, in a single thread: at each step the candidates heading to the
+ *  same layer are measured back to back (each with its own propagations,
+ *  as in CkfTrajectoryBuilder), and the Kalman updates of all the new
+ *  candidates are done in one batch (in SoA form if the updator is a
+ *  KFUpdator). The batched update uses the expanded Joseph form, so the
+ *  states agree with CkfTrajectoryBuilder to rounding only; the
+ *  trajectories can differ when two candidates of a seed are that close
+ *  in chi2. The batches of seeds are built one after the other unless
+ *  the track candidate maker is compiled for parallel seed loops.
+ *  Selected with ComponentType = "BatchedCkfTrajectoryBuilder";
+ *  "seedBatchSize" sets how many seeds the track candidate maker hands
+ *  over at once.
+ */
+
+class dso_internal BatchedCkfTrajectoryBuilder final : public CkfTrajectoryBuilder {
+
+public:
+
+  BatchedCkfTrajectoryBuilder(const edm::ParameterSet& conf, edm::ConsumesCollector& iC);
+
+  ~BatchedCkfTrajectoryBuilder() override {}
+
+  unsigned int seedBatchSize() const override { return theSeedBatchSize; }
+
+  void buildTrajectoriesForSeeds(const TrajectorySeed* const* seeds, unsigned int n,
+				 TempTrajectory* startingTrajs,
+				 TrajectoryContainer* result,
+				 unsigned int* nCandPerSeed) const override;
+
+private:
+  // a running candidate during one step
+  struct Candidate {
+    unsigned int seed;
+    TempTrajectory* traj;
+    std::vector<TM> meas;        // compatible measurements, as from findCompatibleMeasurements
+    unsigned int nUsed;          // measurements in meas to continue with
+    unsigned int firstLayer;     // first of its entries in the layer list
+    unsigned int nLayers;
+  };
+
+  // one (candidate, layer) pair to be measured during one step
+  struct LayerItem {
+    const DetLayer* layer;
+    unsigned int cand;
+    TSOS state;
+    std::vector<TM> meas;
+  };
+
+  void measureAll(const TrajectorySeed* const* seeds,
+		  std::vector<Candidate>& cands,
+		  std::vector<LayerItem>& items) const;
+
+  void updateAll(std::vector<Candidate>& cands,
+		 std::vector<TSOS>& updated) const;
+
+  unsigned int theSeedBatchSize;
+};
+
+#endif
@@ -0,0 +1,9 @@
+import FWCore.ParameterSet.Config as cms
+
+from RecoTracker.CkfPattern.CkfTrajectoryBuilder_cfi import CkfTrajectoryBuilder as _CkfTrajectoryBuilder
+
+# same as CkfTrajectoryBuilder, building the candidates of seedBatchSize seeds together
+BatchedCkfTrajectoryBuilder = _CkfTrajectoryBuilder.clone(
+    ComponentType = cms.string('BatchedCkfTrajectoryBuilder'),
+    seedBatchSize = cms.uint32(64)
+)
@@ -121,6 +121,17 @@ createStartingTrajectory( const TrajectorySeed& seed) const
 }
 
 
+void BaseCkfTrajectoryBuilder::
+buildTrajectoriesForSeeds(const TrajectorySeed* const* seeds, unsigned int n,
+			  TempTrajectory* startingTrajs,
+			  TrajectoryContainer* result,
+			  unsigned int* nCandPerSeed) const
+{
+  for (unsigned int i=0; i<n; ++i)
+    startingTrajs[i] = buildTrajectories(*seeds[i], result[i], nCandPerSeed[i], nullptr);
+}
+
+
 bool BaseCkfTrajectoryBuilder::toBeContinued (TempTrajectory& traj, bool inOut) const
 {
   if unlikely(traj.measurements().size() > 400) {
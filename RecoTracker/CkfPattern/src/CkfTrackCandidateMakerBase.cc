@@ -267,30 +267,21 @@ namespace cms{
 #endif
 
       std::atomic<unsigned int> ntseed(0);
-      auto theLoop = [&](size_t ii) {
-        auto j = indeces[ii];
-
-        ntseed++;
 
-        // to be moved inside a par section (how with tbb??)
-        std::vector<Trajectory> theTmpTrajectories;
-
-
-	LogDebug("CkfPattern") << "======== Begin to look for trajectories from seed " << j << " ========\n";
-
-        { Lock lock(theMutex);
-	// Check if seed hits already used by another track
+      // Check if seed hits already used by another track
+      auto seedIsGood = [&](size_t j) {
+        Lock lock(theMutex);
 	if (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j])) ) {
           LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
           (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
-          return;  // from the lambda!
-        }}
-
+          return false;
+        }
+        return true;
+      };
 
-	// Build trajectory from seed outwards
-        theTmpTrajectories.clear();
-        unsigned int nCandPerSeed = 0;
-        auto const & startTraj = theTrajectoryBuilder->buildTrajectories( (*collseed)[j], theTmpTrajectories, nCandPerSeed, nullptr );
+      // everything after the in-out building of the trajectories from seed j
+      auto processTrajectories = [&](size_t j, TempTrajectory const & startTraj,
+                                     std::vector<Trajectory> & theTmpTrajectories, unsigned int nCandPerSeed) {
         {
           Lock lock(theMutex);
           (*outputSeedStopInfos)[j].setCandidatesPerSeed(nCandPerSeed);
@@ -369,9 +360,63 @@ namespace cms{
         }
 
       };
+
+      auto theLoop = [&](size_t ii) {
+        auto j = indeces[ii];
+
+        ntseed++;
+
+        // to be moved inside a par section (how with tbb??)
+        std::vector<Trajectory> theTmpTrajectories;
+
+
+	LogDebug("CkfPattern") << "======== Begin to look for trajectories from seed " << j << " ========\n";
+
+        if (!seedIsGood(j)) return;  // from the lambda!
+
+	// Build trajectory from seed outwards
+        theTmpTrajectories.clear();
+        unsigned int nCandPerSeed = 0;
+        auto const & startTraj = theTrajectoryBuilder->buildTrajectories( (*collseed)[j], theTmpTrajectories, nCandPerSeed, nullptr );
+        processTrajectories(j, startTraj, theTmpTrajectories, nCandPerSeed);
+      };
       // end of loop over seeds
 
+      // Builders working on many seeds at once get them in batches;
+      // the seed cleaning then only sees the trajectories of previous batches
+      const unsigned int seedBatchSize = theTrajectoryBuilder->seedBatchSize();
+      auto theBatchLoop = [&](size_t first) {
+        auto last = std::min(first+seedBatchSize, collseed_size);
+        std::vector<const TrajectorySeed*> seeds;
+        std::vector<size_t> seedIndeces;
+        for (auto ii = first; ii < last; ++ii) {
+          auto j = indeces[ii];
+          ntseed++;
+          if (!seedIsGood(j)) continue;
+          seeds.push_back(&(*collseed)[j]);
+          seedIndeces.push_back(j);
+        }
+        std::vector<TempTrajectory> startTrajs(seeds.size());
+        std::vector<std::vector<Trajectory> > tmpTrajectories(seeds.size());
+        std::vector<unsigned int> nCandPerSeed(seeds.size(), 0);
+        theTrajectoryBuilder->buildTrajectoriesForSeeds(seeds.data(), seeds.size(),
+                                                        startTrajs.data(), tmpTrajectories.data(), nCandPerSeed.data());
+        for (unsigned int is = 0; is < seeds.size(); ++is)
+          processTrajectories(seedIndeces[is], startTrajs[is], tmpTrajectories[is], nCandPerSeed[is]);
+      };
 
+      if (seedBatchSize > 1) {
+        const size_t nBatches = (collseed_size+seedBatchSize-1)/seedBatchSize;
+#ifdef VI_TBB
+     tbb::parallel_for(0UL,nBatches,1UL,[&](size_t ib) { theBatchLoop(ib*seedBatchSize); });
+#else
+#ifdef VI_OMP
+#pragma omp parallel for schedule(dynamic,1)
+#endif
+        for (size_t ib = 0; ib < nBatches; ++ib)
+          theBatchLoop(ib*seedBatchSize);
+#endif
+      } else {
 #ifdef VI_TBB
      tbb::parallel_for(0UL,collseed_size,1UL,theLoop);
 #else
@@ -382,6 +427,7 @@ namespace cms{
        theLoop(j);
       }
 #endif
+      }
       assert(ntseed==collseed_size);
       if (theSeedCleaner) theSeedCleaner->done();
 
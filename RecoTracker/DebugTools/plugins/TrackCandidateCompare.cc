@@ -0,0 +1,141 @@
+// Compares two TrackCandidateCollections built from the same seeds, seed by
+// seed: same number of candidates, same hits (same detector and same
+// clusters) in the same order, and starting states equal within a relative
+// tolerance. Meant to check a trajectory builder against a reference one on
+// real events; the job fails at the end if more than a given fraction of
+// the seeds differ.
+
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include "DataFormats/TrackCandidate/interface/TrackCandidateCollection.h"
+
+#include <atomic>
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <vector>
+
+class TrackCandidateCompare : public edm::global::EDAnalyzer<> {
+public:
+  explicit TrackCandidateCompare(const edm::ParameterSet& conf);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  void analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const override;
+  void endJob() override;
+
+private:
+  typedef std::map<unsigned int, std::vector<const TrackCandidate*> > BySeed;
+
+  static BySeed bySeed(const TrackCandidateCollection& cands);
+  bool sameCandidate(const TrackCandidate& a, const TrackCandidate& b) const;
+
+  const edm::EDGetTokenT<TrackCandidateCollection> referenceToken_;
+  const edm::EDGetTokenT<TrackCandidateCollection> targetToken_;
+  const double maxRelativeDifference_;
+  const double maxDifferentSeedFraction_;
+
+  mutable std::atomic<unsigned long long> nSeeds_;
+  mutable std::atomic<unsigned long long> nDifferentSeeds_;
+};
+
+
+TrackCandidateCompare::TrackCandidateCompare(const edm::ParameterSet& conf) :
+  referenceToken_(consumes<TrackCandidateCollection>(conf.getParameter<edm::InputTag>("reference"))),
+  targetToken_(consumes<TrackCandidateCollection>(conf.getParameter<edm::InputTag>("target"))),
+  maxRelativeDifference_(conf.getParameter<double>("maxRelativeDifference")),
+  maxDifferentSeedFraction_(conf.getParameter<double>("maxDifferentSeedFraction")),
+  nSeeds_(0),
+  nDifferentSeeds_(0)
+{}
+
+
+void TrackCandidateCompare::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("reference", edm::InputTag());
+  desc.add<edm::InputTag>("target", edm::InputTag());
+  desc.add<double>("maxRelativeDifference", 1.e-6);
+  desc.add<double>("maxDifferentSeedFraction", 0.);
+  descriptions.add("trackCandidateCompare", desc);
+}
+
+
+TrackCandidateCompare::BySeed TrackCandidateCompare::bySeed(const TrackCandidateCollection& cands) {
+  BySeed result;
+  for (auto const & cand : cands) result[cand.seedRef().key()].push_back(&cand);
+  return result;
+}
+
+
+bool TrackCandidateCompare::sameCandidate(const TrackCandidate& a, const TrackCandidate& b) const {
+  if (std::distance(a.recHits().first, a.recHits().second) !=
+      std::distance(b.recHits().first, b.recHits().second)) return false;
+  auto hb = b.recHits().first;
+  for (auto ha = a.recHits().first; ha != a.recHits().second; ++ha, ++hb) {
+    if (ha->geographicalId() != hb->geographicalId() || ha->isValid() != hb->isValid()) return false;
+    if (ha->isValid() && !ha->sharesInput(&*hb, TrackingRecHit::all)) return false;
+  }
+  auto const & sa = a.trajectoryStateOnDet();
+  auto const & sb = b.trajectoryStateOnDet();
+  if (sa.detId() != sb.detId()) return false;
+  auto const & va = sa.parameters().vector();
+  auto const & vb = sb.parameters().vector();
+  for (unsigned int i=0; i<5; ++i)
+    if (std::abs(va(i)-vb(i)) > maxRelativeDifference_*std::max(1.,std::abs(vb(i)))) return false;
+  return true;
+}
+
+
+void TrackCandidateCompare::analyze(edm::StreamID, const edm::Event& ev, const edm::EventSetup&) const {
+  edm::Handle<TrackCandidateCollection> reference, target;
+  ev.getByToken(referenceToken_, reference);
+  ev.getByToken(targetToken_, target);
+
+  auto const & ref = bySeed(*reference);
+  auto const & tgt = bySeed(*target);
+
+  // seeds with candidates in either collection
+  unsigned int nSeeds = 0, nDifferent = 0;
+  auto ir = ref.begin();
+  auto it = tgt.begin();
+  while (ir != ref.end() || it != tgt.end()) {
+    ++nSeeds;
+    bool same = false;
+    if (it == tgt.end() || (ir != ref.end() && ir->first < it->first)) ++ir;
+    else if (ir == ref.end() || it->first < ir->first) ++it;
+    else {
+      auto const & cr = ir->second;
+      auto const & ct = it->second;
+      same = cr.size() == ct.size();
+      for (unsigned int i=0; same && i<cr.size(); ++i) same = sameCandidate(*cr[i], *ct[i]);
+      ++ir; ++it;
+    }
+    if (!same) ++nDifferent;
+  }
+
+  LogDebug("TrackCandidateCompare") << nDifferent << " of " << nSeeds << " seeds with different candidates, "
+				    << reference->size() << " reference and " << target->size() << " candidates";
+  nSeeds_ += nSeeds;
+  nDifferentSeeds_ += nDifferent;
+}
+
+
+void TrackCandidateCompare::endJob() {
+  edm::LogPrint("TrackCandidateCompare") << nDifferentSeeds_ << " of " << nSeeds_
+					 << " seeds with different candidates";
+  if (nDifferentSeeds_ > maxDifferentSeedFraction_*nSeeds_)
+    throw cms::Exception("TrackCandidateCompare") << nDifferentSeeds_ << " of " << nSeeds_
+						  << " seeds with different candidates, more than the allowed fraction "
+						  << maxDifferentSeedFraction_;
+}
+
+
+DEFINE_FWK_MODULE(TrackCandidateCompare);
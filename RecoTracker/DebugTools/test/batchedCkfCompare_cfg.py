@@ -0,0 +1,78 @@
+# Builds the InitialStep track candidates twice from the same seeds, with the
+# CkfTrajectoryBuilder and with the BatchedCkfTrajectoryBuilder, and compares
+# them seed by seed. The input is a file written by trackingBenchmark_cfg.py in
+# record mode (clusters, rechits and seeds):
+#
+#   cmsRun batchedCkfCompare_cfg.py inputFiles=file:tracking.root maxEvents=100
+#
+# The batched Kalman update agrees with the scalar one to rounding only, so a
+# seed can end up with different candidates when two of them are that close in
+# chi2: maxDifferentSeedFraction bounds how often this may happen.
+# The seed cleaning is switched off in both, as the batched builder only sees the
+# candidates of the previous batches when cleaning.
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.register('seedBatchSize', 64, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "number of seeds given at once to the batched builder")
+options.register('maxDifferentSeedFraction', 0.001, VarParsing.multiplicity.singleton, VarParsing.varType.float,
+                 "largest fraction of seeds allowed to have different candidates")
+options.register('era', 'Run2_2017', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "era of the events")
+options.register('globalTag', 'auto:phase1_2017_realistic', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "global tag")
+options.parseArguments()
+
+from Configuration.StandardSequences.Eras import eras
+process = cms.Process('CKFCOMPARE', getattr(eras, options.era))
+
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.Reconstruction_cff')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, options.globalTag, '')
+
+process.source = cms.Source('PoolSource', fileNames = cms.untracked.vstring(options.inputFiles))
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(options.maxEvents))
+
+# the same builder parameters as InitialStep, for both builders
+from RecoTracker.CkfPattern.CkfTrajectoryBuilder_cfi import CkfTrajectoryBuilder as _CkfTrajectoryBuilder
+from RecoTracker.CkfPattern.BatchedCkfTrajectoryBuilder_cfi import BatchedCkfTrajectoryBuilder as _BatchedCkfTrajectoryBuilder
+_builderParameters = dict(
+    trajectoryFilter = dict(refToPSet_ = 'initialStepTrajectoryFilter'),
+    alwaysUseInvalidHits = True,
+    maxCand = process.initialStepTrajectoryBuilder.maxCand.value(),
+    estimator = 'initialStepChi2Est',
+)
+process.compareCkfTrajectoryBuilder = _CkfTrajectoryBuilder.clone(**_builderParameters)
+process.compareBatchedCkfTrajectoryBuilder = _BatchedCkfTrajectoryBuilder.clone(
+    seedBatchSize = options.seedBatchSize,
+    **_builderParameters
+)
+
+_candidates = process.initialStepTrackCandidates.clone(
+    RedundantSeedCleaner = 'none',
+    doSeedingRegionRebuilding = False,
+)
+process.ckfCandidates = _candidates.clone(
+    TrajectoryBuilderPSet = cms.PSet(refToPSet_ = cms.string('compareCkfTrajectoryBuilder'))
+)
+process.batchedCkfCandidates = _candidates.clone(
+    TrajectoryBuilderPSet = cms.PSet(refToPSet_ = cms.string('compareBatchedCkfTrajectoryBuilder'))
+)
+
+process.compare = cms.EDAnalyzer('TrackCandidateCompare',
+    reference = cms.InputTag('ckfCandidates'),
+    target = cms.InputTag('batchedCkfCandidates'),
+    maxRelativeDifference = cms.double(1.e-6),
+    maxDifferentSeedFraction = cms.double(options.maxDifferentSeedFraction)
+)
+
+process.compareTask = cms.Task(process.MeasurementTrackerEvent, process.ckfCandidates, process.batchedCkfCandidates)
+process.comparePath = cms.Path(process.compare, process.compareTask)
@@ -0,0 +1,155 @@
+# Standalone throughput benchmark of the tracking steps on a fixed set of events.
+#
+# First record the inputs once, running the local and tracking reconstruction on
+# RAW and keeping the clusters and all the intermediate tracking products:
+#
+#   cmsRun trackingBenchmark_cfg.py mode=record inputFiles=file:raw.root outputFile=tracking.root maxEvents=200
+#
+# then replay one step of one iteration, reading everything it needs from that file:
+#
+#   cmsRun trackingBenchmark_cfg.py inputFiles=file:tracking.root iteration=InitialStep step=building threads=8 repeat=5
+#
+# Steps are 'seeding' (cluster masks, regions, hits and seeds), 'building' (track
+# candidates), 'fitting' (tracks) and
+# 'selection' (classifiers), or 'all' for the whole iteration. The modules of the
+# iteration task that are not its own (the first step vertices, the calorimeter
+# jets) are not replayed but read from the file: the jets need calorimeter rechits,
+# which are not recorded.
+# The FastTimerService job summary gives the time and memory allocated (with
+# jemalloc) per module, the DQM file the per-module latency distributions and the
+# throughput in events/s. For an offline machine, point conditions to a local
+# sqlite snapshot of the global tag with conditions=sqlite_file:snapshot.db.
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.register('mode', 'replay', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "'record' the tracking products, or 'replay' a step")
+options.register('iteration', 'InitialStep', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "tracking iteration to replay")
+options.register('step', 'all', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "step to replay: seeding, building, fitting, selection or all")
+options.register('threads', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "number of threads")
+options.register('streams', 0, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "number of streams (0: one per thread)")
+options.register('repeat', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "number of times the input files are read")
+options.register('era', 'Run2_2017', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "era of the events")
+options.register('globalTag', 'auto:phase1_2017_realistic', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "global tag")
+options.register('conditions', '', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 "connection string of a local copy of the global tag")
+options.setDefault('outputFile', 'tracking.root')
+options.parseArguments()
+
+if options.mode not in ('record', 'replay'):
+    raise Exception("unknown mode '%s'" % options.mode)
+_steps = ('seeding', 'building', 'fitting', 'selection', 'all')
+if options.step not in _steps:
+    raise Exception("unknown step '%s', expected one of %s" % (options.step, ', '.join(_steps)))
+
+from Configuration.StandardSequences.Eras import eras
+process = cms.Process('TRKRECORD' if options.mode == 'record' else 'TRKBENCH', getattr(eras, options.era))
+
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.MessageLogger.cerr.FwkReport.reportEvery = 100
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.RawToDigi_cff')
+process.load('Configuration.StandardSequences.Reconstruction_cff')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, options.globalTag, '')
+if options.conditions:
+    process.GlobalTag.connect = options.conditions
+
+process.source = cms.Source('PoolSource',
+    fileNames = cms.untracked.vstring(options.inputFiles * options.repeat),
+    duplicateCheckMode = cms.untracked.string('noDuplicateCheck')
+)
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(options.maxEvents))
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.threads),
+    numberOfStreams = cms.untracked.uint32(options.streams),
+    wantSummary = cms.untracked.bool(True)
+)
+
+import RecoTracker.IterativeTracking.iterativeTkConfig as _iterativeTkConfig
+# the modules of an iteration task that are not of the iteration (vertices, jets, ...)
+def _foreignModules(iteration):
+    prefix = _iterativeTkConfig._modulePrefix(iteration)
+    return [l for l in getattr(process, iteration + 'Task').moduleNames() if not l.startswith(prefix)]
+
+if options.mode == 'record':
+    # the products of the modules shared by the iterations, for the replay to read them
+    _iterations = set(i for v in dir(_iterativeTkConfig) if v.startswith('_iterations') for i in getattr(_iterativeTkConfig, v))
+    _shared = sorted(set(l for i in _iterations if hasattr(process, i + 'Task') for l in _foreignModules(i)))
+    process.reconstructionStep = cms.Path(process.RawToDigi * process.reconstruction_trackingOnly)
+    process.output = cms.OutputModule('PoolOutputModule',
+        fileName = cms.untracked.string(options.outputFile),
+        outputCommands = cms.untracked.vstring(
+            'drop *',
+            'keep *_offlineBeamSpot_*_*',
+            'keep *_siPixelDigis_*_*',
+            'keep *_siStripDigis_*_*',
+            'keep *_siPixelClusters*_*_*',
+            'keep *_siStripClusters_*_*',
+            'keep *_siPixelRecHits*_*_*',
+            'keep *_siStripMatchedRecHits_*_*',
+            'keep *_*Step*_*_*',
+            'keep *_firstStepPrimaryVertices*_*_*',
+            'keep *_ak4CaloJetsForTrk_*_*',
+        )
+    )
+    process.output.outputCommands.extend('keep *_%s_*_*' % l for l in _shared)
+    process.outputStep = cms.EndPath(process.output)
+
+else:
+    prefix = _iterativeTkConfig._modulePrefix(options.iteration)
+    task = getattr(process, options.iteration + 'Task')
+
+    def stepOf(label):
+        if label in (prefix + 'TrackCandidates', prefix + 'MeasurementTrackerEvent'):
+            return 'building'
+        if label == prefix + 'Tracks':
+            return 'fitting'
+        if label in (prefix, prefix + 'Selector') or label.startswith(prefix + 'Classifier'):
+            return 'selection'
+        return 'seeding'
+
+    # the modules of the task without the prefix of the iteration (caloJetsForTrk, the
+    # first step vertices, ...) are not replayed: their products were recorded, while
+    # their own inputs (e.g. the calorimeter rechits) were not
+    foreign = set(_foreignModules(options.iteration))
+    labels = sorted(l for l in task.moduleNames() if l not in foreign and options.step in ('all', stepOf(l)))
+    if not labels:
+        raise Exception("no module of %s for step '%s'" % (options.iteration, options.step))
+    # one path per module, so that they run in the order of their data dependencies;
+    # everything else is read from the recorded file, except the non persistent
+    # MeasurementTrackerEvent that is built again if the step uses it
+    process.benchmarkTask = cms.Task(process.MeasurementTrackerEvent)
+    for l in labels:
+        setattr(process, 'benchmark_' + l, cms.Path(getattr(process, l), process.benchmarkTask))
+    print('Replaying %s of %s with %d threads: %s' % (options.step, options.iteration, options.threads, ' '.join(labels)))
+
+# timing, memory and throughput
+process.load('HLTrigger.Timer.FastTimerService_cfi')
+process.FastTimerService.printEventSummary = False
+process.FastTimerService.printRunSummary   = False
+process.FastTimerService.printJobSummary   = True
+process.FastTimerService.enableDQM         = True
+process.FastTimerService.enableDQMbyModule = True
+process.FastTimerService.dqmPath           = 'Tracking/TimerService'
+process.load('HLTrigger.Timer.ThroughputService_cfi')
+process.ThroughputService.dqmPath          = 'Tracking/Throughput'
+
+process.load('DQMServices.Core.DQMStore_cfi')
+process.load('DQMServices.Components.DQMFileSaver_cfi')
+process.dqmSaver.workflow = '/TrackingBenchmark/%s/%s' % (options.iteration if options.mode == 'replay' else 'All', options.step if options.mode == 'replay' else 'record')
+process.dqmOutput = cms.EndPath(process.dqmSaver)
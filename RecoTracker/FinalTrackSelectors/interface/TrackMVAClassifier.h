@@ -87,9 +87,28 @@ private:
 		    reco::VertexCollection const & vertices,
 		    MVACollection & mvas) const final {
 
+      computeAll(mva,tracks,beamSpot,vertices,mvas,0);
+    }
+
+    // MVAs able to classify all the tracks at once provide operator()(tracks,beamSpot,vertices,mvas)
+    template<typename M>
+    static auto computeAll(M const & m,
+			   reco::TrackCollection const & tracks,
+			   reco::BeamSpot const & beamSpot,
+			   reco::VertexCollection const & vertices,
+			   MVACollection & mvas, int) -> decltype(m(tracks,beamSpot,vertices,mvas)) {
+      return m(tracks,beamSpot,vertices,mvas);
+    }
+
+    template<typename M>
+    static void computeAll(M const & m,
+			   reco::TrackCollection const & tracks,
+			   reco::BeamSpot const & beamSpot,
+			   reco::VertexCollection const & vertices,
+			   MVACollection & mvas, long) {
       size_t current = 0;
       for (auto const & trk : tracks) {
-	mvas[current++]= mva(trk,beamSpot,vertices);
+	mvas[current++]= m(trk,beamSpot,vertices);
       }
     }
 
@@ -3,10 +3,12 @@
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "CondFormats/DataRecord/interface/GBRWrapperRcd.h"
+#include "CondFormats/EgammaObjects/interface/GBRForestEvaluator.h"
 
 #include "DataFormats/TrackReco/interface/Track.h"
 #include "DataFormats/VertexReco/interface/Vertex.h"
 #include <limits>
+#include <algorithm>
 
 #include "getBestVertex.h"
 
@@ -35,12 +37,44 @@ struct mva {
       edm::ESHandle<GBRForest> forestHandle;
       es.get<GBRWrapperRcd>().get(forestLabel_,forestHandle);
       forest_ = forestHandle.product();
+      // new IOV: the evaluator has to be built again
+      auto cacheId = es.get<GBRWrapperRcd>().cacheIdentifier();
+      if (cacheId!=forestCacheId_) {
+        evaluator_.reset();
+        forestCacheId_ = cacheId;
+      }
     }
+    if (!evaluator_) evaluator_ = std::make_unique<GBRForestEvaluator>(*forest_);
   }
 
+  static constexpr unsigned int nVars = PROMPT ? 16 : 12;
+
   float operator()(reco::Track const & trk,
 		   reco::BeamSpot const & beamSpot,
 		   reco::VertexCollection const & vertices) const {
+    float gbrVals_[nVars];
+    fillVariables(trk,beamSpot,vertices,gbrVals_);
+    return forest_->GetClassifier(gbrVals_);
+  }
+
+  // all the tracks at once: the variables of all tracks are computed first, then the forest
+  // is evaluated by blocks of tracks going down the same tree together
+  void operator()(reco::TrackCollection const & tracks,
+		  reco::BeamSpot const & beamSpot,
+		  reco::VertexCollection const & vertices,
+		  std::vector<float> & mvas) const {
+    std::vector<float> gbrVals(nVars*tracks.size());
+    for (unsigned int i=0; i<tracks.size(); ++i)
+      fillVariables(tracks[i],beamSpot,vertices,&gbrVals[nVars*i]);
+    std::vector<double> responses(tracks.size());
+    evaluator_->GetGradBoostClassifier(gbrVals.data(),nVars,tracks.size(),responses.data());
+    std::copy(responses.begin(),responses.end(),mvas.begin());
+  }
+
+  void fillVariables(reco::Track const & trk,
+		     reco::BeamSpot const & beamSpot,
+		     reco::VertexCollection const & vertices,
+		     float * gbrVals_) const {
 
     auto tmva_pt_ = trk.pt();
     auto tmva_ndof_ = trk.ndof();
@@ -72,7 +106,6 @@ struct mva {
     auto tmva_minlost_ = std::min(lostIn,lostOut);
     auto tmva_lostmidfrac_ = static_cast<float>(trk.numberOfLostHits()) / static_cast<float>(trk.numberOfValidHits() + trk.numberOfLostHits());
    
-    float gbrVals_[PROMPT ? 16 : 12];
     gbrVals_[0] = tmva_pt_;
     gbrVals_[1] = tmva_lostmidfrac_;
     gbrVals_[2] = tmva_minlost_;
@@ -98,11 +131,6 @@ struct mva {
       gbrVals_[14] = tmva_absdz_;
       gbrVals_[15] = tmva_absd0_;
     }
-
- 
-
-    return forest_->GetClassifier(gbrVals_);
-    
   }
 
   static const char * name();
@@ -114,6 +142,8 @@ struct mva {
   
   std::unique_ptr<GBRForest> forestFromFile_;
   const GBRForest *forest_ = nullptr; // owned by somebody else
+  std::unique_ptr<GBRForestEvaluator> evaluator_;
+  unsigned long long forestCacheId_ = 0;
   const std::string forestLabel_;
   const std::string dbFileName_;
   const bool useForestFromDB_;
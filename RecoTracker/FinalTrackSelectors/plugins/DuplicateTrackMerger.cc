@@ -25,14 +25,19 @@
 #include "TrackMerger.h"
 
 #include "CommonTools/Utils/interface/DynArray.h"
+#include "RecoTracker/FinalTrackSelectors/src/duplicateTrackPairs.h"
 #include <vector>
 #include <algorithm>
+#include <numeric>
+#include <cmath>
 #include <string>
 #include <iostream>
 #include <atomic>
+#include <memory>
 
 
 #include "CondFormats/EgammaObjects/interface/GBRForest.h"
+#include "CondFormats/EgammaObjects/interface/GBRForestEvaluator.h"
 
 using namespace reco;
 namespace {
@@ -52,12 +57,15 @@ namespace {
       /// produce one event
       void produce( edm::Event &, const edm::EventSetup &) override;
       
-      bool checkForDisjointTracks(const reco::Track *t1, const reco::Track *t2, TSCPBuilderNoMaterial& tscpBuilder) const;
+      /// cuts on the pair, filling the nMvaVars inputs of the MVA, evaluated later for all the pairs at once
+      bool checkForDisjointTracks(const reco::Track *t1, const reco::Track *t2, TSCPBuilderNoMaterial& tscpBuilder, float *gbrVals) const;
       bool checkForOverlappingTracks(const reco::Track *t1, const reco::Track *t2, unsigned int nvh1, unsigned int nvh2, double cosT) const;
 
     private:
       /// MVA discriminator
       const GBRForest* forest_;
+      std::unique_ptr<GBRForestEvaluator> evaluator_;
+      static constexpr unsigned int nMvaVars = 9;
       
            
       /// MVA weights file
@@ -96,6 +104,8 @@ namespace {
       unsigned int overlapCheckMaxMissingLayers_;
       /// min cosT for the overlap check
       double overlapCheckMinCosT_;
+      /// only check pairs of tracks with compatible directions, found through bins in phi
+      bool binnedPairSearch_;
 
       const MagneticField *magfield_;
       const TrackerTopology *ttopo_;
@@ -148,6 +158,7 @@ DuplicateTrackMerger::fillDescriptions(edm::ConfigurationDescriptions& descripti
      desc.add<unsigned>("overlapCheckMaxHits", 4);
      desc.add<unsigned>("overlapCheckMaxMissingLayers", 1);
      desc.add<double>("overlapCheckMinCosT", 0.99);
+     desc.add<bool>("binnedPairSearch", false)->setComment("check only the pairs of tracks whose ranges of phi and lambda, along the track and widened by the cuts, intersect, found through bins in phi, instead of all the pairs");
      desc.add<std::string>("forestLabel","MVADuplicate");
      desc.add<std::string>("GBRForestFileName","");
      desc.add<bool>("useInnermostState",true);
@@ -175,6 +186,7 @@ DuplicateTrackMerger::DuplicateTrackMerger(const edm::ParameterSet& iPara) : for
   overlapCheckMaxHits_ = iPara.getParameter<unsigned>("overlapCheckMaxHits");
   overlapCheckMaxMissingLayers_ = iPara.getParameter<unsigned>("overlapCheckMaxMissingLayers");
   overlapCheckMinCosT_ = iPara.getParameter<double>("overlapCheckMinCosT");
+  binnedPairSearch_ = iPara.getParameter<bool>("binnedPairSearch");
 
   produces<std::vector<TrackCandidate> >("candidates");
   produces<CandidateToDuplicate>("candidateMap");
@@ -257,6 +269,7 @@ void DuplicateTrackMerger::produce(edm::Event& iEvent, const edm::EventSetup& iS
       TFile gbrfile(dbFileName_.c_str());
       forest_ = dynamic_cast<const GBRForest*>(gbrfile.Get(forestLabel_.c_str()));
     }
+    evaluator_ = std::make_unique<GBRForestEvaluator>(*forest_);
   }
 
   //edm::Handle<edm::View<reco::Track> >handle;
@@ -332,65 +345,131 @@ void DuplicateTrackMerger::produce(edm::Event& iEvent, const edm::EventSetup& iS
   }
 
 
-  for(int i = 0; i <nTracks; i++){
+  // pairs passing the cuts, in the order of the search; the disjoint ones wait for the MVA
+  struct Candidate {
+    int i, j;
+    const reco::Track *t1, *t2;
+    DuplicateTrackType type;
+    int mva; // index of the MVA inputs, -1 if none
+  };
+  std::vector<Candidate> candidates;
+  std::vector<float> gbrVals;
+  float pairVals[nMvaVars];
+
+  auto checkPair = [&](int i, int j) {
     const reco::Track *rt1 = selTracks[i];
-    for(int j = i+1; j < nTracks;j++){
-      const reco::Track *rt2 = selTracks[j];
+    const reco::Track *rt2 = selTracks[j];
 
 #ifdef EDM_ML_DEBUG
-      debug_ = false;
-      if(test(rt1, rt2) || test(rt2, rt1)) {
-        debug_ = true;
-        LogTrace("DuplicateTrackMerger") << "Track1 " << i << " originalAlgo " << rt1->originalAlgo() << " seed " << rt1->seedRef().key() << " pT " << std::sqrt(rt1->innerMomentum().perp2()) << " charge " << rt1->charge() << " outerPosition2 " << rt1->outerPosition().perp2() << "\n"
-                                         << "Track2 " << j << " originalAlgo " << rt2->originalAlgo() << " seed " << rt2->seedRef().key() << " pT " << std::sqrt(rt2->innerMomentum().perp2()) << " charge " << rt2->charge() << " outerPosition2 " << rt2->outerPosition().perp2();
-      }
+    debug_ = false;
+    if(test(rt1, rt2) || test(rt2, rt1)) {
+      debug_ = true;
+      LogTrace("DuplicateTrackMerger") << "Track1 " << i << " originalAlgo " << rt1->originalAlgo() << " seed " << rt1->seedRef().key() << " pT " << std::sqrt(rt1->innerMomentum().perp2()) << " charge " << rt1->charge() << " outerPosition2 " << rt1->outerPosition().perp2() << "\n"
+                                       << "Track2 " << j << " originalAlgo " << rt2->originalAlgo() << " seed " << rt2->seedRef().key() << " pT " << std::sqrt(rt2->innerMomentum().perp2()) << " charge " << rt2->charge() << " outerPosition2 " << rt2->outerPosition().perp2();
+    }
 #endif
 
-      if(rt1->charge() != rt2->charge())continue;
-      auto cosT = (*rt1).momentum().Dot((*rt2).momentum()); // not normalized!
-      IfLogTrace(debug_, "DuplicateTrackMerger") << " cosT " << cosT;
-      if (cosT<0.) continue;
-      cosT /= std::sqrt((*rt1).momentum().Mag2()*(*rt2).momentum().Mag2());
+    if(rt1->charge() != rt2->charge()) return;
+    auto cosT = (*rt1).momentum().Dot((*rt2).momentum()); // not normalized!
+    IfLogTrace(debug_, "DuplicateTrackMerger") << " cosT " << cosT;
+    if (cosT<0.) return;
+    cosT /= std::sqrt((*rt1).momentum().Mag2()*(*rt2).momentum().Mag2());
 
-      const reco::Track* t1,*t2; unsigned int nhv1, nhv2;
-      if(rt1->outerPosition().perp2() < rt2->outerPosition().perp2()){
+    const reco::Track* t1,*t2; unsigned int nhv1, nhv2;
+    if(rt1->outerPosition().perp2() < rt2->outerPosition().perp2()){
 	t1 = rt1; nhv1 = nValidHits[i];
 	t2 = rt2; nhv2 = nValidHits[j];
-      }else{
+    }else{
 	t1 = rt2; nhv1 = nValidHits[j];
 	t2 = rt1; nhv2 = nValidHits[i];
-      }
-      auto deltaR3d2 = (t1->outerPosition() - t2->innerPosition()).mag2();
+    }
+    auto deltaR3d2 = (t1->outerPosition() - t2->innerPosition()).mag2();
 
-      if(t1->outerPosition().perp2() > t2->innerPosition().perp2()) deltaR3d2 *= -1.0;
-      IfLogTrace(debug_, "DuplicateTrackMerger") << " deltaR3d2 " << deltaR3d2 << " t1.outerPos2 " << t1->outerPosition().perp2() << " t2.innerPos2 " << t2->innerPosition().perp2();
+    if(t1->outerPosition().perp2() > t2->innerPosition().perp2()) deltaR3d2 *= -1.0;
+    IfLogTrace(debug_, "DuplicateTrackMerger") << " deltaR3d2 " << deltaR3d2 << " t1.outerPos2 " << t1->outerPosition().perp2() << " t2.innerPos2 " << t2->innerPosition().perp2();
 
-      bool compatible = false;
-      DuplicateTrackType duplType;
-      if(deltaR3d2 >= minDeltaR3d2_) {
-        compatible = checkForDisjointTracks(t1, t2, tscpBuilder);
-        duplType = DuplicateTrackType::Disjoint;
-      }
-      else {
-        compatible = checkForOverlappingTracks(t1, t2, nhv1, nhv2, cosT);
-        duplType = DuplicateTrackType::Overlapping;
-      }
-      if(!compatible) continue;
-      
-      
-      IfLogTrace(debug_, "DuplicateTrackMerger") << " marking as duplicates" << oriIndex[i]<<','<<oriIndex[j];
-      out_duplicateCandidates->push_back(merger_.merge(*t1,*t2, duplType));
-      out_candidateMap->emplace_back(oriIndex[i],oriIndex[j]);
+    if(deltaR3d2 >= minDeltaR3d2_) {
+      if(!checkForDisjointTracks(t1, t2, tscpBuilder, pairVals)) return;
+      candidates.push_back(Candidate{i, j, t1, t2, DuplicateTrackType::Disjoint, int(gbrVals.size()/nMvaVars)});
+      gbrVals.insert(gbrVals.end(), pairVals, pairVals+nMvaVars);
+    }
+    else {
+      if(!checkForOverlappingTracks(t1, t2, nhv1, nhv2, cosT)) return;
+      candidates.push_back(Candidate{i, j, t1, t2, DuplicateTrackType::Overlapping, -1});
+    }
 
 #ifdef VI_STAT
-      ++stat.nCand;
-      //    auto cosT = float((*t1).momentum().unit().Dot((*t2).momentum().unit()));
-      if (cosT>0) update_minimum(stat.maxCos,float(cosT));
-      else   ++stat.nLoop0;
+    ++stat.nCand;
+    //    auto cosT = float((*t1).momentum().unit().Dot((*t2).momentum().unit()));
+    if (cosT>0) update_minimum(stat.maxCos,float(cosT));
+    else   ++stat.nLoop0;
 #endif
-      
+  };
+
+  if(binnedPairSearch_) {
+    // The phi and lambda of a track wherever the merger may compare it: the disjoint tracks
+    // are compared between their outermost and innermost hits, the overlapping ones from the
+    // directions at their reference points, within acos(overlapCheckMinCosT).
+    // In phi, the momentum turns by at most 2*asin(chord/(2*radius)) from the reference point,
+    // with the chord bound by the farthest hit of the track itself and the radius of curvature
+    // by the lowest pT of the track; lambda only changes through the material, between the
+    // inner and outer states. The margins cover the field not being uniform.
+    // The disjoint tracks meet halfway between them, beyond the hits of each: there the bound
+    // relies on the margins, so this is a preselection, looser than the full loop.
+    constexpr float phiMargin = 0.02f, turnScale = 1.1f, lambdaMargin = 0.02f;
+    // pT in GeV of the tracks with a radius of curvature of 1 cm
+    const float ptPerCm = 0.0029979f*std::abs(magfield_->inTesla(GlobalPoint(0,0,0)).z());
+    const float overlapAngle = std::acos(std::max(-1.f, std::min(1.f, float(overlapCheckMinCosT_))));
+    const float sinHalfOverlap = std::sin(0.5f*overlapAngle);
+
+    declareDynArray(duplicateTrackPairs::Range, nTracks, ranges);
+    for(int i = 0; i < nTracks; i++){
+      const reco::Track *rt1 = selTracks[i];
+      auto const & pIn = rt1->innerMomentum();
+      auto const & pOut = rt1->outerMomentum();
+      float pt = std::sqrt(std::min({float(rt1->momentum().perp2()), float(pIn.perp2()), float(pOut.perp2())}));
+      float radius = std::sqrt(std::max(float(rt1->outerPosition().perp2()), float(rt1->innerPosition().perp2())));
+      float halfChord = 0.5f*(radius + float(rt1->referencePoint().rho()))*ptPerCm;
+      float turn = halfChord < pt ? 2.f*std::asin(halfChord/pt) : float(M_PI);
+      float cosLambda = std::cos(float(rt1->lambda()));
+      float overlapTurn = sinHalfOverlap < cosLambda ? 2.f*std::asin(sinHalfOverlap/cosLambda) : float(M_PI);
+      auto & r = ranges[i];
+      r.phi = rt1->phi();
+      r.phiHalfWidth = std::max(turnScale*turn, overlapTurn) + 0.5f*maxDPhi_ + phiMargin;
+      float lambdaIn = std::atan2(float(pIn.z()), float(pIn.rho()));
+      float lambdaOut = std::atan2(float(pOut.z()), float(pOut.rho()));
+      float halfWidth = std::max(0.5f*maxDLambda_, 0.5f*overlapAngle) + lambdaMargin;
+      r.lambdaMin = std::min({float(rt1->lambda()), lambdaIn, lambdaOut}) - halfWidth;
+      r.lambdaMax = std::max({float(rt1->lambda()), lambdaIn, lambdaOut}) + halfWidth;
+    }
+
+    std::vector<std::pair<int, int>> pairs;
+    duplicateTrackPairs::compatiblePairs(ranges.begin(), nTracks, maxDPhi_ > 0.f ? int(2.f*float(M_PI)/maxDPhi_) : 1, pairs);
+    LogDebug("DuplicateTrackMerger") << "Number of track pairs to be checked: " << pairs.size();
+    for(auto const & p : pairs) checkPair(p.first, p.second);
+  }
+  else {
+    for(int i = 0; i <nTracks; i++){
+      for(int j = i+1; j < nTracks;j++){
+        checkPair(i, j);
+      }
     }
   }
+
+  // the MVA of all the disjoint pairs at once
+  std::vector<double> mvaBDTG(gbrVals.size()/nMvaVars);
+  if(!mvaBDTG.empty()) evaluator_->GetGradBoostClassifier(gbrVals.data(), nMvaVars, mvaBDTG.size(), mvaBDTG.data());
+
+  for(auto const & c : candidates) {
+    if(c.mva >= 0) {
+      LogTrace("DuplicateTrackMerger") << " tracks " << oriIndex[c.i] << ',' << oriIndex[c.j] << " mvaBDTG " << mvaBDTG[c.mva];
+      if(mvaBDTG[c.mva] < minBDTG_) continue;
+    }
+    LogTrace("DuplicateTrackMerger") << " marking as duplicates" << oriIndex[c.i] << ',' << oriIndex[c.j];
+    out_duplicateCandidates->push_back(merger_.merge(*c.t1, *c.t2, c.type));
+    out_candidateMap->emplace_back(oriIndex[c.i], oriIndex[c.j]);
+  }
+
   iEvent.put(std::move(out_duplicateCandidates),"candidates");
   iEvent.put(std::move(out_candidateMap),"candidateMap");
 
@@ -398,7 +477,7 @@ void DuplicateTrackMerger::produce(edm::Event& iEvent, const edm::EventSetup& iS
 }
 
 
-  bool DuplicateTrackMerger::checkForDisjointTracks(const reco::Track *t1, const reco::Track *t2, TSCPBuilderNoMaterial& tscpBuilder) const {
+  bool DuplicateTrackMerger::checkForDisjointTracks(const reco::Track *t1, const reco::Track *t2, TSCPBuilderNoMaterial& tscpBuilder, float *gbrVals_) const {
     IfLogTrace(debug_, "DuplicateTrackMerger") << " Checking for disjoint duplicates";
 
     FreeTrajectoryState fts1 = trajectoryStateTransform::outerFreeState(*t1, &*magfield_,false);
@@ -459,7 +538,6 @@ void DuplicateTrackMerger::produce(edm::Event& iEvent, const edm::EventSetup& iS
     float tmva_outer_nMissingInner_ = t2->hitPattern().numberOfLostHits(reco::HitPattern::MISSING_INNER_HITS);
     float tmva_inner_nMissingOuter_ = t1->hitPattern().numberOfLostHits(reco::HitPattern::MISSING_OUTER_HITS);
 
-    float gbrVals_[9];
     gbrVals_[0] = tmva_ddsz_;
     gbrVals_[1] = tmva_ddxy_;
     gbrVals_[2] = tmva_dphi_;
@@ -470,11 +548,6 @@ void DuplicateTrackMerger::produce(edm::Event& iEvent, const edm::EventSetup& iS
     gbrVals_[7] = tmva_outer_nMissingInner_;
     gbrVals_[8] = tmva_inner_nMissingOuter_;
 
-    auto mvaBDTG = forest_->GetClassifier(gbrVals_);
-    IfLogTrace(debug_, "DuplicateTrackMerger") << " mvaBDTG " << mvaBDTG;
-    if(mvaBDTG < minBDTG_) return false;
-
-    //  std::cout << "to merge " << mvaBDTG << ' ' << std::copysign(std::sqrt(std::abs(deltaR3d2)),deltaR3d2) << ' ' << tmva_dphi_ << ' ' << TSCP1.pt() <<'/'<<TSCP2.pt() << std::endl;
     return true;
   }
 
@@ -0,0 +1,106 @@
+#ifndef RecoTracker_FinalTrackSelectors_duplicateTrackPairs_h
+#define RecoTracker_FinalTrackSelectors_duplicateTrackPairs_h
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+/**
+ * Preselection of the pairs of tracks checked by the DuplicateTrackMerger.
+ * This header is internal to it, and exists in a separate file only to
+ * allow a unit test to be run.
+ *
+ * Each track gets an interval in phi and one in lambda, wide enough to
+ * hold the direction of the track at any point where the merger may
+ * compare it with another track, plus half of the merger cuts. Two tracks
+ * can be duplicates only if both their intervals intersect. The intervals
+ * are indexed by bins in phi, so that the pairs are found without looking
+ * at all of them; the result is the same as testing every pair.
+ */
+namespace duplicateTrackPairs {
+
+  struct Range {
+    float phi;           // centre of the phi interval
+    float phiHalfWidth;  // pi or more for any phi
+    float lambdaMin;
+    float lambdaMax;
+  };
+
+  inline bool compatible(Range const & a, Range const & b) {
+    if (a.lambdaMin > b.lambdaMax || b.lambdaMin > a.lambdaMax) return false;
+    float dphi = std::abs(a.phi - b.phi);
+    if (dphi > float(M_PI)) dphi = 2.f*float(M_PI) - dphi;
+    return dphi <= a.phiHalfWidth + b.phiHalfWidth;
+  }
+
+  /**
+   * Fills pairs with the pairs (i,j), i<j, of compatible ranges, in
+   * increasing order of i then j: the order of the nested loops.
+   */
+  inline void compatiblePairs(const Range * ranges, int n, int nPhiBins,
+                              std::vector<std::pair<int,int>> & pairs) {
+    pairs.clear();
+    nPhiBins = std::max(nPhiBins, 1);
+    const float binsPerRadian = float(nPhiBins)/(2.f*float(M_PI));
+
+    // first and last bin of each interval, with one more on each side against rounding;
+    // the intervals covering all the bins are kept apart
+    std::vector<int> first(n), last(n);
+    std::vector<int> anywhere;
+    std::vector<int> binBegin(nPhiBins+1, 0);
+    auto coversAll = [&](int i) { return last[i] - first[i] + 1 >= nPhiBins; };
+    auto wrap = [&](int b) { return (b%nPhiBins + nPhiBins)%nPhiBins; };
+    for (int i = 0; i < n; ++i) {
+      auto const & r = ranges[i];
+      if (!(r.phiHalfWidth < float(M_PI))) {
+        anywhere.push_back(i);
+        last[i] = nPhiBins;
+        continue;
+      }
+      first[i] = int(std::floor((r.phi - r.phiHalfWidth + float(M_PI))*binsPerRadian)) - 1;
+      last[i] = int(std::floor((r.phi + r.phiHalfWidth + float(M_PI))*binsPerRadian)) + 1;
+      if (coversAll(i)) {
+        anywhere.push_back(i);
+        continue;
+      }
+      for (int b = first[i]; b <= last[i]; ++b) ++binBegin[wrap(b) + 1];
+    }
+    std::partial_sum(binBegin.begin(), binBegin.end(), binBegin.begin());
+    std::vector<int> byBin(binBegin[nPhiBins]);
+    {
+      auto next = binBegin;
+      for (int i = 0; i < n; ++i) {
+        if (coversAll(i)) continue;
+        for (int b = first[i]; b <= last[i]; ++b) byBin[next[wrap(b)]++] = i;
+      }
+    }
+
+    // two intersecting intervals share at least one bin
+    for (int i = 0; i < n; ++i) {
+      if (coversAll(i)) continue;
+      for (int b = first[i]; b <= last[i]; ++b) {
+        auto ib = wrap(b);
+        for (auto k = binBegin[ib]; k < binBegin[ib+1]; ++k) {
+          auto j = byBin[k];
+          if (j > i && compatible(ranges[i], ranges[j])) pairs.emplace_back(i, j);
+        }
+      }
+    }
+    for (auto i : anywhere) {
+      for (int j = 0; j < n; ++j) {
+        if (j == i) continue;
+        // pairs of two such intervals only once
+        if (j < i && coversAll(j)) continue;
+        if (compatible(ranges[i], ranges[j])) pairs.emplace_back(std::min(i, j), std::max(i, j));
+      }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+  }
+
+}
+
+#endif
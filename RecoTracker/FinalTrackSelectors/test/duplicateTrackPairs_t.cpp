@@ -0,0 +1,49 @@
+#include "RecoTracker/FinalTrackSelectors/src/duplicateTrackPairs.h"
+
+#include <iostream>
+#include <random>
+
+// the binned search must find exactly the pairs found by testing all of them
+int main(void) {
+  using duplicateTrackPairs::Range;
+
+  std::mt19937 eng(42);
+  std::uniform_real_distribution<float> phi(-float(M_PI), float(M_PI));
+  std::uniform_real_distribution<float> lambda(-1.4f, 1.4f);
+  std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+  int nPairs = 0;
+  for(int iter = 0; iter < 200; ++iter) {
+    const int n = iter%10 == 0 ? iter/10 : 1 + int(500*unit(eng));
+    std::vector<Range> ranges(n);
+    for(auto & r : ranges) {
+      r.phi = phi(eng);
+      // mostly narrow intervals, some wide ones and some covering any phi
+      auto u = unit(eng);
+      r.phiHalfWidth = u < 0.8f ? 0.2f*unit(eng) : (u < 0.95f ? 2.f*unit(eng) : 3.5f + unit(eng));
+      if(u < 0.02f) r.phi = std::copysign(float(M_PI), r.phi);
+      auto l = lambda(eng);
+      r.lambdaMin = l - 0.2f*unit(eng);
+      r.lambdaMax = l + 0.2f*unit(eng);
+    }
+
+    std::vector<std::pair<int,int>> expected;
+    for(int i = 0; i < n; ++i)
+      for(int j = i+1; j < n; ++j)
+        if(duplicateTrackPairs::compatible(ranges[i], ranges[j])) expected.emplace_back(i, j);
+
+    for(int nPhiBins : {0, 1, 2, 3, 20, 64, 1000}) {
+      std::vector<std::pair<int,int>> pairs;
+      duplicateTrackPairs::compatiblePairs(ranges.data(), n, nPhiBins, pairs);
+      if(pairs != expected) {
+        std::cout << "iteration " << iter << " with " << n << " tracks and " << nPhiBins << " phi bins: "
+                  << pairs.size() << " pairs, " << expected.size() << " expected" << std::endl;
+        return 1;
+      }
+    }
+    nPairs += expected.size();
+  }
+  std::cout << "binned search equal to the full search for " << nPairs << " pairs" << std::endl;
+
+  return 0;
+}
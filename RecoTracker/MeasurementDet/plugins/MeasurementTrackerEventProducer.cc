@@ -16,7 +16,8 @@
 
 MeasurementTrackerEventProducer::MeasurementTrackerEventProducer(const edm::ParameterSet &iConfig) :
     measurementTrackerLabel_(iConfig.getParameter<std::string>("measurementTracker")),
-    switchOffPixelsIfEmpty_(iConfig.getParameter<bool>("switchOffPixelsIfEmpty"))
+    switchOffPixelsIfEmpty_(iConfig.getParameter<bool>("switchOffPixelsIfEmpty")),
+    onDemandDetSets_(iConfig.getParameter<bool>("onDemandDetSets"))
 {
     std::vector<edm::InputTag> inactivePixelDetectorTags(iConfig.getParameter<std::vector<edm::InputTag> >("inactivePixelDetectorLabels"));
     for (auto &t : inactivePixelDetectorTags) theInactivePixelDetectorLabels.push_back(consumes<DetIdCollection>(t));
@@ -68,6 +69,7 @@ void MeasurementTrackerEventProducer::fillDescriptions(edm::ConfigurationDescrip
   desc.add<std::vector<edm::InputTag>>("inactiveStripDetectorLabels", std::vector<edm::InputTag>{{edm::InputTag("siStripDigis")}})->setComment("One or more DetIdCollections of modules to mask on the fly for a given event");
 
   desc.add<bool>("switchOffPixelsIfEmpty", true)->setComment("let's keep it like this, for cosmics");
+  desc.add<bool>("onDemandDetSets", false)->setComment("fill the clusters of each module on its first access instead of for the whole tracker (for regional tracking)");
 
   descriptions.add("measurementTrackerEventDefault",desc);
 }
@@ -80,8 +82,8 @@ MeasurementTrackerEventProducer::produce(edm::Event &iEvent, const edm::EventSet
     iSetup.get<CkfComponentsRecord>().get(measurementTrackerLabel_, measurementTracker);
 
     // create new data structures from templates
-    auto stripData = std::make_unique<StMeasurementDetSet>(measurementTracker->stripDetConditions());
-    auto pixelData=  std::make_unique<PxMeasurementDetSet>(measurementTracker->pixelDetConditions());
+    auto stripData = std::make_unique<StMeasurementDetSet>(measurementTracker->stripDetConditions(), onDemandDetSets_);
+    auto pixelData=  std::make_unique<PxMeasurementDetSet>(measurementTracker->pixelDetConditions(), onDemandDetSets_);
     auto phase2OTData = std::make_unique<Phase2OTMeasurementDetSet>(measurementTracker->phase2DetConditions());
     std::vector<bool> stripClustersToSkip;
     std::vector<bool> pixelClustersToSkip;
@@ -105,8 +107,8 @@ void
 MeasurementTrackerEventProducer::updatePixels( const edm::Event& event, PxMeasurementDetSet & thePxDets, std::vector<bool> & pixelClustersToSkip, 
 					       const TrackerGeometry& trackerGeom, const edm::EventSetup& iSetup) const
 {
-  // start by clearinng everything
-  thePxDets.setEmpty();
+  // start by clearinng everything (already empty if filled on demand)
+  if (!thePxDets.onDemand()) thePxDets.setEmpty();
 
   std::vector<uint32_t> rawInactiveDetIds; 
   if (!theInactivePixelDetectorLabels.empty()) {
@@ -216,6 +218,9 @@ MeasurementTrackerEventProducer::updatePixels( const edm::Event& event, PxMeasur
 	}
 	
 	
+	// filled from the handle on the first access to each module
+	if (thePxDets.onDemand()) return;
+
 	// FIXME: should check if lower_bound is better
 	int i = 0, endDet = thePxDets.size();
 	for (edmNew::DetSetVector<SiPixelCluster>::const_iterator it = pixelCollection->begin(), ed = pixelCollection->end(); it != ed; ++it) {
@@ -248,8 +253,8 @@ MeasurementTrackerEventProducer::updateStrips( const edm::Event& event, StMeasur
   getInactiveStrips(event,rawInactiveDetIds);
 
   // Strip Clusters
-  //first clear all of them
-  theStDets.setEmpty();
+  //first clear all of them (already empty if filled on demand)
+  if (!theStDets.onDemand()) theStDets.setEmpty();
 
 
   if( theStripClusterLabel.isUninitialized() )  return;  //clusters have not been produced
@@ -288,6 +293,8 @@ MeasurementTrackerEventProducer::updateStrips( const edm::Event& event, StMeasur
       }
     
       theStDets.handle() = clusterHandle;
+      // filled from the handle on the first access to each module
+      if (theStDets.onDemand()) return;
       int i=0;
       // cluster and det and in order (both) and unique so let's use set intersection
       for ( auto j = 0U; j< (*clusterCollection).size(); ++j) {
@@ -46,6 +46,7 @@ protected:
 
       bool selfUpdateSkipClusters_;
       bool switchOffPixelsIfEmpty_;
+      bool onDemandDetSets_;
       bool isPhase2;
 };
 
@@ -0,0 +1,80 @@
+#ifndef RecoTracker_MeasurementDet_OnDemandDetSets_h
+#define RecoTracker_MeasurementDet_OnDemandDetSets_h
+
+#include <atomic>
+#include <memory>
+
+/* Event detsets of the modules filled on their first access ("on-demand" mode,
+ * for regional reconstruction that touches few modules).
+ * The detsets are kept in chunks of modules allocated on first access, so that
+ * nothing proportional to the number of modules is allocated or reset per event.
+ * Concurrent first accesses to the same module both fill it and the first to
+ * publish its result wins: no one waits, filling must not throw and must give
+ * the same result in every thread.
+ */
+template<typename DetSet>
+class OnDemandDetSets {
+public:
+  static constexpr int chunkSize = 64;
+
+  OnDemandDetSets() {}
+  OnDemandDetSets(const OnDemandDetSets &) = delete;
+  OnDemandDetSets & operator=(const OnDemandDetSets &) = delete;
+  ~OnDemandDetSets() { clear(); }
+
+  void init(int size) {
+    clear();
+    nChunks_ = (size+chunkSize-1)/chunkSize;
+    chunks_.reset(new std::atomic<Chunk*>[nChunks_]());
+  }
+  bool enabled() const { return bool(chunks_); }
+
+  /// the detset of module i, filled with fill() (returning a null pointer if empty) unless already done
+  template<typename F>
+  const DetSet & get(int i, F && fill) const {
+    auto & slot = chunk(i/chunkSize).detSets[i%chunkSize];
+    const DetSet * detSet = slot.load(std::memory_order_acquire);
+    if (detSet) return *detSet;
+    std::unique_ptr<const DetSet> filled(fill());
+    const DetSet * mine = filled ? filled.get() : &empty_;
+    if (!slot.compare_exchange_strong(detSet,mine,std::memory_order_acq_rel)) return *detSet;
+    filled.release();
+    return *mine;
+  }
+  bool isEmpty(const DetSet & detSet) const { return &detSet==&empty_; }
+
+private:
+  struct Chunk {
+    std::atomic<const DetSet*> detSets[chunkSize];
+  };
+
+  Chunk & chunk(int k) const {
+    auto & pointer = chunks_[k];
+    Chunk * c = pointer.load(std::memory_order_acquire);
+    if (c) return *c;
+    Chunk * mine = new Chunk();
+    if (pointer.compare_exchange_strong(c,mine,std::memory_order_acq_rel)) return *mine;
+    delete mine;
+    return *c;
+  }
+
+  void clear() {
+    for (int k=0; k<nChunks_; ++k) {
+      Chunk * c = chunks_[k].load(std::memory_order_acquire);
+      if (!c) continue;
+      for (auto & slot : c->detSets) {
+        auto detSet = slot.load(std::memory_order_relaxed);
+        if (detSet!=&empty_) delete detSet;
+      }
+      delete c;
+    }
+    chunks_.reset();
+    nChunks_ = 0;
+  }
+
+  std::unique_ptr<std::atomic<Chunk*>[]> chunks_;
+  int nChunks_ = 0;
+  const DetSet empty_{};
+};
+
+#endif
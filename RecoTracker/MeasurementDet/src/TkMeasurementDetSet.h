@@ -22,6 +22,8 @@ class Phase2StripCPE;
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
+#include "RecoTracker/MeasurementDet/src/OnDemandDetSets.h"
+
 #include <unordered_map>
 
 // #define VISTAT
@@ -150,18 +152,20 @@ public:
   typedef StripDetset::const_iterator new_const_iterator;
   
 
-  StMeasurementDetSet(const StMeasurementConditionSet & cond) : 
+  /// with onDemand, the detsets are filled from handle() on the first access to each module instead of with 'update'
+  StMeasurementDetSet(const StMeasurementConditionSet & cond, bool onDemand=false) : 
     conditionSet_(&cond),
     empty_(cond.nDet(), true),
     activeThisEvent_(cond.nDet(), true),
-    detSet_(cond.nDet()),
-    detIndex_(cond.nDet(),-1),
-    ready_(cond.nDet(),true),
+    detSet_(onDemand ? 0 : cond.nDet()),
+    detIndex_(onDemand ? 0 : cond.nDet(),-1),
+    ready_(onDemand ? 0 : cond.nDet(),true),
     theRawInactiveStripDetIds_(),
     stripDefined_(0), 
     stripUpdated_(0), 
     stripRegions_(0) 
   {
+    if (onDemand) onDemand_.init(cond.nDet());
   }
 
   ~StMeasurementDetSet() {
@@ -190,7 +194,7 @@ public:
     return conditions().find(jd,i);
   }
   
-  bool empty(int i) const { return empty_[i];}  
+  bool empty(int i) const { return onDemand_.enabled() ? onDemand_.isEmpty(fillOnDemand(i)) : empty_[i];}  
   bool isActive(int i) const { return activeThisEvent_[i] && conditions().isActiveThisPeriod(i); }
 
   void setEmpty(int i) {empty_[i] = true; activeThisEvent_[i] = true; }
@@ -212,7 +216,12 @@ public:
   edm::Handle<edmNew::DetSetVector<SiStripCluster> > & handle() {  return handle_; }
   const edm::Handle<edmNew::DetSetVector<SiStripCluster> > & handle() const {  return handle_; }
   // StripDetset & detSet(int i) { return detSet_[i]; }
-  const StripDetset & detSet(int i) const { if (ready_[i]) const_cast<StMeasurementDetSet*>(this)->getDetSet(i);     return detSet_[i]; }
+  const StripDetset & detSet(int i) const {
+    if (onDemand_.enabled()) return fillOnDemand(i);
+    if (ready_[i]) const_cast<StMeasurementDetSet*>(this)->getDetSet(i);
+    return detSet_[i];
+  }
+  bool onDemand() const { return onDemand_.enabled(); }
   
 
   //// ------- pieces for on-demand unpacking -------- 
@@ -230,6 +239,15 @@ public:
 
 private:
 
+  const StripDetset & fillOnDemand(int i) const {
+    return onDemand_.get(i, [&]() -> StripDetset* {
+        if (!handle_.isValid() || !isActive(i)) return nullptr;
+        auto it = handle_->find(id(i));
+        if (it == handle_->end()) return nullptr;
+        return new StripDetset(*it);
+      });
+  }
+
   void getDetSet(int i) {
     if(detIndex_[i]>=0) {
       detSet_[i].set(*handle_,handle_->item(detIndex_[i]));
@@ -260,6 +278,7 @@ private:
   std::vector<StripDetset> detSet_;
   std::vector<int> detIndex_;
   std::vector<bool> ready_; // to be cleaned
+  OnDemandDetSets<StripDetset> onDemand_;
   
  
   // note: not aligned to the index
@@ -341,11 +360,14 @@ public:
   typedef edmNew::DetSet<SiPixelCluster> PixelDetSet;
   typedef std::vector<std::pair<LocalPoint,LocalPoint> > BadFEDChannelPositions;
 
-  PxMeasurementDetSet(const PxMeasurementConditionSet &cond) : 
+  /// with onDemand, the detsets are filled from handle() on the first access to each module instead of with 'update'
+  PxMeasurementDetSet(const PxMeasurementConditionSet &cond, bool onDemand=false) : 
     conditionSet_(&cond),
-    detSet_(cond.nDet()),
+    detSet_(onDemand ? 0 : cond.nDet()),
     empty_(cond.nDet(), true),
-    activeThisEvent_(cond.nDet(), true) {}
+    activeThisEvent_(cond.nDet(), true) {
+    if (onDemand) onDemand_.init(cond.nDet());
+  }
 
   const PxMeasurementConditionSet & conditions() const { return *conditionSet_; } 
 
@@ -361,7 +383,7 @@ public:
     empty_[i] = false;
   }
 
-  bool empty(int i) const { return empty_[i];}  
+  bool empty(int i) const { return onDemand_.enabled() ? onDemand_.isEmpty(fillOnDemand(i)) : empty_[i];}  
   bool isActive(int i) const { return activeThisEvent_[i] && conditions().isActiveThisPeriod(i); }
 
   void setEmpty(int i) {
@@ -403,10 +425,20 @@ public:
   void setActiveThisEvent(int i, bool active) { activeThisEvent_[i] = active;  if (!active) empty_[i] = true; }
   const edm::Handle<edmNew::DetSetVector<SiPixelCluster> > & handle() const {  return handle_;}
   edm::Handle<edmNew::DetSetVector<SiPixelCluster> > & handle() {  return handle_;}
-  const PixelDetSet & detSet(int i) const { return detSet_[i];}
+  const PixelDetSet & detSet(int i) const { return onDemand_.enabled() ? fillOnDemand(i) : detSet_[i];}
+  bool onDemand() const { return onDemand_.enabled(); }
 private:
   friend class MeasurementTrackerImpl;
 
+  const PixelDetSet & fillOnDemand(int i) const {
+    return onDemand_.get(i, [&]() -> PixelDetSet* {
+        if (!handle_.isValid() || !isActive(i)) return nullptr;
+        auto it = handle_->find(id(i));
+        if (it == handle_->end()) return nullptr;
+        return new PixelDetSet(*it);
+      });
+  }
+
   const PxMeasurementConditionSet *conditionSet_;
 
   // Globals, per-event
@@ -417,6 +449,7 @@ private:
   std::vector<bool> empty_;
   std::vector<bool> activeThisEvent_;
   std::unordered_map<int, BadFEDChannelPositions> badFEDChannelPositionsSet_;
+  OnDemandDetSets<PixelDetSet> onDemand_;
 };
 
 //FIXME:just temporary solution for phase2 OT that works!
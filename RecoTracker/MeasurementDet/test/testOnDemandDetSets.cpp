@@ -0,0 +1,69 @@
+// Concurrent first accesses to the on-demand detsets: every thread gets the same
+// detset of a module, empty modules are reported as such, untouched modules are
+// never filled, and a second event starts again from nothing.
+
+#include "RecoTracker/MeasurementDet/src/OnDemandDetSets.h"
+
+#include "tbb/parallel_for.h"
+#include "tbb/task_scheduler_init.h"
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+namespace {
+  struct DetSet {
+    int id = -1;
+  };
+}
+
+int main() {
+  tbb::task_scheduler_init init(8);
+
+  // modules not multiple of the chunk size, every third one empty, every fifth never accessed
+  constexpr int nDet = 1000;
+  auto isEmpty = [](int i) { return i%3==0; };
+  auto accessed = [](int i) { return i%5!=0; };
+
+  for (int event=0; event<3; ++event) {
+    OnDemandDetSets<DetSet> detSets;
+    assert(!detSets.enabled());
+    detSets.init(nDet);
+    assert(detSets.enabled());
+
+    std::vector<std::atomic<int> > nFills(nDet);
+    for (auto & n : nFills) n = 0;
+    std::vector<std::atomic<const DetSet*> > first(nDet);
+    for (auto & p : first) p = nullptr;
+
+    // many accesses to each module, from many threads, in an order mixing the modules
+    constexpr int nAccess = 64;
+    tbb::parallel_for(0, nDet*nAccess, [&](int k) {
+        int i = (k*7919)%nDet;
+        if (!accessed(i)) return;
+        auto const & detSet = detSets.get(i, [&]() -> DetSet* {
+            ++nFills[i];
+            if (isEmpty(i)) return nullptr;
+            auto detSet = new DetSet;
+            detSet->id = i;
+            return detSet;
+          });
+        assert(detSets.isEmpty(detSet)==isEmpty(i));
+        if (!isEmpty(i)) assert(detSet.id==i);
+        const DetSet * expected = nullptr;
+        if (!first[i].compare_exchange_strong(expected,&detSet)) assert(expected==&detSet);
+      });
+
+    for (int i=0; i<nDet; ++i) {
+      if (!accessed(i)) { assert(nFills[i]==0); continue; }
+      assert(nFills[i]>=1);
+      // filled: no further fill
+      auto const & detSet = detSets.get(i, []() -> DetSet* { assert(false); return nullptr; });
+      assert(&detSet==first[i].load());
+    }
+  }
+
+  std::cout << "OnDemandDetSets OK" << std::endl;
+  return 0;
+}
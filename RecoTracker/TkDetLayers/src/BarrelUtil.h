@@ -44,7 +44,7 @@ namespace barrelUtil {
   
   
   inline
-  bool overlap(float phi, const GeometricSearchDet& gsdet, float phiWin) {
+  bool overlap(float phi, std::pair<float,float> const & phiSpan, float phiWin) {
     // introduce offset (extrapolated point and true propagated point differ by 0.0003 - 0.00033, 
     // due to thickness of Rod of 1 cm) 
     constexpr float phiOffset = 0.00034;  //...TOBE CHECKED LATER...
@@ -53,7 +53,12 @@ namespace barrelUtil {
     // detector phi range
     std::pair<float,float> phiRange(phi-phiWin, phi+phiWin);
     
-    return rangesIntersect(phiRange, gsdet.surface().phiSpan(), PhiLess());
+    return rangesIntersect(phiRange, phiSpan, PhiLess());
+  } 
+
+  inline
+  bool overlap(float phi, const GeometricSearchDet& gsdet, float phiWin) {
+    return overlap(phi, gsdet.surface().phiSpan(), phiWin);
   } 
   
 
@@ -41,6 +41,9 @@ void TBPLayer::construct() {
   if (!theOuterComps.empty())
     theOuterBinFinder = BinFinderType(theOuterComps.front()->position().phi(),
 				      theOuterComps.size());
+
+  for (auto rod : theInnerComps) theInnerPhiSpans.push_back(rod->surface().phiSpan());
+  for (auto rod : theOuterComps) theOuterPhiSpans.push_back(rod->surface().phiSpan());
   
   BarrelDetLayer::initialize();
 
@@ -151,19 +154,20 @@ void TBPLayer::searchNeighbors( const TrajectoryStateOnSurface& tsos,
   }
 
   const BinFinderType& binFinder = (crossing.subLayerIndex()==0 ? theInnerBinFinder : theOuterBinFinder);
+  const auto & phiSpans = (crossing.subLayerIndex()==0 ? theInnerPhiSpans : theOuterPhiSpans);
 
   typedef CompatibleDetToGroupAdder Adder;
   int quarter = sLayer.size()/4;
   for (int idet=negStartIndex; idet >= negStartIndex - quarter; idet--) {
-    const GeometricSearchDet & neighborRod = *sLayer[binFinder.binIndex(idet)];
-    if (!overlap( gphi, neighborRod, window)) break;
-    if (!Adder::add( neighborRod, tsos, prop, est, result)) break;
+    auto ind = binFinder.binIndex(idet);
+    if (!overlap( gphi, phiSpans[ind], window)) break;
+    if (!Adder::add( *sLayer[ind], tsos, prop, est, result)) break;
     // maybe also add shallow crossing angle test here???
   }
   for (int idet=posStartIndex; idet < posStartIndex + quarter; idet++) {
-    const GeometricSearchDet & neighborRod = *sLayer[binFinder.binIndex(idet)];
-    if (!overlap( gphi, neighborRod, window)) break;
-    if (!Adder::add( neighborRod, tsos, prop, est, result)) break;
+    auto ind = binFinder.binIndex(idet);
+    if (!overlap( gphi, phiSpans[ind], window)) break;
+    if (!Adder::add( *sLayer[ind], tsos, prop, est, result)) break;
     // maybe also add shallow crossing angle test here???
   }
 }
@@ -68,6 +68,10 @@ class TBPLayer : public TBLayer {
   BinFinderType    theInnerBinFinder;
   BinFinderType    theOuterBinFinder;
 
+  // phi span of the rods, in the order of the sub-layers, to find the neighbours without touching them
+  std::vector<std::pair<float,float>> theInnerPhiSpans;
+  std::vector<std::pair<float,float>> theOuterPhiSpans;
+
   
     
 };
@@ -48,6 +48,14 @@ namespace {
 							 theZmin-zPos, theZmax-zPos));
   }
 
+  void fillPhiRanges(vector<const TECPetal*> const & petals, vector<pair<float,float>> & ranges) {
+    for (auto petal : petals) {
+      const BoundDiskSector &  diskSector = petal->specificSurface();
+      ranges.emplace_back(diskSector.phi() - diskSector.phiHalfExtension(),
+			  diskSector.phi() + diskSector.phiHalfExtension());
+    }
+  }
+
 }
 
 
@@ -84,6 +92,8 @@ TECLayer::TECLayer(vector<const TECPetal*>& innerPetals,
   				   theFrontComps.size());
   theBackBinFinder  = BinFinderPhi(theBackComps.front()->position().phi(),
 				   theBackComps.size());  
+  fillPhiRanges(theFrontComps, theFrontPhiRanges);
+  fillPhiRanges(theBackComps, theBackPhiRanges);
 
   //--------- DEBUG INFO --------------
   LogDebug("TkDetLayers") << "DEBUG INFO for TECLayer" << "\n"
@@ -243,13 +253,9 @@ bool TECLayer::addClosest( const TrajectoryStateOnSurface& tsos,
 
 namespace {
   inline
-  bool overlap(float phi, const TECPetal& gsdet, float phiWin) {
+  bool overlap(float phi, const pair<float,float> & petalPhiRange, float phiWin) {
     
-    const BoundDiskSector &  diskSector = gsdet.specificSurface();
     pair<float,float> phiRange(phi-phiWin,phi+phiWin);
-    pair<float,float> petalPhiRange(diskSector.phi() - diskSector.phiHalfExtension(),
-				    diskSector.phi() + diskSector.phiHalfExtension());
-    
     
     return rangesIntersect(phiRange, petalPhiRange, PhiLess());
   }
@@ -283,19 +289,20 @@ void TECLayer::searchNeighbors( const TrajectoryStateOnSurface& tsos,
   }
 
   const BinFinderPhi& binFinder = (crossing.subLayerIndex()==0 ? theFrontBinFinder : theBackBinFinder);
+  const auto & phiRanges = (crossing.subLayerIndex()==0 ? theFrontPhiRanges : theBackPhiRanges);
 
   typedef CompatibleDetToGroupAdder Adder;
   int half = sLayer.size()/2;  // to check if dets are called twice....
   for (int idet=negStartIndex; idet >= negStartIndex - half; idet--) {
-    const auto & neighborPetal = *sLayer[binFinder.binIndex(idet)];
-    if (!overlap( gphi, neighborPetal, window)) break;
-    if (!Adder::add( neighborPetal, tsos, prop, est, result)) break;
+    auto ind = binFinder.binIndex(idet);
+    if (!overlap( gphi, phiRanges[ind], window)) break;
+    if (!Adder::add( *sLayer[ind], tsos, prop, est, result)) break;
     // maybe also add shallow crossing angle test here???
   }
   for (int idet=posStartIndex; idet < posStartIndex + half; idet++) {
-    const auto & neighborPetal = *sLayer[binFinder.binIndex(idet)];
-    if (!overlap( gphi, neighborPetal, window)) break;
-    if (!Adder::add( neighborPetal, tsos, prop, est, result)) break;
+    auto ind = binFinder.binIndex(idet);
+    if (!overlap( gphi, phiRanges[ind], window)) break;
+    if (!Adder::add( *sLayer[ind], tsos, prop, est, result)) break;
     // maybe also add shallow crossing angle test here???
   }
 }
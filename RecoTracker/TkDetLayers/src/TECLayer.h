@@ -80,6 +80,10 @@ class TECLayer : public ForwardDetLayer  {
   BinFinderPhi theFrontBinFinder;
   BinFinderPhi theBackBinFinder;
 
+  // phi range of the petals, in the order of the sub-layers, to find the neighbours without touching them
+  std::vector<std::pair<float,float>> theFrontPhiRanges;
+  std::vector<std::pair<float,float>> theBackPhiRanges;
+
   
 };
 
@@ -41,6 +41,18 @@ public:
   }
   HitDoublets doublets( const TrackingRegion& reg,
                         const edm::Event & ev,  const edm::EventSetup& es, const Layer& innerLayer, const Layer& outerLayer, LayerCacheType& layerCache);
+
+  // same as above, filling (and reusing the memory of) the given container
+  void doublets( const TrackingRegion& reg,
+                 const edm::Event & ev, const edm::EventSetup& es, Layers layers, LayerCacheType& layerCache,
+                 HitDoublets & result) {
+    Layer innerLayerObj = innerLayer(layers);
+    Layer outerLayerObj = outerLayer(layers);
+    doublets(reg, ev, es, innerLayerObj, outerLayerObj, layerCache, result);
+  }
+  void doublets( const TrackingRegion& reg,
+                 const edm::Event & ev,  const edm::EventSetup& es, const Layer& innerLayer, const Layer& outerLayer, LayerCacheType& layerCache,
+                 HitDoublets & result);
   
   void hitPairs( const TrackingRegion& reg, OrderedHitPairs & prs,
                  const edm::Event & ev,  const edm::EventSetup& es, Layers layers);
@@ -11,6 +11,8 @@
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "DataFormats/TrackingRecHit/interface/mayown_ptr.h"
 
+#include <memory>
+
 class LayerHitMapCache {
 
 private:
@@ -46,8 +48,23 @@ private:
     void clear() {      
       for ( auto & v : theContainer)  { v.reset(); }
     }
+    /// emptify cache, keeping the owned values for reuse
+    void recycle() {
+      for ( auto & v : theContainer)  {
+        if (v.isOwn()) theFree.emplace_back(const_cast<ValueType*>(v.release()));
+        else v.reset();
+      }
+    }
+    /// a value released by recycle(), nullptr if none
+    ValueType * reuse() {
+      if (theFree.empty()) return nullptr;
+      auto value = theFree.back().release();
+      theFree.pop_back();
+      return value;
+    }
   private:
     std::vector<mayown_ptr<ValueType> > theContainer;
+    std::vector<std::unique_ptr<ValueType> > theFree;
   };
 
 private:
@@ -60,6 +77,10 @@ public:
 
   void clear() { theCache.clear(); }
 
+  /// as clear(), but the hit maps are kept and refilled later on: for caches
+  /// living across regions and events
+  void recycle() { theCache.recycle(); }
+
   void extend(const LayerHitMapCache& other) {
     theCache.extend(other.theCache);
   }
@@ -71,7 +92,9 @@ public:
     assert (key>=0);
     const RecHitsSortedInPhi * lhm = theCache.get(key);
     if (lhm==nullptr) {
-      auto tmp=new RecHitsSortedInPhi (region.hits(iSetup,layer), region.origin(), layer.detLayer());
+      auto tmp = theCache.reuse();
+      if (tmp) tmp->reset(region.hits(iSetup,layer), region.origin(), layer.detLayer());
+      else tmp=new RecHitsSortedInPhi (region.hits(iSetup,layer), region.origin(), layer.detLayer());
       tmp->theOrigin = region.origin();
       theCache.add( key, tmp);
       lhm = tmp;
@@ -42,6 +42,9 @@ public:
   
   RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint const & origin, DetLayer const * il);
 
+  // Refill with the hits of another layer (or event), reusing the allocated memory
+  void reset(const std::vector<Hit>& hits, GlobalPoint const & origin, DetLayer const * il);
+
   bool empty() const { return theHits.empty(); }
   std::size_t size() const { return theHits.size();}
 
@@ -125,6 +128,10 @@ public:
  *   a collection of hit pairs issued by a doublet search
  * replace HitPairs as a communication mean between doublet and triplet search algos
  *
+ *   the doublets are stored as arrays (SoA): the indices of the two hits in the
+ *   RecHitsSortedInPhi of the inner and outer layer, and the coordinates of the
+ *   two hits, copied when the doublet is added, so that the CA and triplet
+ *   generators read them in doublet order, without going through the indices
  */
 class HitDoublets {
 public:
@@ -132,47 +139,77 @@ public:
 
   using HitLayer = RecHitsSortedInPhi;
   using Hit=RecHitsSortedInPhi::Hit;
-  using ADoublet = std::pair<int,int>;
   
+  // empty container, to be attached to the layers with reset()
+  HitDoublets() : layers{{nullptr,nullptr}}{}
+
   HitDoublets(  RecHitsSortedInPhi const & in,
 		RecHitsSortedInPhi const & out) :
     layers{{&in,&out}}{}
   
-  HitDoublets(HitDoublets && rh) : layers(std::move(rh.layers)), indeces(std::move(rh.indeces)){}
+  HitDoublets(HitDoublets && rh) : layers(std::move(rh.layers)), sides(std::move(rh.sides)){}
   
-  void reserve(std::size_t s) { indeces.reserve(s);}
-  std::size_t size() const { return indeces.size();}
-  bool empty() const { return indeces.empty();}
-  void clear() { indeces.clear();}
-  void shrink_to_fit() {
-    indeces.shrink_to_fit();
+  // attach to a new pair of layers, keeping the allocated memory
+  void reset(  RecHitsSortedInPhi const & in,
+	       RecHitsSortedInPhi const & out) {
+    layers = {{&in,&out}};
+    clear();
   }
+
+  void reserve(std::size_t s) { for (auto & side : sides) side.reserve(s);}
+  std::size_t size() const { return sides[inner].index.size();}
+  bool empty() const { return sides[inner].index.empty();}
+  void clear() { for (auto & side : sides) side.clear();}
+  void shrink_to_fit() { for (auto & side : sides) side.shrink_to_fit();}
   
   void add (int il, int ol) {
-    indeces.emplace_back(il,ol);
+    sides[inner].push_back(*layers[inner], il);
+    sides[outer].push_back(*layers[outer], ol);
   }
 
-  int index(int i, layer l) const { return l==inner ? innerHitId(i) : outerHitId(i);}
+  int index(int i, layer l) const { return sides[l].index[i];}
   DetLayer const * detLayer(layer l) const { return layers[l]->layer; }
   HitLayer const & innerLayer() const { return *layers[inner];}
   HitLayer const & outerLayer() const { return *layers[outer];}
-  int innerHitId(int i) const {return indeces[i].first;}
-  int outerHitId(int i) const {return indeces[i].second;}
+  int innerHitId(int i) const {return sides[inner].index[i];}
+  int outerHitId(int i) const {return sides[outer].index[i];}
   Hit const & hit(int i, layer l) const { return layers[l]->theHits[index(i,l)].hit();}
-  float       phi(int i, layer l) const { return layers[l]->phi(index(i,l));}
-  float       rv(int i, layer l) const { return layers[l]->rv(index(i,l));}
+  float       phi(int i, layer l) const { return sides[l].phi[i];}
+  float       rv(int i, layer l) const { return sides[l].rv[i];}
   float       r(int i, layer l) const { float xp = x(i,l); float yp = y(i,l);  return std::sqrt (xp*xp + yp*yp);}
-  float        z(int i, layer l) const { return layers[l]->z[index(i,l)];}
-  float        x(int i, layer l) const { return layers[l]->x[index(i,l)];}
-  float        y(int i, layer l) const { return layers[l]->y[index(i,l)];}
+  float        z(int i, layer l) const { return sides[l].z[i];}
+  float        x(int i, layer l) const { return sides[l].x[i];}
+  float        y(int i, layer l) const { return sides[l].y[i];}
   GlobalPoint gp(int i, layer l) const { return GlobalPoint(x(i,l),y(i,l),z(i,l));}
 
-private:
+  // direct access to the arrays, size() elements each
+  int const * innerHitIds() const { return sides[inner].index.data();}
+  int const * outerHitIds() const { return sides[outer].index.data();}
+  float const * phis(layer l) const { return sides[l].phi.data();}
+  float const * rvs(layer l) const { return sides[l].rv.data();}
+  float const * xs(layer l) const { return sides[l].x.data();}
+  float const * ys(layer l) const { return sides[l].y.data();}
+  float const * zs(layer l) const { return sides[l].z.data();}
 
-  std::array<RecHitsSortedInPhi const *,2> layers;
+private:
 
+  // the hits of one layer
+  struct Side {
+    std::vector<int> index; // naturally sorted for the outer layer
+    std::vector<float> x, y, z, rv, phi;
+
+    void push_back(RecHitsSortedInPhi const & hits, int i) {
+      index.push_back(i);
+      x.push_back(hits.x[i]); y.push_back(hits.y[i]); z.push_back(hits.z[i]);
+      rv.push_back(hits.rv(i)); phi.push_back(hits.phi(i));
+    }
+    void reserve(std::size_t s) { for (auto v : {&x, &y, &z, &rv, &phi}) v->reserve(s); index.reserve(s);}
+    void clear() { for (auto v : {&x, &y, &z, &rv, &phi}) v->clear(); index.clear();}
+    void shrink_to_fit() { for (auto v : {&x, &y, &z, &rv, &phi}) v->shrink_to_fit(); index.shrink_to_fit();}
+  };
 
-  std::vector<ADoublet> indeces; // naturally sorted by outerId
+  std::array<RecHitsSortedInPhi const *,2> layers;
+  std::array<Side,2> sides;
 
 };
 
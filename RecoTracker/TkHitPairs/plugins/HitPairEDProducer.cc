@@ -50,6 +50,11 @@ namespace {
 
     HitPairGeneratorFromLayerPair generator_;
     std::vector<unsigned> layerPairBegins_;
+
+    // per-stream buffers kept across regions and events, used when the
+    // hit maps and the doublets are not stored in the IntermediateHitDoublets
+    LayerHitMapCache hitCache_;
+    HitDoublets doublets_;
   };
   ImplBase::ImplBase(const edm::ParameterSet& iConfig):
     maxElement_(iConfig.getParameter<unsigned int>("maxElement")),
@@ -79,7 +84,7 @@ namespace {
     void produce(const bool clusterCheckOk, edm::Event& iEvent, const edm::EventSetup& iSetup) override {
       auto regionsLayers = regionsLayers_.beginEvent(iEvent);
 
-      auto seedingHitSetsProducer = T_SeedingHitSets(&localRA_);
+      auto seedingHitSetsProducer = T_SeedingHitSets(&localRA_, &hitCache_);
       auto intermediateHitDoubletsProducer = T_IntermediateHitDoublets(regionsLayers.seedingLayerSetsHitsPtr());
 
       if(!clusterCheckOk) {
@@ -98,7 +103,8 @@ namespace {
         auto hitCachePtr = std::get<0>(hitCachePtr_filler_ihd);
 
         for(SeedingLayerSetsHits::SeedingLayerSet layerSet: regionLayers.layerPairs()) {
-          auto doublets = generator_.doublets(region, iEvent, iSetup, layerSet, *hitCachePtr);
+          auto& doublets = intermediateHitDoubletsProducer.doubletsBuffer(doublets_);
+          generator_.doublets(region, iEvent, iSetup, layerSet, *hitCachePtr, doublets);
           LogTrace("HitPairEDProducer") << " created " << doublets.size() << " doublets for layers " << layerSet[0].index() << "," << layerSet[1].index();
           if(doublets.empty()) continue; // don't bother if no pairs from these layers
           seedingHitSetsProducer.fill(std::get<1>(hitCachePtr_filler_shs), doublets);
@@ -118,7 +124,7 @@ namespace {
   class DoNothing {
   public:
     DoNothing(const SeedingLayerSetsHits *) {}
-    DoNothing(edm::RunningAverage *) {}
+    DoNothing(edm::RunningAverage *, LayerHitMapCache *) {}
 
     static void produces(edm::ProducerBase&) {};
 
@@ -128,6 +134,9 @@ namespace {
       return std::make_tuple(ptr, 0);
     }
 
+    // the doublets are not kept, the per-stream buffer can be used
+    HitDoublets& doubletsBuffer(HitDoublets& streamBuffer) { return streamBuffer; }
+
     void fill(int, const HitDoublets&) {}
     void fill(int, const SeedingLayerSetsHits::SeedingLayerSet&, HitDoublets&&) {}
 
@@ -138,9 +147,10 @@ namespace {
   /////
   class ImplSeedingHitSets {
   public:
-    ImplSeedingHitSets(edm::RunningAverage *localRA):
+    ImplSeedingHitSets(edm::RunningAverage *localRA, LayerHitMapCache *hitCache):
       seedingHitSets_(std::make_unique<RegionsSeedingHitSets>()),
-      localRA_(localRA)
+      localRA_(localRA),
+      hitCache_(hitCache)
     {}
 
     static void produces(edm::ProducerBase& producer) {
@@ -152,8 +162,8 @@ namespace {
     }
 
     auto beginRegion(const TrackingRegion *region, LayerHitMapCache *) {
-      hitCacheTmp_.clear();
-      return std::make_tuple(&hitCacheTmp_, seedingHitSets_->beginRegion(region));
+      hitCache_->recycle();
+      return std::make_tuple(hitCache_, seedingHitSets_->beginRegion(region));
     }
 
     void fill(RegionsSeedingHitSets::RegionFiller& filler, const HitDoublets& doublets) {
@@ -176,7 +186,7 @@ namespace {
   private:
     std::unique_ptr<RegionsSeedingHitSets> seedingHitSets_;
     edm::RunningAverage *localRA_;
-    LayerHitMapCache hitCacheTmp_; // used if !produceIntermediateHitDoublets
+    LayerHitMapCache *hitCache_; // per-stream, used if !produceIntermediateHitDoublets
   };
 
   /////
@@ -200,7 +210,11 @@ namespace {
       return std::make_tuple(&(filler.layerHitMapCache()), std::move(filler));
     }
 
+    // the doublets are moved to the product, a new container is needed for each layer pair
+    HitDoublets& doubletsBuffer(HitDoublets&) { return doublets_; }
+
     void fill(IntermediateHitDoublets::RegionFiller& filler, const SeedingLayerSetsHits::SeedingLayerSet& layerSet, HitDoublets&& doublets) {
+      doublets.shrink_to_fit();
       filler.addDoublets(layerSet, std::move(doublets));
     }
 
@@ -216,6 +230,7 @@ namespace {
   private:
     std::unique_ptr<IntermediateHitDoublets> intermediateHitDoublets_;
     const SeedingLayerSetsHits *layers_;
+    HitDoublets doublets_;
   };
 
   /////
@@ -99,11 +99,28 @@ HitDoublets HitPairGeneratorFromLayerPair::doublets( const TrackingRegion& regio
   doublets(region,
 	   *innerLayer.detLayer(),*outerLayer.detLayer(),
 	   innerHitsMap,outerHitsMap,iSetup,theMaxElement,result);
+  result.shrink_to_fit();
   
   return result;
 
 }
 
+void HitPairGeneratorFromLayerPair::doublets( const TrackingRegion& region,
+                                              const edm::Event & iEvent, const edm::EventSetup& iSetup, const Layer& innerLayer, const Layer& outerLayer,
+                                              LayerCacheType& layerCache, HitDoublets & result) {
+
+  const RecHitsSortedInPhi & innerHitsMap = layerCache(innerLayer, region, iSetup);
+  if (innerHitsMap.empty()) { result.reset(innerHitsMap,innerHitsMap); return; }
+
+  const RecHitsSortedInPhi& outerHitsMap = layerCache(outerLayer, region, iSetup);
+  result.reset(innerHitsMap,outerHitsMap);
+  if (outerHitsMap.empty()) return;
+  // the memory is kept by the caller, no shrinking
+  doublets(region,
+	   *innerLayer.detLayer(),*outerLayer.detLayer(),
+	   innerHitsMap,outerHitsMap,iSetup,theMaxElement,result);
+}
+
 void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
 						    const DetLayer & innerHitDetLayer,
 						    const DetLayer & outerHitDetLayer,
@@ -176,7 +193,6 @@ void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
     delete checkRZ;
   }
   LogDebug("HitPairGeneratorFromLayerPair")<<" total number of pairs provided back: "<<result.size();
-  result.shrink_to_fit();
 
 }
 
@@ -6,18 +6,24 @@
 
 
 
-RecHitsSortedInPhi::RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint const & origin, DetLayer const * il) :
-  layer(il),
-  isBarrel(il->isBarrel()),
-  x(hits.size()),y(hits.size()),z(hits.size()),drphi(hits.size()),
-  u(hits.size()),v(hits.size()),du(hits.size()),dv(hits.size()),
-  lphi(hits.size())
+RecHitsSortedInPhi::RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint const & origin, DetLayer const * il)
 {
+  reset(hits, origin, il);
+}
+
+void RecHitsSortedInPhi::reset(const std::vector<Hit>& hits, GlobalPoint const & origin, DetLayer const * il)
+{
+  layer = il;
+  isBarrel = il->isBarrel();
+  x.resize(hits.size()); y.resize(hits.size()); z.resize(hits.size()); drphi.resize(hits.size());
+  u.resize(hits.size()); v.resize(hits.size()); du.resize(hits.size()); dv.resize(hits.size());
+  lphi.resize(hits.size());
 
   // standard region have origin as 0,0,z (not true!!!!0
   // cosmic region never used here
   // assert(origin.x()==0 && origin.y()==0);
 
+  theHits.clear();
   theHits.reserve(hits.size());
   for (auto const & hp : hits) theHits.emplace_back(hp);
   
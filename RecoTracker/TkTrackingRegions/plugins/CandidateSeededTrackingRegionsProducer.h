@@ -16,6 +16,10 @@
 #include "DataFormats/VertexReco/interface/VertexFwd.h"
 #include "DataFormats/Candidate/interface/Candidate.h"
 
+#include "EtaPhiWindow.h"
+
+#include <cmath>
+
 /** class CandidateSeededTrackingRegionsProducer
  *
  * eta-phi TrackingRegions producer in directions defined by Candidate-based objects of interest
@@ -39,6 +43,13 @@
  *   If, while using one of the "Vertices" modes, there's no vertices in an event, we fall back into
  *   either BeamSpotSigma or BeamSpotFixed mode, depending on the positiveness of nSigmaZBeamSpot.
  *
+ * With mergeOverlappingRegions, the eta-phi windows around the same origin are merged whenever
+ * their bounding box is not larger than the two windows together, so that the hits and the
+ * doublets of the overlapping area are built only once by the seeding. This changes the physics
+ * output: a merged region is the bounding box of the windows it replaces, so it also contains
+ * the hits in the corners between them, which can give additional seeds; the regions are also
+ * ordered by origin rather than by object. Off by default.
+ *
  *   \author Vadim Khotilovich
  */
 class  CandidateSeededTrackingRegionsProducer : public TrackingRegionProducer
@@ -84,6 +95,8 @@ public:
     }
     m_searchOpt = false;
     if (regPSet.exists("searchOpt")) m_searchOpt = regPSet.getParameter<bool>("searchOpt");
+    m_mergeOverlappingRegions = false;
+    if (regPSet.existsAs<bool>("mergeOverlappingRegions")) m_mergeOverlappingRegions = regPSet.getParameter<bool>("mergeOverlappingRegions");
 
     // mode-dependent z-halflength of tracking regions
     if (m_mode == VERTICES_SIGMA)  m_nSigmaZVertex   = regPSet.getParameter<double>("nSigmaZVertex");
@@ -125,6 +138,7 @@ public:
     desc.add<edm::InputTag>("measurementTrackerName", edm::InputTag(""));
 
     desc.add<bool>("searchOpt", false);
+    desc.addOptional<bool>("mergeOverlappingRegions", false);
 
     // Only for backwards-compatibility
     edm::ParameterSetDescription descRegion;
@@ -198,27 +212,68 @@ public:
     // create tracking regions (maximum MaxNRegions of them) in directions of the
     // objects of interest (we expect that the collection was sorted in decreasing pt order)
     int n_regions = 0;
-    for(size_t i = 0; i < n_objects && n_regions < m_maxNRegions; ++i )
+    if (!m_mergeOverlappingRegions)
+    {
+      for(size_t i = 0; i < n_objects && n_regions < m_maxNRegions; ++i )
+      {
+        const reco::Candidate & object = (*objects)[i];
+        GlobalVector direction( object.momentum().x(), object.momentum().y(), object.momentum().z() );
+
+        for (size_t  j=0; j<origins.size() && n_regions < m_maxNRegions; ++j)
+        {
+          result.push_back(std::make_unique<RectangularEtaPhiTrackingRegion>(
+            direction,
+            origins[j].first,
+            m_ptMin,
+            m_originRadius,
+            origins[j].second,
+            m_deltaEta,
+            m_deltaPhi,
+            m_whereToUseMeasurementTracker,
+            m_precise,
+            measurementTracker,
+            m_searchOpt
+          ));
+          ++n_regions;
+        }
+      }
+    }
+    else
     {
-      const reco::Candidate & object = (*objects)[i];
-      GlobalVector direction( object.momentum().x(), object.momentum().y(), object.momentum().z() );
+      // the same windows as above, merged per origin
+      std::vector< std::vector<EtaPhiWindow> > windows(origins.size());
+      for(size_t i = 0; i < n_objects && n_regions < m_maxNRegions; ++i )
+      {
+        const reco::Candidate & object = (*objects)[i];
+        for (size_t  j=0; j<origins.size() && n_regions < m_maxNRegions; ++j)
+        {
+          windows[j].push_back(EtaPhiWindow{float(object.eta()), m_deltaEta, float(object.phi()), m_deltaPhi});
+          ++n_regions;
+        }
+      }
 
-      for (size_t  j=0; j<origins.size() && n_regions < m_maxNRegions; ++j)
+      n_regions = 0;
+      for (size_t  j=0; j<origins.size(); ++j)
       {
-        result.push_back(std::make_unique<RectangularEtaPhiTrackingRegion>(
-          direction,
-          origins[j].first,
-          m_ptMin,
-          m_originRadius,
-          origins[j].second,
-          m_deltaEta,
-          m_deltaPhi,
-          m_whereToUseMeasurementTracker,
-          m_precise,
-          measurementTracker,
-          m_searchOpt
-        ));
-        ++n_regions;
+        EtaPhiWindow::mergeOverlapping(windows[j]);
+        for (auto const & w : windows[j])
+        {
+          GlobalVector direction( std::cos(w.phi), std::sin(w.phi), std::sinh(w.eta) );
+          result.push_back(std::make_unique<RectangularEtaPhiTrackingRegion>(
+            direction,
+            origins[j].first,
+            m_ptMin,
+            m_originRadius,
+            origins[j].second,
+            w.deltaEta,
+            w.deltaPhi,
+            m_whereToUseMeasurementTracker,
+            m_precise,
+            measurementTracker,
+            m_searchOpt
+          ));
+          ++n_regions;
+        }
       }
     }
     //std::cout<<"n_seeded_regions = "<<n_regions<<std::endl;
@@ -246,6 +301,7 @@ private:
   edm::EDGetTokenT<MeasurementTrackerEvent> token_measurementTracker;
   RectangularEtaPhiTrackingRegion::UseMeasurementTracker m_whereToUseMeasurementTracker;
   bool m_searchOpt;
+  bool m_mergeOverlappingRegions;
 
   float m_nSigmaZVertex;
   float m_zErrorVetex;
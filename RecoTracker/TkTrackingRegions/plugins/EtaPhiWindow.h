@@ -0,0 +1,54 @@
+#ifndef RecoTracker_TkTrackingRegions_EtaPhiWindow_h
+#define RecoTracker_TkTrackingRegions_EtaPhiWindow_h
+
+#include "DataFormats/Math/interface/deltaPhi.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/** Eta-phi window of a tracking region: centre and half-widths.
+ *
+ *  mergeOverlapping merges pairs of windows until no pair has a bounding box
+ *  smaller than the sum of the two areas (and narrower than pi in phi). Each
+ *  merged window is the bounding box of the windows it replaces, so it covers
+ *  them but also the corners between them.
+ */
+struct EtaPhiWindow
+{
+  float eta, deltaEta, phi, deltaPhi;
+
+  static void mergeOverlapping(std::vector<EtaPhiWindow>& windows)
+  {
+    bool merged = true;
+    while (merged)
+    {
+      merged = false;
+      for (size_t i = 0; i < windows.size() && !merged; ++i)
+      {
+        for (size_t k = i+1; k < windows.size() && !merged; ++k)
+        {
+          EtaPhiWindow & a = windows[i];
+          const EtaPhiWindow & b = windows[k];
+          // phi relative to the centre of a
+          float etaMin = std::min(a.eta - a.deltaEta, b.eta - b.deltaEta);
+          float etaMax = std::max(a.eta + a.deltaEta, b.eta + b.deltaEta);
+          float dPhi   = reco::deltaPhi(b.phi, a.phi);
+          float phiMin = std::min(-a.deltaPhi, dPhi - b.deltaPhi);
+          float phiMax = std::max( a.deltaPhi, dPhi + b.deltaPhi);
+          if ((etaMax-etaMin)*(phiMax-phiMin) > 4.f*(a.deltaEta*a.deltaPhi + b.deltaEta*b.deltaPhi)) continue;
+          if (phiMax-phiMin >= float(M_PI)) continue;
+
+          a.eta      = 0.5f*(etaMax + etaMin);
+          a.deltaEta = 0.5f*(etaMax - etaMin);
+          a.phi      = reco::reduceRange(a.phi + 0.5f*(phiMax + phiMin));
+          a.deltaPhi = 0.5f*(phiMax - phiMin);
+          windows.erase(windows.begin()+k);
+          merged = true;
+        }
+      }
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,91 @@
+// Merging of the eta-phi windows of CandidateSeededTrackingRegionsProducer:
+// every window is covered by exactly one merged window, and only windows
+// whose bounding box is not larger than the two together are merged.
+
+#include "RecoTracker/TkTrackingRegions/plugins/EtaPhiWindow.h"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  bool covers(const EtaPhiWindow & merged, const EtaPhiWindow & w) {
+    const float eps = 1.e-5f;
+    return w.eta - w.deltaEta >= merged.eta - merged.deltaEta - eps &&
+      w.eta + w.deltaEta <= merged.eta + merged.deltaEta + eps &&
+      std::abs(reco::deltaPhi(w.phi, merged.phi)) + w.deltaPhi <= merged.deltaPhi + eps;
+  }
+
+  void checkCovered(const std::vector<EtaPhiWindow> & windows, const std::vector<EtaPhiWindow> & merged) {
+    for (auto const & w : windows) {
+      bool found = false;
+      for (auto const & m : merged) found |= covers(m, w);
+      assert(found);
+    }
+  }
+
+}
+
+int main() {
+
+  // disjoint windows are kept as they are
+  {
+    std::vector<EtaPhiWindow> windows = {{0.f, 0.1f, 0.f, 0.1f}, {1.f, 0.1f, 0.f, 0.1f}, {0.f, 0.1f, 2.f, 0.1f}};
+    auto merged = windows;
+    EtaPhiWindow::mergeOverlapping(merged);
+    assert(merged.size() == 3);
+    for (unsigned int i = 0; i < 3; ++i) {
+      assert(merged[i].eta == windows[i].eta && merged[i].deltaEta == windows[i].deltaEta);
+      assert(merged[i].phi == windows[i].phi && merged[i].deltaPhi == windows[i].deltaPhi);
+    }
+  }
+
+  // largely overlapping windows give their bounding box
+  {
+    std::vector<EtaPhiWindow> windows = {{0.f, 0.1f, 0.f, 0.1f}, {0.05f, 0.1f, 0.02f, 0.1f}};
+    auto merged = windows;
+    EtaPhiWindow::mergeOverlapping(merged);
+    assert(merged.size() == 1);
+    assert(std::abs(merged[0].eta - 0.025f) < 1.e-6f && std::abs(merged[0].deltaEta - 0.125f) < 1.e-6f);
+    assert(std::abs(merged[0].phi - 0.01f) < 1.e-6f && std::abs(merged[0].deltaPhi - 0.11f) < 1.e-6f);
+  }
+
+  // across phi = pi
+  {
+    std::vector<EtaPhiWindow> windows = {{0.f, 0.1f, 3.1f, 0.1f}, {0.f, 0.1f, -3.1f, 0.1f}};
+    auto merged = windows;
+    EtaPhiWindow::mergeOverlapping(merged);
+    assert(merged.size() == 1);
+    assert(std::abs(std::abs(merged[0].phi) - float(M_PI)) < 1.e-5f);
+    checkCovered(windows, merged);
+  }
+
+  // diagonal neighbours: the bounding box would be larger than the two windows
+  {
+    std::vector<EtaPhiWindow> windows = {{0.f, 0.1f, 0.f, 0.1f}, {0.15f, 0.1f, 0.15f, 0.1f}};
+    auto merged = windows;
+    EtaPhiWindow::mergeOverlapping(merged);
+    assert(merged.size() == 2);
+  }
+
+  // random jets: all windows covered, no mergeable pair left
+  std::mt19937 eng;
+  std::uniform_real_distribution<float> eta(-2.5f, 2.5f), phi(-float(M_PI), float(M_PI));
+  for (unsigned int event = 0; event < 100; ++event) {
+    std::vector<EtaPhiWindow> windows;
+    for (unsigned int i = 0; i < 20; ++i) windows.push_back(EtaPhiWindow{eta(eng), 0.3f, phi(eng), 0.3f});
+    auto merged = windows;
+    EtaPhiWindow::mergeOverlapping(merged);
+    assert(merged.size() <= windows.size());
+    checkCovered(windows, merged);
+    auto again = merged;
+    EtaPhiWindow::mergeOverlapping(again);
+    assert(again.size() == merged.size());
+  }
+
+  std::cout << "EtaPhiWindow OK" << std::endl;
+  return 0;
+}
@@ -32,6 +32,8 @@ public:
       
       pi.push_back( new_pi ); // track weight
       Z_sum.push_back( 1.0); // Z[i]   for DA clustering, initial value as done in ::fill
+      kmin.push_back( 0 );
+      kmax.push_back( 0 );
     }
 
     
@@ -63,6 +65,10 @@ public:
     
     std::vector<double> Z_sum; // Z[i]   for DA clustering
     std::vector<double> pi; // track weight
+
+    // range [kmin, kmax) of the vertices the track interacts with, see set_vtx_range
+    std::vector<unsigned int> kmin;
+    std::vector<unsigned int> kmax;
   };
   
   struct vertex_t {
@@ -70,8 +76,6 @@ public:
     std::vector<double> pk; //           vertex weight for "constrained" clustering
     
     // --- temporary numbers, used during update
-    std::vector<double> ei_cache;
-    std::vector<double> ei;
     std::vector<double> sw;
     std::vector<double> swz;
     std::vector<double> se;
@@ -88,8 +92,6 @@ public:
       z.push_back( new_z);
       pk.push_back( new_pk);
       
-      ei_cache.push_back( 0.0 );
-      ei.push_back( 0.0 );
       sw.push_back( 0.0 );
       swz.push_back( 0.0);
       se.push_back( 0.0);
@@ -103,8 +105,6 @@ public:
       z.insert(z.begin() + i, new_z);
       pk.insert(pk.begin() + i, new_pk);
       
-      ei_cache.insert(ei_cache.begin() + i, 0.0 );
-      ei.insert( ei.begin()  + i, 0.0 );
       sw.insert( sw.begin()  + i, 0.0 );
       swz.insert(swz.begin() + i, 0.0 );
       se.insert( se.begin()  + i, 0.0 );
@@ -118,8 +118,6 @@ public:
       z.erase( z.begin() + i );
       pk.erase( pk.begin() + i );
       
-      ei_cache.erase( ei_cache.begin() + i);
-      ei.erase( ei.begin() + i);
       sw.erase( sw.begin() + i);
       swz.erase( swz.begin() + i);
       se.erase(se.begin() + i);
@@ -144,20 +142,16 @@ public:
       _z = &z.front();
       _pk = &pk.front();
       
-      _ei = &ei.front();
       _sw = &sw.front();
       _swz = &swz.front();
       _se = &se.front();
       _swE = &swE.front();
-      _ei_cache = &ei_cache.front();
       
     }
     
     double * __restrict__ _z;
     double * __restrict__ _pk;
     
-    double * __restrict__ _ei_cache;
-    double * __restrict__ _ei;
     double * __restrict__ _sw;
     double * __restrict__ _swz;
     double * __restrict__ _se;
@@ -177,6 +171,8 @@ public:
 	   const int verbosity = 0) const ;
   
   track_t	fill(const std::vector<reco::TransientTrack> & tracks) const;
+
+  void set_vtx_range(double beta, track_t & gtracks, vertex_t & gvertices) const;
   
   double update(double beta, track_t & gtracks,
 		vertex_t & gvertices, bool useRho0, const double & rho0) const;
@@ -211,6 +207,10 @@ private:
   double zmerge_;
   double betapurge_;
 
+  // tracks only see vertices closer than max(zrange_ * sigma_z(T), zrange_min_)
+  double zrange_;
+  double zrange_min_;
+
 };
 
 
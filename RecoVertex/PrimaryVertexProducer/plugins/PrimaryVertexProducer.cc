@@ -18,6 +18,9 @@
 
 #include "RecoVertex/VertexTools/interface/GeometricAnnealing.h"
 
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_for.h"
+
 PrimaryVertexProducer::PrimaryVertexProducer(const edm::ParameterSet& conf)
   :theConfig(conf)
 {
@@ -189,15 +192,20 @@ PrimaryVertexProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup
     reco::VertexCollection & vColl = (*result);
 
 
-    std::vector<TransientVertex> pvs;
-    for (std::vector< std::vector<reco::TransientTrack> >::const_iterator iclus
-	   = clusters.begin(); iclus != clusters.end(); iclus++) {
-      
+    // fit the vertex candidates in parallel; the fitters keep state during a fit,
+    // so every thread uses its own copy, reused for all the candidates it fits
+    std::vector<TransientVertex> fitted(clusters.size());
+    tbb::enumerable_thread_specific<std::unique_ptr<VertexFitter<5> > > fitters;
+    tbb::parallel_for(size_t(0), clusters.size(), [&](size_t i) {
+      auto const & clus = clusters[i];
+      auto & fitter = fitters.local();
+      if (!fitter) fitter.reset(algorithm->fitter->clone());
+
       double meantime = 0.;
       double expv_x2 = 0.;
       double normw = 0.;  
       if( f4D ) {
-        for( const auto& tk : *iclus ) {
+        for( const auto& tk : clus ) {
           const double time = tk.timeExt();
           const double inverr = 1.0/tk.dtErrorExt();
           const double w = inverr*inverr;
@@ -211,33 +219,40 @@ PrimaryVertexProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup
       const double time_var = ( f4D ? expv_x2 - meantime*meantime : 0. ); 
 
 
-      TransientVertex v; 
-      if( algorithm->useBeamConstraint && validBS &&((*iclus).size()>1) ){
+      TransientVertex & v = fitted[i];
+      if( algorithm->useBeamConstraint && validBS &&(clus.size()>1) ){
         
-	v = algorithm->fitter->vertex(*iclus, beamSpot);
+	v = fitter->vertex(clus, beamSpot);
 	
         if( f4D ) {
           if( v.isValid() ) {
             auto err = v.positionError().matrix4D();
-            err(3,3) = time_var/(double)iclus->size();        
+            err(3,3) = time_var/(double)clus.size();        
             v = TransientVertex(v.position(),meantime,err,v.originalTracks(),v.totalChiSquared());
           }
         }
 	
-      }else if( !(algorithm->useBeamConstraint) && ((*iclus).size()>1) ) {
+      }else if( !(algorithm->useBeamConstraint) && (clus.size()>1) ) {
               
-	v = algorithm->fitter->vertex(*iclus);
+	v = fitter->vertex(clus);
         
         if( f4D ) {
           if( v.isValid() ) {
             auto err = v.positionError().matrix4D();
-            err(3,3) = time_var/(double)iclus->size();          
+            err(3,3) = time_var/(double)clus.size();          
             v = TransientVertex(v.position(),meantime,err,v.originalTracks(),v.totalChiSquared());
           }
         }
 	
       }// else: no fit ==> v.isValid()=False
+    });
+
 
+    // select in the order of the candidates, the result is the same as with sequential fits
+    std::vector<TransientVertex> pvs;
+    for (size_t i = 0; i < clusters.size(); i++) {
+      auto iclus = clusters.begin() + i;
+      TransientVertex const & v = fitted[i];
 
       if (fVerbose){
 	if (v.isValid()) {
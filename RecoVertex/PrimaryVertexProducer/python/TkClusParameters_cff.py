@@ -11,6 +11,8 @@ DA_vectParameters = cms.PSet(
         d0CutOff = cms.double(3.),        # downweight high IP tracks 
         dzCutOff = cms.double(3.),        # outlier rejection after freeze-out (T<Tmin)       
         zmerge = cms.double(1e-2),        # merge intermediat clusters separated by less than zmerge
+        zrange = cms.double(4.),          # tracks only see vertices within zrange * sigma_z(T) ...
+        zrangeMin = cms.double(0.1),      # ... or zrangeMin
         uniquetrkweight = cms.double(0.8) # require at least two tracks with this weight at T=Tpurge
         )
 )
@@ -10,6 +10,8 @@
 #include "FWCore/Utilities/interface/isFinite.h"
 #include "vdt/vdtMath.h"
 
+#include "tbb/parallel_for.h"
+
 using namespace std;
 
 DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
@@ -39,11 +41,15 @@ DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
   dzCutOff_ = conf.getParameter<double> ("dzCutOff");
   uniquetrkweight_ = conf.getParameter<double>("uniquetrkweight");
   zmerge_ = conf.getParameter<double>("zmerge");
+  zrange_ = conf.existsAs<double>("zrange") ? conf.getParameter<double>("zrange") : 4.;
+  zrange_min_ = conf.existsAs<double>("zrangeMin") ? conf.getParameter<double>("zrangeMin") : 0.1;
 
   if(verbose_){
     std::cout << "DAClusterizerinZ_vect: mintrkweight = " << mintrkweight_ << std::endl;
     std::cout << "DAClusterizerinZ_vect: uniquetrkweight = " << uniquetrkweight_ << std::endl;
     std::cout << "DAClusterizerinZ_vect: zmerge = " << zmerge_ << std::endl;
+    std::cout << "DAClusterizerinZ_vect: zrange = " << zrange_ << std::endl;
+    std::cout << "DAClusterizerinZ_vect: zrangeMin = " << zrange_min_ << std::endl;
     std::cout << "DAClusterizerinZ_vect: Tmin = " << Tmin << std::endl;
     std::cout << "DAClusterizerinZ_vect: Tpurge = " << Tpurge << std::endl;
     std::cout << "DAClusterizerinZ_vect: Tstop = " << Tstop << std::endl;
@@ -95,13 +101,25 @@ namespace {
 DAClusterizerInZ_vect::track_t 
 DAClusterizerInZ_vect::fill(const vector<reco::TransientTrack> & tracks) const {
 
-  // prepare track data for clustering
+  // prepare track data for clustering, sorted in z so that neighbouring tracks
+  // interact with the same vertices (see set_vtx_range and update)
+  std::vector<std::pair<double, const reco::TransientTrack*> > sorted;
+  sorted.reserve(tracks.size());
+  for (auto const & tk : tracks) {
+    if (!tk.isValid()) continue;
+    double t_z = (tk.stateAtBeamLine().trackStateAtPCA()).position().z();
+    if (std::fabs(t_z) > 1000.) continue;
+    sorted.emplace_back(t_z, &tk);
+  }
+  std::stable_sort(sorted.begin(), sorted.end(),
+		   [](std::pair<double, const reco::TransientTrack*> const & a, std::pair<double, const reco::TransientTrack*> const & b) {
+		     return a.first < b.first; });
+
   track_t tks;
-  for (auto it = tracks.begin(); it!= tracks.end(); it++){
-    if (!(*it).isValid()) continue;
+  for (auto const & zt : sorted){
+    auto it = zt.second;
     double t_pi=1.;
-    double t_z = ((*it).stateAtBeamLine().trackStateAtPCA()).position().z();
-    if (std::fabs(t_z) > 1000.) continue;
+    double t_z = zt.first;
     auto const & t_mom = (*it).stateAtBeamLine().trackStateAtPCA().momentum();
     //  get the beam-spot
     reco::BeamSpot beamspot = (it->stateAtBeamLine()).beamSpot();
@@ -118,7 +136,7 @@ DAClusterizerInZ_vect::fill(const vector<reco::TransientTrack> & tracks) const {
       if (edm::isNotFinite(t_pi) ||  t_pi < std::numeric_limits<double>::epsilon())  continue; // usually is > 0.99
     }
     LogTrace("DAClusterizerinZ_vectorized") << t_z <<' '<< t_dz2 <<' '<< t_pi;
-    tks.AddItem(t_z, t_dz2, &(*it), t_pi);
+    tks.AddItem(t_z, t_dz2, it, t_pi);
   }
   tks.ExtractRaw();
   
@@ -137,6 +155,43 @@ namespace {
   }
 }
 
+void DAClusterizerInZ_vect::set_vtx_range(double beta, track_t & gtracks, vertex_t & gvertices) const {
+
+  // for every track find the range [kmin, kmax) of the (z-sorted) vertices within
+  // max(zrange_/sqrt(beta*dz2), zrange_min_), beyond which exp(-beta*Eik) < exp(-zrange_^2);
+  // the search starts from the previous range, which is usually close
+  const unsigned int nt = gtracks.GetSize();
+  const unsigned int nv = gvertices.GetSize();
+
+  if (nv == 0) {
+    for (auto itrack = 0U; itrack < nt; ++itrack) { gtracks.kmin[itrack] = 0; gtracks.kmax[itrack] = 0; }
+    return;
+  }
+
+  for (auto itrack = 0U; itrack < nt; ++itrack) {
+    double zrange = std::max(zrange_ / std::sqrt(beta * gtracks._dz2[itrack]), zrange_min_);
+
+    // first vertex above zmin
+    double zmin = gtracks._z[itrack] - zrange;
+    unsigned int kmin = std::min(nv - 1, gtracks.kmin[itrack]);
+    if (gvertices._z[kmin] > zmin) {
+      while ((kmin > 0) && (gvertices._z[kmin - 1] > zmin)) { kmin--; }
+    } else {
+      while ((kmin < nv) && (gvertices._z[kmin] <= zmin)) { kmin++; }
+    }
+
+    // first vertex above zmax
+    double zmax = gtracks._z[itrack] + zrange;
+    unsigned int kmax = std::max(kmin, std::min(nv, gtracks.kmax[itrack]));
+    while ((kmax > kmin) && (gvertices._z[kmax - 1] >= zmax)) { kmax--; }
+    while ((kmax < nv) && (gvertices._z[kmax] < zmax)) { kmax++; }
+
+    gtracks.kmin[itrack] = kmin;
+    gtracks.kmax[itrack] = kmax;
+  }
+}
+
+
 double DAClusterizerInZ_vect::update(double beta, track_t & gtracks,
 				     vertex_t & gvertices, bool useRho0, const double & rho0) const {
 
@@ -161,72 +216,109 @@ double DAClusterizerInZ_vect::update(double beta, track_t & gtracks,
     {
       Z_init = rho0 * local_exp(-beta * dzCutOff_ * dzCutOff_); // cut-off
     }
-  
-  // define kernels
-  auto kernel_calc_exp_arg = [ beta, nv ] ( const unsigned int itrack,
-					     track_t const& tracks,
-					     vertex_t const& vertices ) {
-    const double track_z = tracks._z[itrack];
-    const double botrack_dz2 = -beta*tracks._dz2[itrack];
-
-    // auto-vectorized
-    for ( unsigned int ivertex = 0; ivertex < nv; ++ivertex) {
-      auto mult_res =  track_z - vertices._z[ivertex];
-      vertices._ei_cache[ivertex] = botrack_dz2 * ( mult_res * mult_res );
-    }
+
+  // each track only interacts with the vertices in its range
+  set_vtx_range(beta, gtracks, gvertices);
+
+  // the z-sorted tracks are processed in slices of fixed size, possibly in parallel;
+  // each slice accumulates into its own sums over the vertices it sees, which are added up
+  // in slice order afterwards, so that the result does not depend on the number of threads
+  struct slice_t {
+    unsigned int kmin, kmax;
+    std::vector<double> se, sw, swz, swE;
   };
-  
-  auto kernel_add_Z = [ nv, Z_init ] (vertex_t const& vertices) -> double
-    {
+  constexpr unsigned int sliceSize = 128;
+  const unsigned int nslices = (nt + sliceSize - 1) / sliceSize;
+  std::vector<slice_t> slices(nslices);
+
+  auto kernel_slice = [ beta, nt, Z_init, &gtracks, &gvertices, &slices ] ( unsigned int islice ) {
+    const unsigned int ifirst = islice * sliceSize;
+    const unsigned int ilast = std::min(nt, ifirst + sliceSize);
+    auto & slice = slices[islice];
+    slice.kmin = gtracks.kmin[ifirst];
+    slice.kmax = gtracks.kmax[ifirst];
+    for (auto itrack = ifirst; itrack < ilast; ++itrack) {
+      slice.kmin = std::min(slice.kmin, gtracks.kmin[itrack]);
+      slice.kmax = std::max(slice.kmax, gtracks.kmax[itrack]);
+    }
+    const unsigned int ns = slice.kmax - slice.kmin;
+    slice.se.assign(ns, 0.0);
+    slice.sw.assign(ns, 0.0);
+    slice.swz.assign(ns, 0.0);
+    slice.swE.assign(ns, 0.0);
+    std::vector<double> ei_cache(ns), ei(ns);
+
+    for (auto itrack = ifirst; itrack < ilast; ++itrack) {
+      const unsigned int kmin = gtracks.kmin[itrack];
+      const unsigned int n = gtracks.kmax[itrack] - kmin;
+      const double track_z = gtracks._z[itrack];
+      const double botrack_dz2 = -beta*gtracks._dz2[itrack];
+      const double * __restrict__ vz = gvertices._z + kmin;
+      const double * __restrict__ vpk = gvertices._pk + kmin;
+      double * __restrict__ arg = ei_cache.data();
+      double * __restrict__ eik = ei.data();
+
+      // auto-vectorized
+      for (unsigned int k = 0; k < n; ++k) {
+	auto mult_res = track_z - vz[k];
+	arg[k] = botrack_dz2 * ( mult_res * mult_res );
+      }
+      local_exp_list(arg, eik, n);
+
       double ZTemp = Z_init;
-      for (unsigned int ivertex = 0; ivertex < nv; ++ivertex) {	
-	ZTemp += vertices._pk[ivertex] * vertices._ei[ivertex];
+      for (unsigned int k = 0; k < n; ++k) {
+	ZTemp += vpk[k] * eik[k];
+      }
+      if (edm::isNotFinite(ZTemp)) ZTemp = 0.0;
+      gtracks._Z_sum[itrack] = ZTemp;
+
+      if (ZTemp > 1.e-100) {
+	auto tmp_trk_pi = gtracks._pi[itrack];
+	auto o_trk_Z_sum = 1./ZTemp;
+	auto o_trk_dz2 = gtracks._dz2[itrack];
+	auto obeta = -1./beta;
+	double * __restrict__ se = slice.se.data() + (kmin - slice.kmin);
+	double * __restrict__ sw = slice.sw.data() + (kmin - slice.kmin);
+	double * __restrict__ swz = slice.swz.data() + (kmin - slice.kmin);
+	double * __restrict__ swE = slice.swE.data() + (kmin - slice.kmin);
+
+	// auto-vectorized
+	for (unsigned int k = 0; k < n; ++k) {
+	  se[k] += eik[k] * (tmp_trk_pi* o_trk_Z_sum);
+	  auto w = vpk[k] * eik[k] * (tmp_trk_pi*o_trk_Z_sum *o_trk_dz2);
+	  sw[k]  += w;
+	  swz[k] += w * track_z;
+	  swE[k] += w * arg[k]*obeta;
+	}
       }
-      return ZTemp;
-    };
-
-  auto kernel_calc_normalization = [ beta, nv ] (const unsigned int track_num,
-						  track_t & tks_vec,
-						  vertex_t & y_vec ) {
-    auto tmp_trk_pi = tks_vec._pi[track_num];
-    auto o_trk_Z_sum = 1./tks_vec._Z_sum[track_num];
-    auto o_trk_dz2 = tks_vec._dz2[track_num];
-    auto tmp_trk_z = tks_vec._z[track_num];
-    auto obeta =  -1./beta;
-    
-    // auto-vectorized
-    for (unsigned int k = 0; k < nv; ++k) {
-      y_vec._se[k] +=  y_vec._ei[k] * (tmp_trk_pi* o_trk_Z_sum);
-      auto w = y_vec._pk[k] * y_vec._ei[k] * (tmp_trk_pi*o_trk_Z_sum *o_trk_dz2);
-      y_vec._sw[k]  += w;
-      y_vec._swz[k] += w * tmp_trk_z;
-      y_vec._swE[k] += w * y_vec._ei_cache[k]*obeta;
     }
   };
-  
-  
+
+  if (nslices > 1) {
+    tbb::parallel_for(0U, nslices, kernel_slice);
+  } else {
+    for (auto islice = 0U; islice < nslices; ++islice) kernel_slice(islice);
+  }
+
   for (auto ivertex = 0U; ivertex < nv; ++ivertex) {
     gvertices._se[ivertex] = 0.0;
     gvertices._sw[ivertex] = 0.0;
     gvertices._swz[ivertex] = 0.0;
     gvertices._swE[ivertex] = 0.0;
   }
-  
-  
-  
-  // loop over tracks
+
+  for (auto const & slice : slices) {
+    for (auto k = slice.kmin; k < slice.kmax; ++k) {
+      gvertices._se[k] += slice.se[k - slice.kmin];
+      gvertices._sw[k] += slice.sw[k - slice.kmin];
+      gvertices._swz[k] += slice.swz[k - slice.kmin];
+      gvertices._swE[k] += slice.swE[k - slice.kmin];
+    }
+  }
+
+  // used in the next major loop to follow
   for (auto itrack = 0U; itrack < nt; ++itrack) {
-    kernel_calc_exp_arg(itrack, gtracks, gvertices);
-    local_exp_list(gvertices._ei_cache, gvertices._ei, nv);
-    
-    gtracks._Z_sum[itrack] = kernel_add_Z(gvertices);
-    if (edm::isNotFinite(gtracks._Z_sum[itrack])) gtracks._Z_sum[itrack] = 0.0;
-    // used in the next major loop to follow
     sumpi += gtracks._pi[itrack];
-    
-    if (gtracks._Z_sum[itrack] > 1.e-100){
-      kernel_calc_normalization(itrack, gtracks, gvertices);
-    }
   }
   
   // now update z and pk
@@ -336,6 +428,8 @@ DAClusterizerInZ_vect::purge(vertex_t & y, track_t & tks, double & rho0, const d
 
     double pmax = y._pk[k] / (y._pk[k] + rho0 * local_exp(-beta * dzCutOff_* dzCutOff_));
     for (unsigned int i = 0; i < nt; i++) {
+      // the ranges are up-to-date after the last update, outside of them p is negligible
+      if ((k < tks.kmin[i]) || (k >= tks.kmax[i])) continue;
       if (tks._Z_sum[i] > 1.e-100) {
 	double p = y._pk[k] * local_exp(-beta * Eik(tks._z[i], y._z[k], tks._dz2[i])) / tks._Z_sum[i];
 	sump += p;
@@ -710,12 +804,11 @@ DAClusterizerInZ_vect::vertices(const vector<reco::TransientTrack> & tracks, con
   for (unsigned int k = 0; k < nv; k++)
      if ( edm::isNotFinite(y._pk[k]) || edm::isNotFinite(y._z[k]) ) { y._pk[k]=0; y._z[k]=0;}
 
-  for (unsigned int i = 0; i < nt; i++) // initialize
-    tks._Z_sum[i] = rho0 * local_exp(-beta * dzCutOff_ * dzCutOff_);
+  set_vtx_range(beta, tks, y);
 
-  // improve vectorization (does not require reduction ....)
-  for (unsigned int k = 0; k < nv; k++) {
-     for (unsigned int i = 0; i < nt; i++)  
+  for (unsigned int i = 0; i < nt; i++) {
+    tks._Z_sum[i] = rho0 * local_exp(-beta * dzCutOff_ * dzCutOff_);
+    for (unsigned int k = tks.kmin[i]; k < tks.kmax[i]; k++)
       tks._Z_sum[i] += y._pk[k] * local_exp(-beta * Eik(tks._z[i], y._z[k],tks._dz2[i]));
   }
 
@@ -725,6 +818,7 @@ DAClusterizerInZ_vect::vertices(const vector<reco::TransientTrack> & tracks, con
     
     vector<reco::TransientTrack> vertexTracks;
     for (unsigned int i = 0; i < nt; i++) {
+      if ((k < tks.kmin[i]) || (k >= tks.kmax[i])) continue;
       if (tks._Z_sum[i] > 1e-100) {
 	
 	double p = y._pk[k] * local_exp(-beta * Eik(tks._z[i], y._z[k],
@@ -16,6 +16,9 @@
 #include "TrackingTools/Records/interface/TransientTrackRecord.h"
 #include "DataFormats/BeamSpot/interface/BeamSpot.h"
 
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_for.h"
+
 
 PrimaryVertexProducerAlgorithm::PrimaryVertexProducerAlgorithm(const edm::ParameterSet& conf)
   :theConfig(conf)
@@ -174,23 +177,31 @@ PrimaryVertexProducerAlgorithm::vertices(const std::vector<reco::TransientTrack>
   // reco::VertexCollection vColl;
   
 
-    std::vector<TransientVertex> pvs;
-    for (std::vector< std::vector<reco::TransientTrack> >::const_iterator iclus
-	   = clusters.begin(); iclus != clusters.end(); iclus++) {
-
+    // fit the vertex candidates in parallel; the fitters keep state during a fit,
+    // so every thread uses its own copy, reused for all the candidates it fits
+    std::vector<TransientVertex> fitted(clusters.size());
+    tbb::enumerable_thread_specific<std::unique_ptr<VertexFitter<5> > > fitters;
+    tbb::parallel_for(size_t(0), clusters.size(), [&](size_t i) {
+      auto const & clus = clusters[i];
+      auto & fitter = fitters.local();
+      if (!fitter) fitter.reset(algorithm->fitter->clone());
 
-      TransientVertex v; 
-      if( algorithm->useBeamConstraint && validBS &&((*iclus).size()>1) ){
+      if( algorithm->useBeamConstraint && validBS &&(clus.size()>1) ){
 	
-	v = algorithm->fitter->vertex(*iclus, beamSpot);
+	fitted[i] = fitter->vertex(clus, beamSpot);
 	
-      }else if( !(algorithm->useBeamConstraint) && ((*iclus).size()>1) ) {
+      }else if( !(algorithm->useBeamConstraint) && (clus.size()>1) ) {
       
-	v = algorithm->fitter->vertex(*iclus); 
+	fitted[i] = fitter->vertex(clus); 
 	
       }// else: no fit ==> v.isValid()=False
+    });
 
 
+    // select in the order of the candidates, the result is the same as with sequential fits
+    std::vector<TransientVertex> pvs;
+    for (auto const & v : fitted) {
+
       if (fVerbose){
 	if (v.isValid()) std::cout << "x,y,z=" << v.position().x() <<" " << v.position().y() << " " <<  v.position().z() << std::endl;
 	else std::cout <<"Invalid fitted vertex\n";
@@ -19,6 +19,9 @@ GeometricSearchDet::compatibleDetsV( const TrajectoryStateOnSurface& startingSta
 
   std::vector<DetGroup> vectorGroups;
   groupedCompatibleDetsV(startingState,prop,est,vectorGroups);
+  auto nDets = result.size();
+  for (auto const & group : vectorGroups) nDets += group.size();
+  result.reserve(nDets);
   for(auto itDG=vectorGroups.begin(); itDG!=vectorGroups.end();itDG++){
     for(auto itDGE=itDG->begin(); itDGE!=itDG->end();itDGE++){
       result.emplace_back(itDGE->det(),itDGE->trajectoryState());
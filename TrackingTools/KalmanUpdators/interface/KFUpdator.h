@@ -40,6 +40,14 @@ public:
   TrajectoryStateOnSurface update(const TrajectoryStateOnSurface&,
                                   const TrackingRecHit&) const override;
 
+  /// Update n states at once: out[i] = update(tsos[i], *hits[i]).
+  /// Measurements of the local position (1D and 2D tracker hits) are
+  /// combined in structure-of-arrays batches, all others one by one.
+  void update(const TrajectoryStateOnSurface* tsos,
+              const TrackingRecHit* const* hits,
+              unsigned int n,
+              TrajectoryStateOnSurface* out) const;
+
 
   KFUpdator * clone() const override {
     return new KFUpdator(*this);
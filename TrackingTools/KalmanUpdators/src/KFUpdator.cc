@@ -6,6 +6,7 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "DataFormats/Math/interface/invertPosDefMatrix.h"
 #include "DataFormats/Math/interface/ProjectMatrix.h"
+#include "DataFormats/Math/interface/Matriplex.h"
 
 
 // test of joseph form
@@ -56,34 +57,22 @@ namespace {
 
 namespace {
 
+// filtered state from the Kalman components of the hit (r is the residual)
 template <unsigned int D>
-TrajectoryStateOnSurface lupdate(const TrajectoryStateOnSurface& tsos,
-				           const TrackingRecHit& aRecHit) {
+TrajectoryStateOnSurface lfilter(const TrajectoryStateOnSurface& tsos,
+				 const ProjectMatrix<double,5,D>& pf,
+				 const typename AlgebraicROOTObject<D>::Vector& r,
+				 const typename AlgebraicROOTObject<D,D>::SymMatrix& V,
+				 const typename AlgebraicROOTObject<D,D>::SymMatrix& VMeas) {
 
-  typedef typename AlgebraicROOTObject<D,5>::Matrix MatD5;
   typedef typename AlgebraicROOTObject<5,D>::Matrix Mat5D;
   typedef typename AlgebraicROOTObject<D,D>::SymMatrix SMatDD;
-  typedef typename AlgebraicROOTObject<D>::Vector VecD;
-  using ROOT::Math::SMatrixNoInit;
   double pzSign = tsos.localParameters().pzSign();
 
   auto && x = tsos.localParameters().vector();
   auto && C = tsos.localError().matrix();
 
-  // projection matrix (assume element of "H" to be just 0 or 1)
-  ProjectMatrix<double,5,D>  pf;
- 
-  // Measurement matrix
-  VecD r, rMeas; 
-  SMatDD V(SMatrixNoInit{}), VMeas(SMatrixNoInit{});
-
-  KfComponentsHolder holder; 
-  holder.template setup<D>(&r, &V, &pf, &rMeas, &VMeas, x, C);
-  aRecHit.getKfComponents(holder);
-  
-  r -= rMeas;
-
-  // and covariance matrix of residuals
+  // covariance matrix of residuals
   SMatDD R = V + VMeas;
   bool ok = invertPosDefMatrix(R);
 
@@ -164,6 +153,33 @@ TrajectoryStateOnSurface lupdate(const TrajectoryStateOnSurface& tsos,
   }
 
 }
+
+template <unsigned int D>
+TrajectoryStateOnSurface lupdate(const TrajectoryStateOnSurface& tsos,
+				           const TrackingRecHit& aRecHit) {
+
+  typedef typename AlgebraicROOTObject<D,D>::SymMatrix SMatDD;
+  typedef typename AlgebraicROOTObject<D>::Vector VecD;
+  using ROOT::Math::SMatrixNoInit;
+
+  auto && x = tsos.localParameters().vector();
+  auto && C = tsos.localError().matrix();
+
+  // projection matrix (assume element of "H" to be just 0 or 1)
+  ProjectMatrix<double,5,D>  pf;
+ 
+  // Measurement matrix
+  VecD r, rMeas; 
+  SMatDD V(SMatrixNoInit{}), VMeas(SMatrixNoInit{});
+
+  KfComponentsHolder holder; 
+  holder.template setup<D>(&r, &V, &pf, &rMeas, &VMeas, x, C);
+  aRecHit.getKfComponents(holder);
+  
+  r -= rMeas;
+
+  return lfilter<D>(tsos,pf,r,V,VMeas);
+}
 }
 
 TrajectoryStateOnSurface KFUpdator::update(const TrajectoryStateOnSurface& tsos,
@@ -180,3 +196,191 @@ TrajectoryStateOnSurface KFUpdator::update(const TrajectoryStateOnSurface& tsos,
         ", type is " << typeid(aRecHit).name() << "\n";
 }
 
+
+
+namespace {
+
+  // Kalman update of up to N states measured in the local position
+  // (projection onto parameters 3..3+D-1) in structure-of-arrays form.
+  // Same algebra as lupdate<D>, with the Joseph form written out as
+  //   C - KHC - (KHC)^T + K R K^T
+  template <unsigned int D>
+  struct BatchUpdate {
+    static constexpr unsigned int N = 8;
+
+    matriplex::Vector<double,5,N>    x;
+    matriplex::SymMatrix<double,5,N> C;
+    matriplex::Vector<double,D,N>    r;    // residual
+    matriplex::SymMatrix<double,D,N> R;    // covariance of the residual
+    matriplex::Vector<double,5,N>    fsv;
+    matriplex::SymMatrix<double,5,N> fse;
+    bool                             ok[N];
+    unsigned int                     index[N];  // position in the caller's arrays
+    unsigned int                     n = 0;
+
+    // queues state i, or updates it right away with the components
+    // already extracted if the hit does not measure the local position
+    void add(unsigned int i, const TrajectoryStateOnSurface& tsos, const TrackingRecHit& aRecHit,
+             TrajectoryStateOnSurface* out) {
+      typedef typename AlgebraicROOTObject<D>::Vector VecD;
+      typedef typename AlgebraicROOTObject<D,D>::SymMatrix SMatDD;
+      auto && lx = tsos.localParameters().vector();
+      auto && lC = tsos.localError().matrix();
+      ProjectMatrix<double,5,D> pf;
+      VecD lr, rMeas;
+      SMatDD V, VMeas;
+      KfComponentsHolder holder;
+      holder.template setup<D>(&lr, &V, &pf, &rMeas, &VMeas, lx, lC);
+      aRecHit.getKfComponents(holder);
+      lr -= rMeas;
+      for (unsigned int k=0; k<D; ++k)
+        if (pf.index[k]!=3+k) {
+          out[i] = lfilter<D>(tsos,pf,lr,V,VMeas);
+          return;
+        }
+      V += VMeas;
+      matriplex::loadVector(x,n,lx);
+      matriplex::load(C,n,lC);
+      matriplex::loadVector(r,n,lr);
+      matriplex::load(R,n,V);
+      index[n++] = i;
+    }
+
+    void invert(matriplex::SymMatrix<double,1,N> & Ri) {
+      for (unsigned int l=0; l<n; ++l) {
+        auto r00 = R(0,0)[l];
+        ok[l] = r00 > 0;
+        Ri(0,0)[l] = 1./r00;
+      }
+    }
+
+    void invert(matriplex::SymMatrix<double,2,N> & Ri) {
+      for (unsigned int l=0; l<n; ++l) {
+        auto r00 = R(0,0)[l], r10 = R(1,0)[l], r11 = R(1,1)[l];
+        auto det = r00*r11 - r10*r10;
+        ok[l] = r00 > 0 && det > 0;
+        auto idet = 1./det;
+        Ri(0,0)[l] =  r11*idet;
+        Ri(1,0)[l] = -r10*idet;
+        Ri(1,1)[l] =  r00*idet;
+      }
+    }
+
+    void compute() {
+      matriplex::SymMatrix<double,D,N> Ri;
+      invert(Ri);
+
+      // K = C H^T R^-1
+      matriplex::Matrix<double,5,D,N> K;
+      for (unsigned int i=0; i<5; ++i)
+        for (unsigned int k=0; k<D; ++k) {
+          double * __restrict__ kik = K(i,k);
+          for (unsigned int l=0; l<n; ++l) kik[l] = 0;
+          for (unsigned int m=0; m<D; ++m) {
+            double const * __restrict__ cim = C(i,3+m);
+            double const * __restrict__ rmk = Ri(m,k);
+            for (unsigned int l=0; l<n; ++l) kik[l] += cim[l]*rmk[l];
+          }
+        }
+
+      for (unsigned int i=0; i<5; ++i) {
+        double * __restrict__ f = fsv(i,0);
+        double const * __restrict__ xi = x(i,0);
+        for (unsigned int l=0; l<n; ++l) f[l] = xi[l];
+        for (unsigned int k=0; k<D; ++k) {
+          double const * __restrict__ kik = K(i,k);
+          double const * __restrict__ rk = r(k,0);
+          for (unsigned int l=0; l<n; ++l) f[l] += kik[l]*rk[l];
+        }
+      }
+
+      // KHC and KR
+      matriplex::Matrix<double,5,5,N> KHC;
+      matriplex::Matrix<double,5,D,N> KR;
+      for (unsigned int i=0; i<5; ++i) {
+        for (unsigned int j=0; j<5; ++j) {
+          double * __restrict__ a = KHC(i,j);
+          for (unsigned int l=0; l<n; ++l) a[l] = 0;
+          for (unsigned int k=0; k<D; ++k) {
+            double const * __restrict__ kik = K(i,k);
+            double const * __restrict__ ckj = C(3+k,j);
+            for (unsigned int l=0; l<n; ++l) a[l] += kik[l]*ckj[l];
+          }
+        }
+        for (unsigned int m=0; m<D; ++m) {
+          double * __restrict__ a = KR(i,m);
+          for (unsigned int l=0; l<n; ++l) a[l] = 0;
+          for (unsigned int k=0; k<D; ++k) {
+            double const * __restrict__ kik = K(i,k);
+            double const * __restrict__ rkm = R(k,m);
+            for (unsigned int l=0; l<n; ++l) a[l] += kik[l]*rkm[l];
+          }
+        }
+      }
+
+      for (unsigned int i=0; i<5; ++i)
+        for (unsigned int j=0; j<=i; ++j) {
+          double * __restrict__ f = fse(i,j);
+          double const * __restrict__ cij = C(i,j);
+          double const * __restrict__ aij = KHC(i,j);
+          double const * __restrict__ aji = KHC(j,i);
+          for (unsigned int l=0; l<n; ++l) f[l] = cij[l] - aij[l] - aji[l];
+          for (unsigned int m=0; m<D; ++m) {
+            double const * __restrict__ kr = KR(i,m);
+            double const * __restrict__ kjm = K(j,m);
+            for (unsigned int l=0; l<n; ++l) f[l] += kr[l]*kjm[l];
+          }
+        }
+    }
+
+    // compute and write the states back, then start a new batch
+    void flush(const TrajectoryStateOnSurface* tsos, TrajectoryStateOnSurface* out) {
+      if (n==0) return;
+      compute();
+      for (unsigned int l=0; l<n; ++l) {
+        auto const & in = tsos[index[l]];
+        if (ok[l]) {
+          AlgebraicVector5 lfsv;
+          AlgebraicSymMatrix55 lfse;
+          matriplex::storeVector(fsv,l,lfsv);
+          matriplex::store(fse,l,lfse);
+          out[index[l]] = TrajectoryStateOnSurface( LocalTrajectoryParameters(lfsv, in.localParameters().pzSign()),
+                                                    LocalTrajectoryError(lfse), in.surface(),
+                                                    &(in.globalParameters().magneticField()), in.surfaceSide() );
+        } else {
+          typename AlgebraicROOTObject<D,D>::SymMatrix lR;
+          matriplex::store(R,l,lR);
+          edm::LogError("KFUpdator")<<" could not invert martix:\n"<< lR;
+          out[index[l]] = TrajectoryStateOnSurface();
+        }
+      }
+      n = 0;
+    }
+  };
+
+}
+
+void KFUpdator::update(const TrajectoryStateOnSurface* tsos,
+                       const TrackingRecHit* const* hits,
+                       unsigned int n,
+                       TrajectoryStateOnSurface* out) const {
+  BatchUpdate<1> b1;
+  BatchUpdate<2> b2;
+  for (unsigned int i=0; i<n; ++i) {
+    auto const & hit = *hits[i];
+    switch (hit.dimension()) {
+      case 1:
+        b1.add(i,tsos[i],hit,out);
+        if (b1.n==BatchUpdate<1>::N) b1.flush(tsos,out);
+        break;
+      case 2:
+        b2.add(i,tsos[i],hit,out);
+        if (b2.n==BatchUpdate<2>::N) b2.flush(tsos,out);
+        break;
+      default:
+        out[i] = update(tsos[i],hit);
+    }
+  }
+  b1.flush(tsos,out);
+  b2.flush(tsos,out);
+}
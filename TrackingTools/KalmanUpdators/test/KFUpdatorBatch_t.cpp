@@ -0,0 +1,107 @@
+#include "TrackingTools/KalmanUpdators/interface/KFUpdator.h"
+
+#include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
+#include "DataFormats/GeometrySurface/interface/Surface.h"
+#include "DataFormats/GeometrySurface/interface/BoundPlane.h"
+#include <Geometry/CommonDetUnit/interface/GeomDet.h>
+
+#include "MagneticField/Engine/interface/MagneticField.h"
+
+#include "DataFormats/TrackerRecHit2D/interface/SiStripMatchedRecHit2D.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiStripRecHit2D.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiStripRecHit1D.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHit.h"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+class ConstMagneticField : public MagneticField {
+public:
+
+  GlobalVector inTesla ( const GlobalPoint& ) const override {
+    return GlobalVector(0,0,4);
+  }
+
+};
+
+// A fake Det class
+
+class MyDet : public GeomDet {
+ public:
+  MyDet(BoundPlane * bp, DetId id) :
+    GeomDet(bp){setDetId(id);}
+
+  /// Which subdetector
+  SubDetector subDetector() const override {return GeomDetEnumerators::DT;}
+
+};
+
+
+int main() {
+
+  MagneticField * field = new ConstMagneticField;
+  GlobalPoint gp(0,0,0);
+  BoundPlane* plane = new BoundPlane( gp, Surface::RotationType());
+  GeomDet *  det =  new MyDet(plane,41);
+
+  std::mt19937 eng;
+  std::uniform_real_distribution<double> rgen(-1.,1.);
+
+  // 1D and 2D hits measuring the local position, mixed so that the
+  // batches of both dimensions fill up and flush at different times
+  OmniClusterRef cref;
+  SiPixelRecHit::ClusterRef pref;
+  SiStripRecHit2D dummy;
+  constexpr unsigned int n = 41;
+  std::vector<TrackingRecHit*> hits;
+  std::vector<TrajectoryStateOnSurface> states;
+  for (unsigned int i=0; i<n; ++i) {
+    LocalPoint m(rgen(eng),rgen(eng),0);
+    LocalError e(0.01+0.01*std::abs(rgen(eng)),0.001*rgen(eng),0.02+0.05*std::abs(rgen(eng)));
+    switch (i%5) {
+      case 0: case 3: hits.push_back(new SiStripRecHit1D(m,e,*det,cref)); break;
+      case 1: hits.push_back(new SiStripRecHit2D(m,e,*det,cref)); break;
+      case 2: hits.push_back(new SiPixelRecHit(m,e,0,*det,pref)); break;
+      case 4: hits.push_back(new SiStripMatchedRecHit2D(m,e,*det,&dummy,&dummy)); break;
+    }
+
+    LocalPoint lp(rgen(eng),rgen(eng),0);
+    LocalVector lv(rgen(eng),rgen(eng),1.+std::abs(rgen(eng)));
+    LocalTrajectoryParameters ltp(lp,lv,i%2 ? 1 : -1);
+    AlgebraicSymMatrix55 cov;
+    for (unsigned int k=0; k<5; ++k) {
+      for (unsigned int l=0; l<k; ++l) cov(k,l) = 1.e-4*rgen(eng);
+      cov(k,k) = 0.01*(1.+std::abs(rgen(eng)));
+    }
+    states.emplace_back(ltp,LocalTrajectoryError(cov),*plane,field);
+  }
+
+  KFUpdator kfu;
+  std::vector<TrajectoryStateOnSurface> batch(n);
+  kfu.update(states.data(),hits.data(),n,batch.data());
+
+  // the batch uses the expanded Joseph form: equal to rounding
+  for (unsigned int i=0; i<n; ++i) {
+    auto ref = kfu.update(states[i],*hits[i]);
+    auto const & res = batch[i];
+    assert(res.isValid()==ref.isValid());
+    if (!ref.isValid()) continue;
+    assert(res.surfaceSide()==ref.surfaceSide());
+    assert(&res.surface()==&ref.surface());
+    auto const & v = res.localParameters().vector();
+    auto const & vref = ref.localParameters().vector();
+    auto const & e = res.localError().matrix();
+    auto const & eref = ref.localError().matrix();
+    for (unsigned int k=0; k<5; ++k) {
+      assert(std::abs(v(k)-vref(k)) <= 1.e-12*std::max(1.,std::abs(vref(k))));
+      for (unsigned int l=0; l<=k; ++l)
+	assert(std::abs(e(k,l)-eref(k,l)) <= 1.e-10*std::sqrt(eref(k,k)*eref(l,l)));
+    }
+  }
+
+  std::cout << "batched KFUpdator OK" << std::endl;
+  return 0;
+}